@@ -0,0 +1,114 @@
+// Copyright 2024 Jason Han
+#include "Arena.h"
+#include "CompactSnapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+// Compares heap and arena allocation for a compact snapshot load: heap allocations made by the
+// load, decode time, the time of a scan over every course of the loaded catalog, and the time to
+// free the catalog.
+//
+// Usage: arena_benchmark [departments] [coursesPerDepartment] [repetitions]
+
+namespace {
+
+std::atomic<size_t> heapAllocations{0};
+
+std::map<std::string, Department> buildCatalog(size_t departments, size_t coursesPerDepartment) {
+    std::string times[] = {"11:40-12:55", "4:10-5:25", "10:10-11:25", "2:40-3:55", "6:10-7:25"};
+    std::map<std::string, Department> mapping;
+    for (size_t d = 0; d < departments; ++d) {
+        std::string deptCode = "D" + std::to_string(100000 + d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (size_t c = 0; c < coursesPerDepartment; ++c) {
+            auto course = std::make_shared<Course>(
+                static_cast<int>(100 + c % 300),
+                "Professor Instructor " + std::to_string((d * 7 + c) % 4000),
+                std::to_string((d + c) % 600) + " Havemeyer Hall",
+                times[c % 5]);
+            course->setEnrolledStudentCount(static_cast<int>(c * 37 % 400));
+            courses[std::to_string(1000 + c)] = course;
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair " + deptCode, 1000);
+    }
+    return mapping;
+}
+
+// Counts full courses the way a catalog-wide report would.
+size_t countFullCourses(const std::map<std::string, Department>& mapping) {
+    size_t full = 0;
+    for (const auto& dept : mapping) {
+        for (const auto& course : dept.second.getCourseSelection()) {
+            full += course.second->isCourseFull();
+        }
+    }
+    return full;
+}
+
+template <typename F> double elapsedMillis(F&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+}  // namespace
+
+void* operator new(size_t bytes) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(bytes ? bytes : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+int main(int argc, char* argv[]) {
+    size_t departments = argc > 1 ? std::stoul(argv[1]) : 1000;
+    size_t coursesPerDepartment = argc > 2 ? std::stoul(argv[2]) : 200;
+    size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 5;
+
+    std::string bytes = CompactSnapshot::encode(buildCatalog(departments, coursesPerDepartment),
+                                                CompactCompression::None);
+    std::cout << departments << " departments, " << departments * coursesPerDepartment
+              << " courses; best of " << repetitions << " runs\n";
+    std::cout << std::setw(8) << "mode" << std::setw(14) << "allocations" << std::setw(12)
+              << "load ms" << std::setw(12) << "scan ms" << std::setw(12) << "free ms" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    size_t fullCourses = 0;
+    for (AllocationMode mode : {AllocationMode::Heap, AllocationMode::Arena}) {
+        size_t allocations = 0;
+        double loadMillis = 0;
+        double scanMillis = 0;
+        double freeMillis = 0;
+        for (size_t i = 0; i < repetitions; ++i) {
+            std::map<std::string, Department> mapping;
+            size_t before = heapAllocations.load();
+            double load = elapsedMillis([&]() { mapping = CompactSnapshot::decode(bytes, mode); });
+            allocations = heapAllocations.load() - before;
+            double scan = elapsedMillis([&]() { fullCourses = countFullCourses(mapping); });
+            double free = elapsedMillis([&]() { mapping.clear(); });
+            loadMillis = i == 0 ? load : std::min(loadMillis, load);
+            scanMillis = i == 0 ? scan : std::min(scanMillis, scan);
+            freeMillis = i == 0 ? free : std::min(freeMillis, free);
+        }
+        std::cout << std::setw(8) << (mode == AllocationMode::Heap ? "heap" : "arena")
+                  << std::setw(14) << allocations << std::setw(12) << loadMillis << std::setw(12)
+                  << scanMillis << std::setw(12) << freeMillis << "\n";
+    }
+    std::cout << fullCourses << " full courses\n";
+    return 0;
+}
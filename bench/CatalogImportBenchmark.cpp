@@ -0,0 +1,102 @@
+// Copyright 2024 Jason Han
+#include "CatalogImporter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Measures how long a bulk import of a synthetic registrar export takes, in CSV and JSON Lines,
+// parsed on 1, 2, 4, ... threads. Parsing is timed from the file on disk; writing the snapshot is
+// timed once per format.
+//
+// Usage: catalog_import_benchmark [sections] [repetitions] [maxThreads]
+
+namespace {
+
+void writeExport(const std::string& path, ImportFormat format, size_t sections) {
+    std::string times[] = {"11:40-12:55", "4:10-5:25", "10:10-11:25", "2:40-3:55"};
+    std::ofstream out(path, std::ios::binary);
+    if (format == ImportFormat::Csv) {
+        out << "department,chair,majors,course,instructor,location,time,capacity,enrolled\n";
+    }
+    for (size_t i = 0; i < sections; ++i) {
+        std::string dept = "D" + std::to_string(100 + i % 300);
+        std::string course = std::to_string(1000 + i / 300);
+        std::string instructor = "Instructor " + std::to_string(i % 997);
+        std::string location = std::to_string(i % 800) + " Building";
+        int capacity = static_cast<int>(100 + i % 300);
+        int enrolled = static_cast<int>(i % 100);
+        if (format == ImportFormat::Csv) {
+            out << dept << ",\"Chair, " << dept << "\",1000," << course << "," << instructor
+                << "," << location << "," << times[i % 4] << "," << capacity << "," << enrolled
+                << "\n";
+        } else {
+            out << "{\"department\": \"" << dept << "\", \"chair\": \"Chair, " << dept
+                << "\", \"majors\": 1000, \"course\": \"" << course << "\", \"instructor\": \""
+                << instructor << "\", \"location\": \"" << location << "\", \"time\": \""
+                << times[i % 4] << "\", \"capacity\": " << capacity
+                << ", \"enrolled\": " << enrolled << "}\n";
+        }
+    }
+}
+
+template <typename F> double bestMillis(size_t repetitions, F&& fn) {
+    double best = 0;
+    for (size_t i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t sections = argc > 1 ? std::stoul(argv[1]) : 100000;
+    size_t repetitions = argc > 2 ? std::stoul(argv[2]) : 3;
+    size_t maxThreads = argc > 3 ? std::stoul(argv[3])
+                                 : std::max(1u, std::thread::hardware_concurrency());
+    const std::string databasePath = "bench_import.bin";
+
+    std::cout << sections << " sections, best of " << repetitions << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (ImportFormat format : {ImportFormat::Csv, ImportFormat::JsonLines}) {
+        std::string name = format == ImportFormat::Csv ? "csv" : "jsonl";
+        std::string path = "bench_import." + name;
+        writeExport(path, format, sections);
+
+        double singleMillis = 0;
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            CatalogImporter importer(format);
+            importer.setThreadCount(threads);
+            double millis = bestMillis(repetitions, [&]() {
+                std::ifstream in(path, std::ios::binary);
+                importer.parse(in, path);
+            });
+            if (threads == 1) {
+                singleMillis = millis;
+            }
+            std::cout << name << " parse, " << threads << " thread(s): " << millis << " ms ("
+                      << singleMillis / millis << "x, "
+                      << importer.getStats().bytes / (millis * 1000) << " MB/s)\n";
+        }
+
+        MyFileDatabase database{1, databasePath};
+        CatalogImporter importer(format);
+        ImportStats stats = importer.importFile(path, database);
+        std::cout << name << " import + snapshot: " << stats.parseMicros / 1000.0 << " + "
+                  << stats.snapshotMicros / 1000.0 << " ms\n";
+        std::remove(path.c_str());
+    }
+
+    std::remove(databasePath.c_str());
+    std::remove((databasePath + ".wal").c_str());
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Copyright 2024 Jason Han
+#include "CourseColumns.h"
+#include "EpochReclaimer.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Compares catalog-wide scans over the department map, which chase map nodes and course
+// pointers, with the course columns: finding every full course, which scans the columns, and
+// every course in one room, which the columns answer from their location index. Both collect
+// matches without resolving their keys. Column throughput counts the bytes of the columns a scan
+// reads, and isn't reported for index lookups.
+//
+// Usage: column_scan_benchmark [repetitions]
+
+namespace {
+
+std::map<std::string, Department> buildCatalog(size_t departments, size_t coursesPerDepartment) {
+    std::string times[] = {"11:40-12:55", "4:10-5:25", "10:10-11:25", "2:40-3:55", "6:10-7:25"};
+    std::map<std::string, Department> mapping;
+    for (size_t d = 0; d < departments; ++d) {
+        std::string deptCode = "D" + std::to_string(100000 + d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (size_t c = 0; c < coursesPerDepartment; ++c) {
+            auto course =
+                std::make_shared<Course>(static_cast<int>(100 + c % 300),
+                                         "Instructor " + std::to_string((d * 7 + c) % 4000),
+                                         std::to_string((d + c) % 600) + " HAV",
+                                         times[c % 5]);
+            course->setEnrolledStudentCount(static_cast<int>(c * 37 % 400));
+            courses[std::to_string(1000 + c)] = course;
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair " + deptCode, 1000);
+    }
+    return mapping;
+}
+
+template <typename F> double bestMillis(size_t repetitions, F&& fn) {
+    double best = 0;
+    for (size_t i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void report(const std::string& name, double mapMillis, double columnMillis, size_t columnBytes) {
+    std::cout << std::setw(10) << name << std::setw(12) << mapMillis << std::setw(12)
+              << columnMillis << std::setw(10) << mapMillis / columnMillis << std::setw(12);
+    if (columnBytes > 0) {
+        std::cout << columnBytes / columnMillis / 1e6 << "\n";
+    } else {
+        std::cout << "-" << "\n";
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t repetitions = argc > 1 ? std::stoul(argv[1]) : 10;
+
+    std::cout << "best of " << repetitions << " runs\n";
+    std::cout << std::fixed << std::setprecision(4);
+    for (size_t departments : {500, 5000}) {
+        std::map<std::string, Department> mapping = buildCatalog(departments, 200);
+        std::vector<std::pair<std::string_view, const Department*>> versions;
+        for (const auto& [deptCode, dept] : mapping) {
+            versions.emplace_back(deptCode, &dept);
+        }
+        CourseColumns columns{versions};
+        InternedString room = InternedString::intern("17 HAV");
+
+        std::cout << columns.size() << " courses\n";
+        std::cout << std::setw(10) << "scan" << std::setw(12) << "map ms" << std::setw(12)
+                  << "columns ms" << std::setw(10) << "speedup" << std::setw(12) << "column GB/s"
+                  << "\n";
+        size_t matches = 0;
+        double mapFull = bestMillis(repetitions, [&]() {
+            std::vector<const Course*> full;
+            for (const auto& [deptCode, dept] : mapping) {
+                for (const auto& [courseCode, course] : dept.getCourseSelection()) {
+                    if (course->isCourseFull()) {
+                        full.push_back(course.get());
+                    }
+                }
+            }
+            matches += full.size();
+        });
+        double columnFull =
+            bestMillis(repetitions, [&]() { matches += columns.findFull().size(); });
+        report("full", mapFull, columnFull, columns.size() * sizeof(uint8_t));
+
+        double mapRoom = bestMillis(repetitions, [&]() {
+            std::vector<const Course*> inRoom;
+            for (const auto& [deptCode, dept] : mapping) {
+                for (const auto& [courseCode, course] : dept.getCourseSelection()) {
+                    if (course->getInternedLocation() == room) {
+                        inRoom.push_back(course.get());
+                    }
+                }
+            }
+            matches += inRoom.size();
+        });
+        double columnRoom = bestMillis(repetitions, [&]() {
+            EpochGuard guard;
+            matches += columns.findByLocation(room).size();
+        });
+        report("room", mapRoom, columnRoom, 0);
+        std::cout << matches << " matches\n";
+    }
+    return 0;
+}
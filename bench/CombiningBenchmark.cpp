@@ -0,0 +1,88 @@
+// Copyright 2024 Jason Han
+#include "SeatCombiner.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures enroll and drop throughput on one hot course with 1, 8 and 64 clients, for three ways
+// of changing the seat count: a mutex around a plain count, a compare-and-swap retried until it
+// wins, and flat combining (SeatCombiner). Each client alternates enrolling and dropping, so the
+// course never fills up, and the final count is checked against zero.
+//
+// Usage: combining_benchmark [millis]
+
+namespace {
+
+// The seat count as it was kept before it became atomic: check and update under one lock.
+struct LockedSeats {
+    std::mutex mutex;
+    int count = 0;
+    int capacity = 1 << 20;
+
+    SeatChange change(int delta) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (count + delta > capacity || count + delta < 0) {
+            return SeatChange::Rejected;
+        }
+        count += delta;
+        return SeatChange::Applied;
+    }
+};
+
+template <typename Change>
+double run(size_t clients, std::chrono::milliseconds duration, Change change) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> changes{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < clients; ++t) {
+        threads.emplace_back([&]() {
+            uint64_t done = 0;
+            while (!stop) {
+                done += change(1) == SeatChange::Applied;
+                done += change(-1) == SeatChange::Applied;
+            }
+            changes += done;
+        });
+    }
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return changes / std::chrono::duration<double>(duration).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    auto duration = std::chrono::milliseconds(argc > 1 ? std::stoul(argv[1]) : 500);
+
+    std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::setw(8) << "clients" << std::setw(16) << "mutex/s" << std::setw(16)
+              << "cas/s" << std::setw(16) << "combining/s" << "\n";
+    std::cout << std::fixed << std::setprecision(0);
+    LockedSeats locked;
+    Course casCourse{1 << 20, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    Course combinedCourse{1 << 20, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    SeatCombiner combiner;
+    for (size_t clients : {1, 8, 64}) {
+        double mutex = run(clients, duration, [&](int delta) { return locked.change(delta); });
+        double cas =
+            run(clients, duration, [&](int delta) { return casCourse.changeSeats(delta); });
+        double combining = run(clients, duration, [&](int delta) {
+            return combiner.apply(combinedCourse, delta);
+        });
+        std::cout << std::setw(8) << clients << std::setw(16) << mutex << std::setw(16) << cas
+                  << std::setw(16) << combining << "\n";
+    }
+
+    bool empty = locked.count == 0 && casCourse.getEnrolledStudentCount() == 0 &&
+                 combinedCourse.getEnrolledStudentCount() == 0;
+    std::cout << (empty ? "all courses empty\n" : "LOST UPDATES\n");
+    return 0;
+}
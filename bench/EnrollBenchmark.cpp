@@ -0,0 +1,88 @@
+// Copyright 2024 Jason Han
+#include "MyFileDatabase.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures enroll and drop throughput across 1, 2, 4, ... threads, first with every thread on
+// one hot course, then with each thread on a course of its own in the same department, whose
+// courses neighbour each other in memory. Each thread alternates enrolling and dropping, so the
+// course never fills up. Changes aren't logged, so the numbers measure the in-memory path, and
+// the final count is checked against the number of successful changes.
+//
+// Usage: enroll_benchmark [maxThreads] [millis]
+
+namespace {
+
+double run(MyFileDatabase& db, size_t threads, bool shared, std::chrono::milliseconds duration) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> changes{0};
+    std::vector<std::thread> students;
+    for (size_t t = 0; t < threads; ++t) {
+        students.emplace_back([&, t]() {
+            std::string courseCode = std::to_string(1000 + (shared ? 0 : t));
+            uint64_t done = 0;
+            while (!stop) {
+                done += db.enrollStudentInCourse("COMS", courseCode, Durability::None) ==
+                        MutationStatus::Applied;
+                done += db.dropStudentFromCourse("COMS", courseCode, Durability::None) ==
+                        MutationStatus::Applied;
+            }
+            changes += done;
+        });
+    }
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (std::thread& student : students) {
+        student.join();
+    }
+    return changes / std::chrono::duration<double>(duration).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t maxThreads = argc > 1 ? std::stoul(argv[1]) : 32;
+    auto duration = std::chrono::milliseconds(argc > 2 ? std::stoul(argv[2]) : 500);
+    const std::string databasePath = "bench_enroll.bin";
+
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    for (size_t c = 0; c < std::max<size_t>(maxThreads, 1); ++c) {
+        courses[std::to_string(1000 + c)] =
+            std::make_shared<Course>(1 << 20, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    }
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    MyFileDatabase db{1, databasePath};
+    db.setMapping(mapping);
+    // Build the course columns, so the cost of keeping them current is included.
+    db.findFullCourses();
+
+    std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::setw(8) << "threads" << std::setw(18) << "hot course/s" << std::setw(18)
+              << "own course/s" << "\n";
+    std::cout << std::fixed << std::setprecision(0);
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        double hot = run(db, threads, true, duration);
+        double own = run(db, threads, false, duration);
+        std::cout << std::setw(8) << threads << std::setw(18) << hot << std::setw(18) << own
+                  << "\n";
+    }
+
+    // Each thread dropped one student for every one it enrolled, so every course must be empty.
+    int enrolled = 0;
+    for (const auto& [courseCode, course] : db.viewDepartment("COMS")->getCourseSelection()) {
+        enrolled += course->getEnrolledStudentCount();
+    }
+    std::cout << (enrolled == 0 ? "all courses empty\n" : "LOST UPDATES\n");
+
+    std::remove(databasePath.c_str());
+    std::remove((databasePath + ".wal").c_str());
+    return 0;
+}
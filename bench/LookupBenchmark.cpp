@@ -0,0 +1,99 @@
+// Copyright 2024 Jason Han
+#include "HashIndex.h"
+#include "PackedIndex.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Measures the latency of one key lookup at 10, 1k and 100k keys, starting from a NUL-terminated
+// key as request handlers get it from the query string: the ordered map the catalog used to
+// search, which needs a temporary std::string per lookup, the same map with a transparent
+// comparator, an unordered map, the hash index, and the code index, which packs each key into an
+// integer.
+//
+// Usage: lookup_benchmark [lookups]
+
+namespace {
+
+template <typename F> double nanosPerLookup(const std::vector<const char*>& queries, F&& find) {
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const char* query : queries) {
+        found += find(query);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if (found != queries.size()) {
+        std::cerr << "Lookup missed " << queries.size() - found << " keys\n";
+    }
+    return elapsed.count() / queries.size();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t lookups = argc > 1 ? std::stoul(argv[1]) : 2000000;
+
+    std::cout << lookups << " lookups per structure, ns per lookup\n";
+    std::cout << std::setw(8) << "keys" << std::setw(12) << "map" << std::setw(12) << "map<less<>>"
+              << std::setw(16) << "unordered_map" << std::setw(12) << "HashIndex" << std::setw(12)
+              << "CodeIndex" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t keyCount : {10, 1000, 100000}) {
+        // Codes like the catalog's: short, sharing a prefix.
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < keyCount; ++i) {
+            keys.push_back("COMS" + std::to_string(1000 + i * 7));
+        }
+        std::map<std::string, size_t> ordered;
+        std::map<std::string, size_t, std::less<>> transparent;
+        std::unordered_map<std::string, size_t> unordered;
+        HashIndex<size_t> index;
+        index.reserve(keyCount);
+        CodeIndex<size_t> codeIndex;
+        codeIndex.reserve(keyCount);
+        for (size_t i = 0; i < keyCount; ++i) {
+            ordered.emplace(keys[i], i);
+            transparent.emplace(keys[i], i);
+            unordered.emplace(keys[i], i);
+            index.insert(keys[i], i);
+            codeIndex.insert(keys[i], i);
+        }
+
+        // Query copies live apart from the indexed keys, like request parameters do.
+        std::vector<std::string> queryKeys;
+        for (size_t i = 0; i < 4096; ++i) {
+            queryKeys.push_back(keys[(i * 2654435761u) % keyCount]);
+        }
+        std::vector<const char*> queries;
+        for (size_t i = 0; i < lookups; ++i) {
+            queries.push_back(queryKeys[i % queryKeys.size()].c_str());
+        }
+
+        double orderedNanos = nanosPerLookup(queries, [&](const char* query) {
+            return ordered.find(query) != ordered.end();
+        });
+        double transparentNanos = nanosPerLookup(queries, [&](const char* query) {
+            return transparent.find(std::string_view(query)) != transparent.end();
+        });
+        double unorderedNanos = nanosPerLookup(queries, [&](const char* query) {
+            return unordered.find(query) != unordered.end();
+        });
+        double indexNanos = nanosPerLookup(queries, [&](const char* query) {
+            return index.find(query) != nullptr;
+        });
+        double codeIndexNanos = nanosPerLookup(queries, [&](const char* query) {
+            return codeIndex.find(query) != nullptr;
+        });
+        std::cout << std::setw(8) << keyCount << std::setw(12) << orderedNanos << std::setw(12)
+                  << transparentNanos << std::setw(16) << unorderedNanos << std::setw(12)
+                  << indexNanos << std::setw(12) << codeIndexNanos << "\n";
+    }
+    return 0;
+}
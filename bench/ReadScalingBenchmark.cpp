@@ -0,0 +1,97 @@
+// Copyright 2024 Jason Han
+#include "MyFileDatabase.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures course lookup throughput across 1, 2, 4, ... reader threads, while one writer thread
+// keeps updating enrollment counts. Readers take no lock, so throughput should grow with the
+// number of cores until it runs out of them.
+//
+// Usage: read_scaling_benchmark [departments] [maxThreads] [millis]
+
+namespace {
+
+std::map<std::string, Department> buildCatalog(size_t departments) {
+    std::map<std::string, Department> mapping;
+    for (size_t d = 0; d < departments; ++d) {
+        std::string deptCode = "D" + std::to_string(100000 + d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (size_t c = 0; c < 20; ++c) {
+            courses[std::to_string(1000 + c)] = std::make_shared<Course>(
+                100, "Instructor " + std::to_string(c), "417 IAB", "11:40-12:55");
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair " + deptCode, 1000);
+    }
+    return mapping;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t departments = argc > 1 ? std::stoul(argv[1]) : 1000;
+    size_t maxThreads =
+        argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    auto duration = std::chrono::milliseconds(argc > 3 ? std::stoul(argv[3]) : 500);
+    const std::string databasePath = "bench_read_scaling.bin";
+
+    MyFileDatabase db{1, databasePath};
+    db.setMapping(buildCatalog(departments));
+    std::vector<std::string> deptCodes;
+    for (size_t d = 0; d < departments; ++d) {
+        deptCodes.push_back("D" + std::to_string(100000 + d));
+    }
+
+    std::cout << departments << " departments, one writer\n";
+    std::cout << std::setw(8) << "readers" << std::setw(16) << "lookups/s" << std::setw(12)
+              << "speedup" << std::setw(14) << "writes/s" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    double baseline = 0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> lookups{0};
+        uint64_t writes = 0;
+        std::thread writer([&]() {
+            for (int count = 0; !stop; ++count) {
+                const std::string& deptCode = deptCodes[count % deptCodes.size()];
+                db.setEnrollmentCount(deptCode, "1004", count % 100, Durability::None);
+                writes++;
+            }
+        });
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < threads; ++t) {
+            readers.emplace_back([&, t]() {
+                uint64_t done = 0;
+                for (size_t i = t; !stop; ++i) {
+                    CourseView course = db.viewCourse(deptCodes[i * 7919 % deptCodes.size()],
+                                                      std::to_string(1000 + i % 20));
+                    done += course ? 1 : 0;
+                }
+                lookups += done;
+            });
+        }
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        writer.join();
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+
+        double seconds = std::chrono::duration<double>(duration).count();
+        double perSecond = lookups / seconds;
+        baseline = baseline > 0 ? baseline : perSecond;
+        std::cout << std::setw(8) << threads << std::setw(16) << std::setprecision(0)
+                  << perSecond << std::setw(12) << std::setprecision(2) << perSecond / baseline
+                  << std::setw(14) << std::setprecision(0) << writes / seconds << "\n";
+    }
+
+    std::remove(databasePath.c_str());
+    std::remove((databasePath + ".wal").c_str());
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Copyright 2024 Jason Han
+#include "MyFileDatabase.h"
+#include "RouteController.h"
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Measures the cost of one /isCourseFull request as the catalog grows, served through the
+// read-only view API, next to the old approach of copying the department mapping and the course
+// map on every request.
+//
+// Usage: request_cost_benchmark [coursesPerDepartment] [requests]
+
+namespace {
+
+std::map<std::string, Department> buildCatalog(size_t departments, size_t coursesPerDepartment) {
+    std::map<std::string, Department> mapping;
+    for (size_t d = 0; d < departments; ++d) {
+        std::string deptCode = "D" + std::to_string(100000 + d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (size_t c = 0; c < coursesPerDepartment; ++c) {
+            courses[std::to_string(1000 + c)] = std::make_shared<Course>(
+                100, "Instructor " + std::to_string(c), "417 IAB", "11:40-12:55");
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair " + deptCode, 1000);
+    }
+    return mapping;
+}
+
+template <typename F> double nanosPerCall(size_t calls, F&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; ++i) {
+        fn(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / calls;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t coursesPerDepartment = argc > 1 ? std::stoul(argv[1]) : 20;
+    size_t requests = argc > 2 ? std::stoul(argv[2]) : 100000;
+    const std::string databasePath = "bench_request.bin";
+
+    std::cout << coursesPerDepartment << " courses per department, " << requests
+              << " requests per size\n";
+    std::cout << std::setw(12) << "departments" << std::setw(12) << "courses" << std::setw(14)
+              << "view ns/req" << std::setw(14) << "copy ns/req" << "\n";
+    std::cout << std::fixed << std::setprecision(0);
+    for (size_t departments : {10, 100, 1000, 10000}) {
+        MyFileDatabase db{1, databasePath};
+        db.setMapping(buildCatalog(departments, coursesPerDepartment));
+        RouteController routeController;
+        routeController.setDatabase(&db);
+
+        std::vector<crow::request> reqs(64);
+        for (size_t i = 0; i < reqs.size(); ++i) {
+            std::string query = "?deptCode=D" + std::to_string(100000 + i * 7919 % departments) +
+                                "&courseCode=" + std::to_string(1000 + i % coursesPerDepartment);
+            reqs[i].url_params = crow::query_string{query};
+        }
+        double viewNanos = nanosPerCall(requests, [&](size_t i) {
+            crow::response res;
+            routeController.isCourseFull(reqs[i % reqs.size()], res);
+        });
+
+        // What every read handler used to do before looking anything up.
+        size_t copyRequests = std::max<size_t>(1, requests / departments / 10);
+        double copyNanos = nanosPerCall(copyRequests, [&](size_t i) {
+            auto mapping = db.getDepartmentMapping();
+            auto dept = mapping.find("D" + std::to_string(100000 + i * 7919 % departments));
+            auto courses = dept->second.getCourseSelection();
+            courses.find(std::to_string(1000 + i % coursesPerDepartment));
+        });
+
+        std::cout << std::setw(12) << departments << std::setw(12)
+                  << departments * coursesPerDepartment << std::setw(14) << viewNanos
+                  << std::setw(14) << copyNanos << "\n";
+    }
+
+    std::remove(databasePath.c_str());
+    std::remove((databasePath + ".wal").c_str());
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright 2024 Jason Han
+#include "MyFileDatabase.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Measures /search latency on a 100k-course catalog: prefix queries on instructor last names,
+// misspelled last names that only match fuzzily, and course code prefixes. Reports percentiles
+// per query kind, and, for comparison, the mean time of answering a prefix query by scanning
+// every course in the department map, as a client emulating search would.
+//
+// Usage: search_benchmark [departments] [queries]
+
+namespace {
+
+const char* kFirstNames[] = {"Adam", "Gail", "Jae", "Brian", "Ansaf", "Josh", "Tony",
+                             "Daniel", "Uday", "Waseem", "Evan", "Mark", "Laura", "Victor",
+                             "Talha", "Milan", "Luis", "Ruben", "Yuri", "Miles"};
+const char* kLastNames[] = {"Cannon", "Kaiser", "Lee", "Borowski", "Salleb", "Alman",
+                            "Dear", "Menon", "Noor", "Gashaw", "Yilmaz", "Leahey",
+                            "Piskula", "Sadler", "Gomez", "Dean", "Dolan", "Lacker",
+                            "Dieker", "Wang", "Faenza", "Robbins", "Savizky", "Ulichny",
+                            "Campos", "Eckdahl", "Delor", "Owen", "Sames", "Marka",
+                            "Mccann", "Moffat", "Banta", "Mcmahon", "Larkin", "Carloni"};
+
+std::map<std::string, Department> buildCatalog(size_t departments) {
+    std::map<std::string, Department> mapping;
+    size_t instructor = 0;
+    for (size_t d = 0; d < departments; ++d) {
+        std::string deptCode = "D" + std::to_string(100000 + d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (size_t c = 0; c < 200; ++c, instructor += 7) {
+            std::string name = std::string(kFirstNames[instructor % 20]) + " " +
+                               kLastNames[instructor / 20 % 36] + " " +
+                               std::to_string(instructor / 720 % 6);
+            courses[std::to_string(1000 + c)] = std::make_shared<Course>(
+                100, name, std::to_string((d + c) % 600) + " HAV", "11:40-12:55");
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair " + deptCode, 1000);
+    }
+    return mapping;
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return text;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t departments = argc > 1 ? std::stoul(argv[1]) : 500;
+    size_t queries = argc > 2 ? std::stoul(argv[2]) : 2000;
+
+    std::map<std::string, Department> mapping = buildCatalog(departments);
+    MyFileDatabase db{1, "bench_search.bin"};
+    db.setMapping(mapping);
+    auto start = std::chrono::steady_clock::now();
+    db.search("warm up", 10);
+    std::chrono::duration<double, std::milli> buildMillis =
+        std::chrono::steady_clock::now() - start;
+    std::cout << departments * 200 << " courses, index built in " << std::fixed
+              << std::setprecision(1) << buildMillis.count() << " ms\n";
+
+    std::mt19937 random(4156);
+    std::vector<std::pair<std::string, std::vector<std::string>>> kinds(3);
+    kinds[0].first = "prefix";
+    kinds[1].first = "fuzzy";
+    kinds[2].first = "code";
+    for (size_t i = 0; i < queries; ++i) {
+        std::string last = kLastNames[random() % 36];
+        kinds[0].second.push_back(last.substr(0, 3 + random() % 3));
+        std::string misspelled = last;
+        misspelled[1 + random() % (misspelled.length() - 1)] = 'x';
+        kinds[1].second.push_back(misspelled);
+        kinds[2].second.push_back("D" + std::to_string(100000 + random() % departments) + " 1" +
+                                  std::to_string(random() % 2));
+    }
+
+    std::cout << std::setw(8) << "query" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(10) << "max us" << std::setw(10) << "results" << "\n";
+    for (const auto& [kind, texts] : kinds) {
+        std::vector<double> micros;
+        size_t results = 0;
+        for (const std::string& text : texts) {
+            auto begin = std::chrono::steady_clock::now();
+            results += db.search(text, 10).size();
+            std::chrono::duration<double, std::micro> elapsed =
+                std::chrono::steady_clock::now() - begin;
+            micros.push_back(elapsed.count());
+        }
+        std::sort(micros.begin(), micros.end());
+        std::cout << std::setw(8) << kind << std::setw(10) << micros[micros.size() / 2]
+                  << std::setw(10) << micros[micros.size() * 99 / 100] << std::setw(10)
+                  << micros.back() << std::setw(10) << results / texts.size() << "\n";
+    }
+
+    size_t scans = std::min<size_t>(queries, 20);
+    size_t matches = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scans; ++i) {
+        std::string query = lowercase(kinds[0].second[i]);
+        for (const auto& [deptCode, dept] : mapping) {
+            for (const auto& [courseCode, course] : dept.getCourseSelection()) {
+                if (lowercase(course->getInstructorName()).find(query) != std::string::npos ||
+                    lowercase(course->getCourseLocation()).find(query) != std::string::npos) {
+                    matches++;
+                }
+            }
+        }
+    }
+    std::chrono::duration<double, std::micro> scanMicros =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "scanning the map: " << scanMicros.count() / scans << " us per query, "
+              << matches / scans << " matches\n";
+    std::remove("bench_search.bin.wal");
+    return 0;
+}
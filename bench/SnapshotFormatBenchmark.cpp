@@ -0,0 +1,131 @@
+// Copyright 2024 Jason Han
+#include "ByteReader.h"
+#include "CompactSnapshot.h"
+#include "MappedSnapshot.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Compares snapshot formats on a synthetic catalog whose instructors, locations and time slots
+// repeat the way the real catalog's do: encoded size, encode time and decode time.
+//
+// Usage: snapshot_format_benchmark [departments] [coursesPerDepartment] [repetitions]
+
+namespace {
+
+std::map<std::string, Department> buildCatalog(size_t departments, size_t coursesPerDepartment) {
+    std::string times[] = {"11:40-12:55", "4:10-5:25", "10:10-11:25", "2:40-3:55", "6:10-7:25"};
+    std::map<std::string, Department> mapping;
+    for (size_t d = 0; d < departments; ++d) {
+        std::string deptCode = "D" + std::to_string(100000 + d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (size_t c = 0; c < coursesPerDepartment; ++c) {
+            auto course =
+                std::make_shared<Course>(static_cast<int>(100 + c % 300),
+                                         "Instructor " + std::to_string((d * 7 + c) % 400),
+                                         std::to_string((d + c) % 60) + " HAV",
+                                         times[c % 5]);
+            course->setEnrolledStudentCount(static_cast<int>(c % 100));
+            courses[std::to_string(1000 + c)] = course;
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair " + deptCode, 1000);
+    }
+    return mapping;
+}
+
+// The original stream format, as MyFileDatabase writes it with SnapshotFormat::Legacy.
+std::string encodeLegacy(const std::map<std::string, Department>& mapping) {
+    std::ostringstream out(std::ios::binary);
+    size_t mapSize = mapping.size();
+    out.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
+    for (const auto& it : mapping) {
+        size_t keyLen = it.first.length();
+        out.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+        out.write(it.first.c_str(), keyLen);
+        it.second.serialize(out);
+    }
+    return out.str();
+}
+
+std::map<std::string, Department> decodeLegacy(const std::string& bytes) {
+    ByteReader in(bytes, "Legacy snapshot");
+    std::map<std::string, Department> mapping;
+    uint64_t mapSize = in.readU64();
+    for (uint64_t i = 0; i < mapSize; ++i) {
+        std::string key = in.readString(in.readU64());
+        Department dept;
+        dept.deserialize(in);
+        mapping[key] = std::move(dept);
+    }
+    return mapping;
+}
+
+template <typename F> double bestMillis(size_t repetitions, F&& fn) {
+    double best = 0;
+    for (size_t i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+void report(const std::string& name,
+            size_t bytes,
+            size_t legacyBytes,
+            double encodeMillis,
+            double decodeMillis) {
+    std::cout << std::left << std::setw(16) << name << std::right << std::setw(12) << bytes
+              << std::setw(9) << static_cast<double>(legacyBytes) / bytes << "x" << std::setw(12)
+              << encodeMillis << std::setw(12) << decodeMillis << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t departments = argc > 1 ? std::stoul(argv[1]) : 500;
+    size_t coursesPerDepartment = argc > 2 ? std::stoul(argv[2]) : 200;
+    size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 3;
+    const std::string mappedPath = "bench_catalog_mapped.bin";
+    auto catalog = buildCatalog(departments, coursesPerDepartment);
+
+    std::cout << departments << " departments x " << coursesPerDepartment
+              << " courses, best of " << repetitions << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(16) << "format" << std::right << std::setw(12) << "bytes"
+              << std::setw(10) << "ratio" << std::setw(12) << "encode ms" << std::setw(12)
+              << "decode ms"
+              << "\n";
+
+    std::string legacy;
+    double encodeMillis = bestMillis(repetitions, [&]() { legacy = encodeLegacy(catalog); });
+    double decodeMillis = bestMillis(repetitions, [&]() { decodeLegacy(legacy); });
+    report("legacy", legacy.length(), legacy.length(), encodeMillis, decodeMillis);
+
+    std::string mapped;
+    encodeMillis = bestMillis(repetitions, [&]() { mapped = MappedSnapshot::encode(catalog); });
+    MappedSnapshot::writeAtomically(mappedPath, mapped);
+    decodeMillis =
+        bestMillis(repetitions, [&]() { MappedSnapshot(mappedPath).materializeAll(); });
+    report("mapped", mapped.length(), legacy.length(), encodeMillis, decodeMillis);
+    std::remove(mappedPath.c_str());
+
+    for (auto compression : {CompactCompression::None, CompactCompression::Zlib}) {
+        std::string compact;
+        encodeMillis = bestMillis(
+            repetitions, [&]() { compact = CompactSnapshot::encode(catalog, compression); });
+        decodeMillis = bestMillis(repetitions, [&]() { CompactSnapshot::decode(compact); });
+        report(compression == CompactCompression::None ? "compact" : "compact+zlib",
+               compact.length(),
+               legacy.length(),
+               encodeMillis,
+               decodeMillis);
+    }
+    return 0;
+}
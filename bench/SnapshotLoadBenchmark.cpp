@@ -0,0 +1,95 @@
+// Copyright 2024 Jason Han
+#include "MappedSnapshot.h"
+#include "MyFileDatabase.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Measures how long a full catalog load takes on a large synthetic catalog: the legacy stream
+// format on one thread, then the mapped format materialized across 1, 2, 4, ... threads.
+//
+// Usage: snapshot_load_benchmark [departments] [coursesPerDepartment] [repetitions] [maxThreads]
+
+namespace {
+
+std::map<std::string, Department> buildCatalog(size_t departments, size_t coursesPerDepartment) {
+    std::string times[] = {"11:40-12:55", "4:10-5:25", "10:10-11:25", "2:40-3:55"};
+    std::map<std::string, Department> mapping;
+    for (size_t d = 0; d < departments; ++d) {
+        std::string deptCode = "D" + std::to_string(100000 + d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (size_t c = 0; c < coursesPerDepartment; ++c) {
+            auto course = std::make_shared<Course>(static_cast<int>(100 + c % 300),
+                                                   "Instructor " + std::to_string(c % 97),
+                                                   std::to_string(c % 800) + " Building",
+                                                   times[c % 4]);
+            course->setEnrolledStudentCount(static_cast<int>(c % 100));
+            courses[std::to_string(1000 + c)] = course;
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair " + deptCode, 1000);
+    }
+    return mapping;
+}
+
+template <typename F> double bestMillis(size_t repetitions, F&& fn) {
+    double best = 0;
+    for (size_t i = 0; i < repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t departments = argc > 1 ? std::stoul(argv[1]) : 2000;
+    size_t coursesPerDepartment = argc > 2 ? std::stoul(argv[2]) : 200;
+    size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 3;
+    const std::string legacyPath = "bench_catalog_legacy.bin";
+    const std::string mappedPath = "bench_catalog_mapped.bin";
+
+    {
+        auto catalog = buildCatalog(departments, coursesPerDepartment);
+        MyFileDatabase legacy{1, legacyPath};
+        legacy.setSnapshotFormat(SnapshotFormat::Legacy);
+        legacy.setMapping(catalog);
+        legacy.saveContentsToFile();
+        MappedSnapshot::write(mappedPath, catalog);
+    }
+
+    std::cout << departments << " departments x " << coursesPerDepartment
+              << " courses, best of " << repetitions << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+
+    double legacyMillis = bestMillis(repetitions, [&]() {
+        MyFileDatabase db{1, legacyPath};
+        db.deSerializeObjectFromFile();
+    });
+    std::cout << "legacy stream, 1 thread: " << legacyMillis << " ms\n";
+
+    MappedSnapshot snapshot(mappedPath);
+    double singleMillis = 0;
+    size_t maxThreads = argc > 4 ? std::stoul(argv[4])
+                                 : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        double millis = bestMillis(repetitions, [&]() { snapshot.materializeAll(threads); });
+        if (threads == 1) {
+            singleMillis = millis;
+        }
+        std::cout << "mapped, " << threads << " thread(s): " << millis << " ms ("
+                  << singleMillis / millis << "x)\n";
+    }
+
+    std::remove(legacyPath.c_str());
+    std::remove((legacyPath + ".wal").c_str());
+    std::remove(mappedPath.c_str());
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Copyright 2024 Jason Han
+#include "TimeIndex.h"
+#include "TimeRange.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Compares three ways of finding the courses that meet during a time range: scanning every
+// course's time slot string and parsing it on each query, scanning the ranges parsed when the
+// courses were built, and querying the interval index. Each query asks for a random 30 minute
+// window, which matches about a sixth of the catalog.
+//
+// Usage: time_index_benchmark [queries]
+
+namespace {
+
+// Time slots as the catalog writes them: on a 12-hour clock, starting on the hour or half hour
+// between 8:00 and 7:30, and lasting 50, 75 or 150 minutes.
+std::vector<std::string> buildTimeSlots(size_t courses, std::mt19937& random) {
+    std::uniform_int_distribution<int> startSlot(0, 23);
+    int lengths[] = {50, 75, 150};
+    std::vector<std::string> slots;
+    slots.reserve(courses);
+    for (size_t i = 0; i < courses; ++i) {
+        int start = 8 * 60 + startSlot(random) * 30;
+        int end = start + lengths[i % 3];
+        char buffer[16];
+        std::snprintf(buffer,
+                      sizeof(buffer),
+                      "%d:%02d-%d:%02d",
+                      (start / 60 + 11) % 12 + 1,
+                      start % 60,
+                      (end / 60 + 11) % 12 + 1,
+                      end % 60);
+        slots.emplace_back(buffer);
+    }
+    return slots;
+}
+
+template <typename F> double totalMillis(F&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t queries = argc > 1 ? std::stoul(argv[1]) : 100;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(10) << "courses" << std::setw(14) << "parse ms" << std::setw(14)
+              << "scan ms" << std::setw(14) << "index ms" << std::setw(12) << "matches"
+              << "\n";
+    for (size_t courses : {100000, 1000000}) {
+        std::mt19937 random(4156);
+        std::vector<std::string> slots = buildTimeSlots(courses, random);
+        std::vector<std::pair<TimeRange, uint32_t>> ranges;
+        ranges.reserve(courses);
+        for (uint32_t i = 0; i < slots.size(); ++i) {
+            ranges.emplace_back(*TimeRange::parse(slots[i]), i);
+        }
+        TimeIndex index(ranges);
+
+        std::uniform_int_distribution<int> minute(8 * 60, 21 * 60);
+        std::vector<TimeRange> windows;
+        for (size_t i = 0; i < queries; ++i) {
+            int start = minute(random);
+            windows.push_back(
+                TimeRange{static_cast<uint16_t>(start), static_cast<uint16_t>(start + 30)});
+        }
+
+        size_t parseMatches = 0;
+        double parseMillis = totalMillis([&]() {
+            for (TimeRange window : windows) {
+                std::vector<uint32_t> matches;
+                for (uint32_t i = 0; i < slots.size(); ++i) {
+                    std::optional<TimeRange> range = TimeRange::parse(slots[i]);
+                    if (range && range->overlaps(window)) {
+                        matches.push_back(i);
+                    }
+                }
+                parseMatches += matches.size();
+            }
+        });
+        size_t scanMatches = 0;
+        double scanMillis = totalMillis([&]() {
+            for (TimeRange window : windows) {
+                std::vector<uint32_t> matches;
+                for (const auto& [range, id] : ranges) {
+                    if (range.overlaps(window)) {
+                        matches.push_back(id);
+                    }
+                }
+                scanMatches += matches.size();
+            }
+        });
+        size_t indexMatches = 0;
+        double indexMillis = totalMillis([&]() {
+            for (TimeRange window : windows) {
+                indexMatches += index.findOverlapping(window).size();
+            }
+        });
+        if (parseMatches != indexMatches || scanMatches != indexMatches) {
+            std::cerr << "scan and index results differ\n";
+            return 1;
+        }
+        std::cout << std::setw(10) << courses << std::setw(14) << parseMillis / queries
+                  << std::setw(14) << scanMillis / queries << std::setw(14)
+                  << indexMillis / queries << std::setw(12) << indexMatches / queries << "\n";
+    }
+    return 0;
+}
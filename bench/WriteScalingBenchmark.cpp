@@ -0,0 +1,129 @@
+// Copyright 2024 Jason Han
+#include "MyFileDatabase.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures update throughput across 1, 2, 4, ... writer threads, each dropping students from and
+// adding majors to departments picked at random, while one reader thread keeps looking courses
+// up. Writers of different departments lock different stripes, so throughput should grow with
+// the number of cores until it runs out of them or the departments start to collide. Given a
+// number of owner threads, changes to departments are applied by the departments' owners
+// instead, with the first department on an owner of its own. hotPercent sends that share of the
+// updates to the first department, to compare the two when one department is hot. Updates
+// aren't logged, so the numbers measure the in-memory path.
+//
+// Usage: write_scaling_benchmark [departments] [maxThreads] [millis] [owners] [hotPercent]
+
+namespace {
+
+std::map<std::string, Department> buildCatalog(size_t departments) {
+    std::map<std::string, Department> mapping;
+    for (size_t d = 0; d < departments; ++d) {
+        std::string deptCode = "D" + std::to_string(100000 + d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (size_t c = 0; c < 20; ++c) {
+            courses[std::to_string(1000 + c)] = std::make_shared<Course>(
+                1 << 30, "Instructor " + std::to_string(c), "417 IAB", "11:40-12:55");
+            courses[std::to_string(1000 + c)]->setEnrolledStudentCount(1 << 30);
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair " + deptCode, 0);
+    }
+    return mapping;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t departments = argc > 1 ? std::stoul(argv[1]) : 1000;
+    size_t maxThreads = argc > 2 ? std::stoul(argv[2]) : 32;
+    auto duration = std::chrono::milliseconds(argc > 3 ? std::stoul(argv[3]) : 500);
+    const std::string databasePath = "bench_write_scaling.bin";
+
+    size_t owners = argc > 4 ? std::stoul(argv[4]) : 0;
+    size_t hotPercent = argc > 5 ? std::stoul(argv[5]) : 0;
+
+    std::vector<std::string> deptCodes;
+    for (size_t d = 0; d < departments; ++d) {
+        deptCodes.push_back("D" + std::to_string(100000 + d));
+    }
+    MyFileDatabase db{1, databasePath};
+    if (owners > 0) {
+        std::map<std::string, size_t> assignment;
+        for (size_t d = 1; d < departments; ++d) {
+            assignment[deptCodes[d]] = owners > 1 ? 1 + d % (owners - 1) : 0;
+        }
+        db.setWriterThreads(owners, assignment);
+    }
+    db.setMapping(buildCatalog(departments));
+
+    std::cout << departments << " departments (" << hotPercent << "% of updates to one), "
+              << (owners > 0 ? std::to_string(owners) + " owner threads" : "striped locks")
+              << ", one reader, " << std::thread::hardware_concurrency()
+              << " hardware threads\n";
+    std::cout << std::setw(8) << "writers" << std::setw(16) << "updates/s" << std::setw(12)
+              << "speedup" << std::setw(16) << "lookups/s" << "\n";
+    std::cout << std::fixed;
+    double baseline = 0;
+    uint64_t expected = 0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> updates{0};
+        uint64_t lookups = 0;
+        std::thread reader([&]() {
+            for (size_t i = 0; !stop; ++i) {
+                CourseView course = db.viewCourse(deptCodes[i * 7919 % deptCodes.size()],
+                                                  std::to_string(1000 + i % 20));
+                lookups += course ? 1 : 0;
+            }
+        });
+        std::vector<std::thread> writers;
+        for (size_t t = 0; t < threads; ++t) {
+            writers.emplace_back([&, t]() {
+                uint64_t done = 0;
+                for (size_t i = t * 104729; !stop; ++i) {
+                    const std::string& deptCode = i % 100 < hotPercent
+                                                      ? deptCodes[0]
+                                                      : deptCodes[i * 7919 % deptCodes.size()];
+                    db.addMajorToDept(deptCode, Durability::None);
+                    db.dropStudentFromCourse(
+                        deptCode, std::to_string(1000 + i % 20), Durability::None);
+                    done += 2;
+                }
+                updates += done;
+            });
+        }
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        reader.join();
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        expected += updates / 2;
+
+        double seconds = std::chrono::duration<double>(duration).count();
+        double perSecond = updates / seconds;
+        baseline = baseline > 0 ? baseline : perSecond;
+        std::cout << std::setw(8) << threads << std::setw(16) << std::setprecision(0)
+                  << perSecond << std::setw(12) << std::setprecision(2) << perSecond / baseline
+                  << std::setw(16) << std::setprecision(0) << lookups / seconds << "\n";
+    }
+
+    // Every update must have landed.
+    uint64_t majors = 0;
+    for (const std::string& deptCode : deptCodes) {
+        majors += db.viewDepartment(deptCode)->getNumberOfMajors();
+    }
+    std::cout << (majors == expected ? "all " : "LOST UPDATES: ") << majors << " of " << expected
+              << " majors added\n";
+
+    std::remove(databasePath.c_str());
+    std::remove((databasePath + ".wal").c_str());
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Copyright 2024 Jason Han
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Heap is the default allocator; Arena allocates each loaded batch of courses from the slabs of
+// one Arena.
+enum class AllocationMode { Heap, Arena };
+
+// Monotonic slab allocator for the courses of one catalog load, and for interned strings.
+// Allocations are carved out of contiguous slabs, each one larger than the last, and are never
+// freed individually: the slabs are freed together when the arena is destroyed. Not thread-safe;
+// each loading thread uses an arena of its own.
+//
+// Objects created with makeShared() keep the arena alive, so the arena lives exactly as long as
+// the last of them, however many catalog versions end up sharing them.
+class Arena : public std::enable_shared_from_this<Arena> {
+public:
+    explicit Arena(size_t firstSlabBytes = 4096);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment);
+    size_t getBytesAllocated() const;
+    size_t getSlabCount() const;
+
+    template <typename T, typename... Args> std::shared_ptr<T> makeShared(Args&&... args);
+
+private:
+    std::vector<std::unique_ptr<char[]>> slabs;
+    size_t nextSlabBytes;
+    char* cursor;
+    char* end;
+    size_t bytesAllocated;
+};
+
+// Allocator for the object and control block of a makeShared() object. It owns a reference to the
+// arena, which is what keeps the arena alive.
+template <typename T> class ArenaOwnerAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaOwnerAllocator(std::shared_ptr<Arena> arena) noexcept
+        : arena(std::move(arena)) {}
+    template <typename U>
+    ArenaOwnerAllocator(const ArenaOwnerAllocator<U>& other) noexcept
+        : arena(other.getArena()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    const std::shared_ptr<Arena>& getArena() const noexcept {
+        return arena;
+    }
+
+    template <typename U> bool operator==(const ArenaOwnerAllocator<U>& other) const noexcept {
+        return arena == other.getArena();
+    }
+    template <typename U> bool operator!=(const ArenaOwnerAllocator<U>& other) const noexcept {
+        return arena != other.getArena();
+    }
+
+private:
+    std::shared_ptr<Arena> arena;
+};
+
+// Creates an object, and its shared_ptr control block, in the arena. The arena must be owned by a
+// std::shared_ptr.
+template <typename T, typename... Args> std::shared_ptr<T> Arena::makeShared(Args&&... args) {
+    return std::allocate_shared<T>(ArenaOwnerAllocator<T>(shared_from_this()),
+                                   std::forward<Args>(args)...);
+}
+
+#endif
@@ -0,0 +1,38 @@
+// Copyright 2024 Jason Han
+#ifndef BYTEREADER_H
+#define BYTEREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Parses fixed-width integers, varints and strings out of an in-memory buffer. Every read is
+// checked against the bytes that remain, and a failed read throws std::runtime_error naming the
+// source and the offset, so corrupt lengths can never cause huge allocations or overreads.
+class ByteReader {
+public:
+    ByteReader(std::string_view data, std::string source);
+
+    uint8_t readU8();
+    uint16_t readU16();
+    uint32_t readU32();
+    uint64_t readU64();
+    int32_t readI32();
+    uint64_t readVarint();
+    int32_t readSignedVarint32();
+    std::string_view readBytes(uint64_t length);
+    std::string readString(uint64_t length);
+
+    size_t remaining() const;
+    size_t offset() const;
+    void expectEnd() const;
+    [[noreturn]] void fail(const std::string& reason) const;
+
+private:
+    std::string_view data;
+    size_t position;
+    std::string source;
+};
+
+#endif
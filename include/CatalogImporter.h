@@ -0,0 +1,58 @@
+// Copyright 2024 Jason Han
+#ifndef CATALOGIMPORTER_H
+#define CATALOGIMPORTER_H
+
+#include "Department.h"
+#include "MyFileDatabase.h"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <optional>
+#include <string>
+
+// Bulk catalog import from registrar exports. Every record describes one course section, or a
+// department without sections when its course column is empty:
+//
+//   CSV:         a header row naming the columns, then one record per row (RFC 4180 quoting)
+//   JSON Lines:  one flat object per line, keyed by column name
+//
+// Columns: department, chair, majors, course, instructor, location, time, capacity, enrolled.
+// department is required on every record and capacity on every course record; other columns
+// are optional and unknown columns are ignored. When a department's chair or majors, or a course,
+// appears more than once, the last record wins.
+enum class ImportFormat { Csv, JsonLines };
+
+struct ImportStats {
+    uint64_t bytes = 0;
+    uint64_t records = 0;
+    uint64_t chunks = 0;
+    uint64_t departments = 0;
+    uint64_t courses = 0;
+    uint64_t parseMicros = 0;
+    uint64_t snapshotMicros = 0;
+
+    std::string display() const;
+};
+
+class CatalogImporter {
+public:
+    explicit CatalogImporter(ImportFormat format);
+
+    void setThreadCount(size_t threadCount);
+    void setChunkSize(size_t chunkSize);
+
+    std::map<std::string, Department> parse(std::istream& in, const std::string& source);
+    ImportStats importFile(const std::string& path, MyFileDatabase& database);
+    ImportStats getStats() const;
+
+    static std::optional<ImportFormat> formatForPath(const std::string& path);
+
+private:
+    ImportFormat format;
+    size_t threadCount;
+    size_t chunkSize;
+    ImportStats stats;
+};
+
+#endif
@@ -0,0 +1,37 @@
+// Copyright 2024 Jason Han
+#ifndef COMPACTSNAPSHOT_H
+#define COMPACTSNAPSHOT_H
+
+#include "Department.h"
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Size-optimized snapshot format (version 3 of the stream format). Integers and lengths are
+// varints, and every distinct string is stored once in a dictionary that departments and courses
+// refer to by index. The encoded payload is split into blocks that can each be zlib-compressed
+// and that each carry a CRC-32C of their stored bytes.
+//
+//   magic "CATSNAPC", varint version, u8 compression
+//   blocks: varint rawLength, varint storedLength, u32 crc, bytes; a zero rawLength ends the file
+//
+//   payload: varint stringCount, strings (varint length, bytes)
+//            varint departmentCount, departments:
+//              varint deptCode, varint chair, zigzag varint numberOfMajors, varint courseCount,
+//              courses: varint courseId, location, instructor, timeSlot,
+//                       zigzag varint capacity, zigzag varint enrolled
+enum class CompactCompression : uint8_t { None = 0, Zlib = 1 };
+
+class CompactSnapshot {
+public:
+    static std::string encode(const std::map<std::string, Department>& mapping,
+                              CompactCompression compression);
+    static std::map<std::string, Department> decode(const std::string& bytes,
+                                                    AllocationMode mode = AllocationMode::Heap);
+
+    static bool isCompactSnapshot(const std::string& path);
+    static std::map<std::string, Department> read(const std::string& path,
+                                                  AllocationMode mode = AllocationMode::Heap);
+};
+
+#endif
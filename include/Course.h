@@ -2,42 +2,105 @@
 #ifndef COURSE_H
 #define COURSE_H
 
+#include "ByteReader.h"
+#include "InternTable.h"
+#include "TimeRange.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 
+// The outcome of a seat change made with a compare-and-swap. Stale means the course was retired
+// in favor of a newer version, which the caller should look up and retry on. Conflict means the
+// course had moved past the version the caller expected.
+enum class SeatChange { Applied, Rejected, Stale, Conflict };
+
+// What a conditional change expects a course to be at: its version, and its seat count, which
+// changes in place without moving the version on.
+struct CourseState {
+    uint64_t version = 0;
+    int count = 0;
+};
+
+// A course's seat count is atomic, so enrolling or dropping a student is one compare-and-swap
+// even on a course that has been published for other threads to read, and each course sits on
+// a cache line of its own, so hot courses next to each other in memory don't false-share. A batch
+// of changes can be applied with one compare-and-swap too (see SeatCombiner). Replacing the
+// course with a newer version advances its version; seat changes don't, so a conditional change
+// compares the seat count as well (see CourseState). Versions live in memory only and restart
+// from 0 when the course is loaded; the catalog generation a client's state also holds keeps
+// versions read before the load from matching (see ExpectedState).
 class Course {
 public:
     Course(int capacity,
-           const std::string& instructorName,
-           const std::string& courseLocation,
-           const std::string& timeSlot);
+           std::string_view instructorName,
+           std::string_view courseLocation,
+           std::string_view timeSlot);
+    Course(int capacity,
+           InternedString instructorName,
+           InternedString courseLocation,
+           InternedString timeSlot);
     Course();
+    Course(const Course& other);
+    Course& operator=(const Course& other);
 
     std::string getCourseLocation() const;
     std::string getInstructorName() const;
     std::string getCourseTimeSlot() const;
+    InternedString getInternedLocation() const;
+    InternedString getInternedInstructor() const;
+    InternedString getInternedTimeSlot() const;
+    std::optional<TimeRange> getTimeRange() const;
+    int getEnrolledStudentCount() const;
+    int getEnrollmentCapacity() const;
+    uint64_t getVersion() const;
+    CourseState getState() const;
     std::string display() const;
 
     bool isCourseFull() const;
     void setEnrolledStudentCount(int count);
     bool enrollStudent();
     bool dropStudent();
+    SeatChange reserveSeat();
+    SeatChange releaseSeat();
+    SeatChange changeSeats(int delta);
+    std::optional<SeatChange> tryChangeSeats(int delta);
+    SeatChange changeSeats(const int* deltas, SeatChange* results, size_t count);
+    SeatChange storeSeats(int count, std::optional<CourseState> expected = std::nullopt);
+    int retireSeats();
+    bool supersede(Course& previous, std::optional<CourseState> expected = std::nullopt);
+    bool isRetired() const;
 
     void reassignLocation(const std::string& newLocation);
     void reassignInstructor(const std::string& newInstructorName);
     void reassignTime(const std::string& newTime);
 
     void serialize(std::ostream& out) const;
-    void deserialize(std::istream& in);
+    void deserialize(ByteReader& in);
 
     bool operator==(const Course& rhs) const;
     bool operator!=(const Course& rhs) const;
 
 private:
+    // The enrolled count in the low 32 bits, and kRetired once retireSeats() has been called.
+    static constexpr uint64_t kRetired = uint64_t{1} << 32;
+
+    static uint64_t packSeats(int count);
+    static int countOf(uint64_t word);
+    SeatChange checkSeats(uint64_t word, int delta) const;
+
+    alignas(64) std::atomic<uint64_t> seats;
+    // Never changed once the course is published. A department writer replacing the course gives
+    // the newer version the next one, at most once per change, so 64 bits can't wrap in a
+    // server's lifetime.
+    uint64_t version;
     int enrollmentCapacity;
-    int enrolledStudentCount;
-    std::string courseLocation;
-    std::string instructorName;
-    std::string courseTimeSlot;
+    InternedString courseLocation;
+    InternedString instructorName;
+    InternedString courseTimeSlot;
+    TimeRange timeRange;  // The parsed time slot, or {0, 0} if it doesn't parse.
 };
 
 #endif
@@ -0,0 +1,88 @@
+// Copyright 2024 Jason Han
+#ifndef COURSECOLUMNS_H
+#define COURSECOLUMNS_H
+
+#include "Department.h"
+#include "InternTable.h"
+#include "PackedIndex.h"
+#include "PostingIndex.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Identifies a course by department and course code.
+struct CourseKey {
+    std::string deptCode;
+    std::string courseCode;
+
+    bool operator==(const CourseKey& rhs) const {
+        return deptCode == rhs.deptCode && courseCode == rhs.courseCode;
+    }
+};
+
+// Struct-of-arrays copy of the scalar fields of every course in a catalog, for questions asked
+// across the whole catalog. Courses get dense IDs in department order, then course order, and
+// each field lives in an array of its own, so a scan streams through just the fields it needs.
+// Seat counts change in place on hot courses, so rather than the count, the columns keep whether
+// each course is full, which only changes when a course fills up or stops being full.
+//
+// The set of courses is fixed at construction; field values are updated in place while scans
+// run, by one writer at a time per course. Each value is read and written atomically, with
+// relaxed ordering: a scan sees every course at some version, but not necessarily the same
+// version for all of them. The interned-string columns are also indexed by value, so the courses
+// with one location, instructor or time slot are listed without a scan; those lookups must hold
+// an epoch guard.
+class CourseColumns {
+public:
+    explicit CourseColumns(
+        const std::vector<std::pair<std::string_view, const Department*>>& departments);
+
+    CourseColumns(const CourseColumns&) = delete;
+    CourseColumns& operator=(const CourseColumns&) = delete;
+
+    size_t size() const;
+    std::optional<uint32_t> find(std::string_view deptCode, std::string_view courseCode) const;
+    CourseKey getKey(uint32_t course) const;
+    InternedString getLocation(uint32_t course) const;
+    InternedString getInstructor(uint32_t course) const;
+    std::optional<TimeRange> getTimeRange(uint32_t course) const;
+    void update(uint32_t course, const Course& value);
+    void refreshFullness(uint32_t course, const Course& value);
+
+    std::vector<uint32_t> findFull() const;
+    std::vector<uint32_t> findByLocation(InternedString location) const;
+    std::vector<uint32_t> findByInstructor(InternedString instructor) const;
+    std::vector<uint32_t> findByTimeSlot(InternedString timeSlot) const;
+
+private:
+    void store(uint32_t course, const Course& value);
+
+    size_t count;
+    std::unique_ptr<std::atomic<uint8_t>[]> full;  // 1 if the course is full, otherwise 0.
+    std::unique_ptr<std::atomic<uint32_t>[]> location;
+    std::unique_ptr<std::atomic<uint32_t>[]> instructor;
+    std::unique_ptr<std::atomic<uint32_t>[]> timeSlot;
+    std::unique_ptr<std::atomic<uint32_t>[]> timeRange;  // Start in the high half, end in the low.
+
+    PostingIndex locationIndex;
+    PostingIndex instructorIndex;
+    PostingIndex timeSlotIndex;
+    std::mutex indexMutex;  // Serializes moves between index lists.
+
+    // Cold data, only touched to resolve a key or report a match.
+    std::vector<std::string> deptCodes;
+    std::vector<uint32_t> deptStart;
+    std::vector<uint32_t> deptOf;
+    std::vector<std::string> courseCodes;
+    CodeIndex<uint32_t> deptIndex;
+    PackedIndex<uint32_t> courseIndex;
+};
+
+#endif
@@ -0,0 +1,15 @@
+// Copyright 2024 Jason Han
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32C (Castagnoli), the checksum used by every on-disk section. crc32c() uses the SSE4.2 or
+// ARMv8 CRC instructions when the CPU has them and falls back to crc32cPortable() otherwise. Pass
+// the previous result as crc to checksum data in pieces.
+uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0);
+uint32_t crc32cPortable(const void* data, size_t length, uint32_t crc = 0);
+bool crc32cIsHardwareAccelerated();
+
+#endif
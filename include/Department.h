@@ -3,10 +3,13 @@
 #define DEPARTMENT_H
 
 #include "Course.h"
+#include "PackedIndex.h"
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 
 class Department {
 public:
@@ -16,14 +19,23 @@ public:
                int numberOfMajors);
 
     Department();
+    Department(const Department& other);
+    Department(Department&& other) = default;
+    Department& operator=(const Department& other);
+    Department& operator=(Department&& other) = default;
 
+    std::string getDeptCode() const;
     int getNumberOfMajors() const;
+    uint64_t getVersion() const;
     std::string getDepartmentChair() const;
     const std::map<std::string, std::shared_ptr<Course>>& getCourseSelection() const;
+    const Course* findCourse(std::string_view courseId) const;
     std::string display() const;
 
     void addPersonToMajor();
     void dropPersonFromMajor();
+    void setNumberOfMajors(int count);
+    void setVersion(uint64_t next);
 
     void addCourse(std::string courseId, std::shared_ptr<Course> course);
     void createCourse(std::string courseId,
@@ -33,16 +45,24 @@ public:
                       int capacity);
 
     void serialize(std::ostream& out) const;
-    void deserialize(std::istream& in);
+    void deserialize(ByteReader& in, const std::shared_ptr<Arena>& arena = nullptr);
 
     bool operator==(const Department& rhs) const;
     bool operator!=(const Department& rhs) const;
 
 private:
+    void indexCourses();
+
     int numberOfMajors;
+    // Advanced by every change to the department's own fields, but not by changes to its courses,
+    // which have versions of their own. Kept in memory only, and scoped to the catalog generation
+    // (see ExpectedState).
+    uint64_t version;
     std::string deptCode;
     std::string departmentChair;
     std::map<std::string, std::shared_ptr<Course>> courses;
+    // Hashes the keys of courses for lookups; the map keeps them in order for iteration.
+    CodeIndex<const Course*> courseIndex;
 };
 
 #endif
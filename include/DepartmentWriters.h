@@ -0,0 +1,85 @@
+// Copyright 2024 Jason Han
+#ifndef DEPARTMENTWRITERS_H
+#define DEPARTMENTWRITERS_H
+
+#include "StripedMutex.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Runs every change to a department one at a time. With no owner threads, the default, a change
+// runs on the caller's thread under the StripedMutex stripe of its department. With owner
+// threads, each department belongs to one of them, which runs its changes in the order they were
+// submitted without contending on a lock; departments are hashed onto the owners unless they are
+// assigned one explicitly. Each owner takes work from a lock-free multi-producer, single-consumer
+// queue and only sleeps on a condition variable when the queue is empty. lock() and unlock()
+// exclude every writer between two changes, by locking every stripe or pausing every owner, so
+// the whole set can be held through std::lock_guard; never hold it inside a change.
+class DepartmentWriters {
+public:
+    explicit DepartmentWriters(size_t threadCount,
+                               std::map<std::string, size_t> assignment = {});
+    ~DepartmentWriters();
+
+    DepartmentWriters(const DepartmentWriters&) = delete;
+    DepartmentWriters& operator=(const DepartmentWriters&) = delete;
+
+    void run(std::string_view deptCode, const std::function<void()>& fn);
+    size_t ownerOf(std::string_view deptCode) const;
+    size_t getThreadCount() const;
+    void lock();
+    void unlock();
+
+private:
+    // A queued change. Tasks live on the stack of the thread that submitted them, which waits
+    // until done is set.
+    struct Task {
+        std::atomic<Task*> next{nullptr};
+        const std::function<void()>* fn = nullptr;
+        std::exception_ptr error;
+        bool done = false;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    struct alignas(64) Owner {
+        Task stub;
+        alignas(64) std::atomic<Task*> tail{&stub};  // Written by producers.
+        alignas(64) Task* head = &stub;              // Read by the owner thread only.
+        std::atomic<bool> sleeping{false};
+        bool stopping = false;  // Guarded by mutex, like the sleeping owner's wake-ups.
+        std::mutex mutex;
+        std::condition_variable condition;
+        Task park;
+        std::thread thread;
+    };
+
+    static void push(Owner& owner, Task& task);
+    static Task* pop(Owner& owner);
+    static bool hasWork(const Owner& owner);
+    void serve(Owner& owner);
+    void park();
+
+    std::vector<std::unique_ptr<Owner>> owners;
+    std::map<std::string, size_t, std::less<>> assignment;
+    StripedMutex stripes;  // Serializes changes when there are no owner threads.
+
+    // pauseMutex serializes callers of lock(); stateMutex guards paused and parked.
+    std::mutex pauseMutex;
+    std::mutex stateMutex;
+    std::condition_variable stateCondition;
+    bool paused;
+    size_t parked;
+    std::function<void()> parkFn;
+};
+
+#endif
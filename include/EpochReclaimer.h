@@ -0,0 +1,45 @@
+// Copyright 2024 Jason Han
+#ifndef EPOCHRECLAIMER_H
+#define EPOCHRECLAIMER_H
+
+#include <cstddef>
+#include <functional>
+
+struct EpochRecord;
+
+// Pins the current reclamation epoch for as long as it is held, so nothing retired meanwhile is
+// deleted. Readers hold one while they use pointers loaded from a published structure. Guards
+// nest, and must be released on the thread that created them.
+class EpochGuard {
+public:
+    EpochGuard();
+    ~EpochGuard();
+
+    EpochGuard(EpochGuard&& other) noexcept;
+    EpochGuard& operator=(EpochGuard&& other) noexcept;
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+private:
+    void release();
+
+    EpochRecord* record;
+};
+
+// Epoch-based reclamation for objects that lock-free readers may still be looking at. A writer
+// that unpublishes an object retires it instead of deleting it, and the object is deleted once
+// every guard that was held when it was retired has been released.
+class EpochReclaimer {
+public:
+    template <typename T> static void retire(const T* object) {
+        if (!object) {
+            return;
+        }
+        retire(std::function<void()>([object]() { delete object; }));
+    }
+    static void retire(std::function<void()> deleter);
+    static size_t reclaim();
+    static size_t getPendingCount();
+};
+
+#endif
@@ -0,0 +1,100 @@
+// Copyright 2024 Jason Han
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Open-addressing hash index from string keys to values, probed linearly and kept at most half
+// full. Keys are stored as views, so the strings they point at must outlive the index and must
+// not move; lookups take a std::string_view and never allocate. Entries can be added or updated
+// but not removed, which is all an index over an immutable or append-only collection needs.
+template <typename T> class HashIndex {
+public:
+    HashIndex() : count(0) {}
+
+    void reserve(size_t keys) {
+        size_t capacity = 8;
+        while (capacity < 2 * keys) {
+            capacity *= 2;
+        }
+        if (capacity > entries.size()) {
+            rehash(capacity);
+        }
+    }
+
+    void insert(std::string_view key, T value) {
+        reserve(count + 1);
+        size_t hash = std::hash<std::string_view>()(key);
+        for (size_t i = hash & mask();; i = (i + 1) & mask()) {
+            Entry& entry = entries[i];
+            if (!entry.used) {
+                entry = Entry{key, hash, std::move(value), true};
+                count++;
+                return;
+            }
+            if (entry.hash == hash && entry.key == key) {
+                entry.key = key;
+                entry.value = std::move(value);
+                return;
+            }
+        }
+    }
+
+    const T* find(std::string_view key) const {
+        if (count == 0) {
+            return nullptr;
+        }
+        size_t hash = std::hash<std::string_view>()(key);
+        for (size_t i = hash & mask();; i = (i + 1) & mask()) {
+            const Entry& entry = entries[i];
+            if (!entry.used) {
+                return nullptr;
+            }
+            if (entry.hash == hash && entry.key == key) {
+                return &entry.value;
+            }
+        }
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    void clear() {
+        entries.clear();
+        count = 0;
+    }
+
+private:
+    struct Entry {
+        std::string_view key;
+        size_t hash = 0;
+        T value{};
+        bool used = false;
+    };
+
+    size_t mask() const {
+        return entries.size() - 1;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Entry> previous(capacity);
+        previous.swap(entries);
+        count = 0;
+        for (Entry& entry : previous) {
+            if (entry.used) {
+                insert(entry.key, std::move(entry.value));
+            }
+        }
+    }
+
+    std::vector<Entry> entries;
+    size_t count;
+};
+
+#endif
@@ -0,0 +1,96 @@
+// Copyright 2024 Jason Han
+#ifndef INTERNTABLE_H
+#define INTERNTABLE_H
+
+#include "Arena.h"
+#include "HashIndex.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+
+// Concurrent table that stores each distinct string once and names it by a 32-bit ID. ID 0 is
+// the empty string. Strings are never removed, so an ID stays valid, and resolving one is a
+// lock-free array read. Interning locks one of several shards, taking only a shared lock when
+// the string is already present.
+class InternTable {
+public:
+    InternTable();
+    ~InternTable();
+
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    uint32_t intern(std::string_view value);
+    std::optional<uint32_t> find(std::string_view value) const;
+    std::string_view resolve(uint32_t id) const;
+    size_t size() const;
+
+    static InternTable& global();
+
+private:
+    static constexpr size_t kShardCount = 16;
+    static constexpr size_t kChunkBits = 12;
+    static constexpr size_t kChunkSize = size_t{1} << kChunkBits;
+    static constexpr size_t kMaxChunks = size_t{1} << 14;
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        Arena characters;
+        HashIndex<uint32_t> ids;
+    };
+
+    std::string_view* chunkFor(uint32_t id);
+
+    Shard shards[kShardCount];
+    std::unique_ptr<std::atomic<std::string_view*>[]> chunks;
+    std::atomic<uint32_t> nextId;
+    std::mutex chunkMutex;
+};
+
+// A string interned in the global table. Copying and comparing one copies and compares its ID.
+class InternedString {
+public:
+    InternedString() : id(0) {}
+
+    static InternedString intern(std::string_view value) {
+        return InternedString(InternTable::global().intern(value));
+    }
+
+    // Looks a string up without adding it, for queries that shouldn't grow the table.
+    static std::optional<InternedString> find(std::string_view value) {
+        std::optional<uint32_t> id = InternTable::global().find(value);
+        return id ? std::optional<InternedString>(InternedString(*id)) : std::nullopt;
+    }
+
+    // Names the string with an ID read back from a column or index that stored getId().
+    static InternedString fromId(uint32_t id) {
+        return InternedString(id);
+    }
+
+    std::string_view view() const {
+        return InternTable::global().resolve(id);
+    }
+
+    uint32_t getId() const {
+        return id;
+    }
+
+    bool operator==(InternedString rhs) const {
+        return id == rhs.id;
+    }
+    bool operator!=(InternedString rhs) const {
+        return id != rhs.id;
+    }
+
+private:
+    explicit InternedString(uint32_t id) : id(id) {}
+
+    uint32_t id;
+};
+
+#endif
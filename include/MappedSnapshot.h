@@ -0,0 +1,131 @@
+// Copyright 2024 Jason Han
+#ifndef MAPPEDSNAPSHOT_H
+#define MAPPEDSNAPSHOT_H
+
+#include "Department.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// On-disk layout of a mapped snapshot. Every structure is fixed-size and 8-byte aligned so it can
+// be read in place from the mapping; strings are stored once in a per-segment string section and
+// referenced by offset.
+//
+//   MappedSnapshotHeader
+//   segment 0: MappedSegmentHeader, MappedCourseRecord[courseCount], strings
+//   segment 1: ...
+//   directory: MappedDirectoryEntry[departmentCount] sorted by code, directory strings
+//
+// Incremental writes append changed segments and a new directory after the existing ones and
+// then repoint the header, so a file may also hold dead segments and directories until it is
+// compacted. The header, the directory and every segment carry a CRC-32C.
+struct MappedStringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct MappedSnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t departmentCount;
+    uint64_t directoryOffset;
+    uint64_t directoryLength;
+    uint32_t directoryCrc;
+    uint32_t headerCrc;  // Covers every header field before it.
+};
+
+struct MappedDirectoryEntry {
+    MappedStringRef deptCode;
+    uint64_t segmentOffset;
+    uint64_t segmentLength;
+    uint32_t segmentCrc;
+    uint32_t reserved;
+};
+
+struct MappedSegmentHeader {
+    MappedStringRef deptCode;
+    MappedStringRef departmentChair;
+    int32_t numberOfMajors;
+    uint32_t courseCount;
+    uint32_t stringsOffset;
+    uint32_t stringsLength;
+};
+
+struct MappedCourseRecord {
+    MappedStringRef courseId;
+    MappedStringRef courseLocation;
+    MappedStringRef instructorName;
+    MappedStringRef courseTimeSlot;
+    int32_t enrollmentCapacity;
+    int32_t enrolledStudentCount;
+};
+
+struct MappedCourseView {
+    std::string_view courseId;
+    std::string_view courseLocation;
+    std::string_view instructorName;
+    std::string_view courseTimeSlot;
+    int enrollmentCapacity;
+    int enrolledStudentCount;
+};
+
+struct MappedWriteStats {
+    uint64_t bytesWritten = 0;
+    uint64_t segmentsWritten = 0;
+    uint64_t segmentsReused = 0;
+    bool compacted = false;
+};
+
+class MappedSnapshot {
+public:
+    explicit MappedSnapshot(const std::string& path);
+    ~MappedSnapshot();
+
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    size_t getDepartmentCount() const;
+    std::optional<size_t> findDepartment(std::string_view deptCode) const;
+    std::string_view getDepartmentCode(size_t index) const;
+    std::string_view getDepartmentChair(size_t index) const;
+    int getNumberOfMajors(size_t index) const;
+    size_t getCourseCount(size_t index) const;
+    MappedCourseView getCourse(size_t index, size_t courseIndex) const;
+    std::string_view segmentBytes(size_t index) const;
+
+    Department materialize(size_t index, const std::shared_ptr<Arena>& arena = nullptr) const;
+    std::vector<Department> materialize(const std::vector<size_t>& indices,
+                                        size_t threadCount,
+                                        AllocationMode mode = AllocationMode::Heap) const;
+    std::map<std::string, Department> materializeAll(
+        size_t threadCount = 1, AllocationMode mode = AllocationMode::Heap) const;
+
+    static bool isMappedSnapshot(const std::string& path);
+    static void write(const std::string& path, const std::map<std::string, Department>& mapping);
+    static std::string encode(const std::map<std::string, Department>& mapping);
+    static std::string encodeSegment(const Department& dept);
+    static MappedWriteStats writeIncremental(
+        const std::string& path,
+        const std::map<std::string, std::optional<std::string>>& segments,
+        double maxGarbageRatio);
+    static void writeAtomically(const std::string& path, const std::string& bytes);
+
+private:
+    const MappedSegmentHeader& segmentHeader(size_t index) const;
+    void verifySegment(size_t index) const;
+    std::string_view segmentString(const MappedSegmentHeader& segment, MappedStringRef ref) const;
+    const char* checkedRange(uint64_t offset, uint64_t length) const;
+
+    std::string path;
+    const char* data;
+    size_t size;
+    MappedSnapshotHeader header;
+    const MappedDirectoryEntry* directory;
+};
+
+#endif
@@ -8,6 +8,7 @@
 class MyApp {
 public:
     static void run(const std::string& mode);
+    static void importCatalog(const std::string& path);
     static void onTermination();
     static void overrideDatabase(MyFileDatabase* testData);
     static MyFileDatabase* getDatabase();
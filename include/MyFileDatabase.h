@@ -2,24 +2,262 @@
 #ifndef MYFILEDATABASE_H
 #define MYFILEDATABASE_H
 
+#include "CompactSnapshot.h"
+#include "CourseColumns.h"
 #include "Department.h"
+#include "DepartmentWriters.h"
+#include "EpochReclaimer.h"
+#include "MappedSnapshot.h"
+#include "SearchIndex.h"
+#include "SeatCombiner.h"
+#include "TimeIndex.h"
+#include "WriteAheadLog.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Conflict means the department or course had moved on from the state the caller expected.
+// NotDurable means the change was applied, but the commit of its write-ahead log record failed;
+// the record is retried with later commits.
+enum class MutationStatus {
+    Applied,
+    DepartmentNotFound,
+    CourseNotFound,
+    Rejected,
+    Conflict,
+    NotDurable
+};
+
+// What a conditional change expects a department or course to be at, as sent back from its ETag:
+// the generation of the catalog it was read from, the version, plus, for a course, the seat count
+// (see CourseState). Versions restart whenever a catalog is loaded or replaced, but every catalog
+// takes a new generation, so a state read from an earlier one, even in an earlier run of the
+// server, matches nothing. A course's state matches no department and a department's matches no
+// course.
+struct ExpectedState {
+    uint64_t generation = 0;
+    uint64_t version = 0;
+    std::optional<int> count;
+};
+
+// Legacy is the original field-by-field stream format; Mapped is the fixed-layout format read in
+// place through mmap (see MappedSnapshot.h); Compact is the size-optimized format (see
+// CompactSnapshot.h). All of them are always loadable.
+enum class SnapshotFormat { Legacy, Mapped, Compact };
+
+struct CheckpointStats {
+    uint64_t checkpoints = 0;
+    uint64_t failures = 0;
+    uint64_t lastDurationMicros = 0;
+    uint64_t maxDurationMicros = 0;
+    uint64_t totalDurationMicros = 0;
+    uint64_t lastPauseMicros = 0;
+    uint64_t maxPauseMicros = 0;
+    uint64_t lastBytes = 0;
+    uint64_t totalBytes = 0;
+    uint64_t lastSegmentsWritten = 0;
+    uint64_t lastSegmentsReused = 0;
+    uint64_t compactions = 0;
+
+    std::string display() const;
+};
+
+// One course found by a search, with the term it was found through.
+struct SearchResult {
+    CourseKey course;
+    SearchField field;
+    std::string text;
+    double score;
+};
+
+// A borrowed, read-only view of one department or course. Published departments and courses are
+// immutable but for seat counts, which are atomic: writers replace them with updated copies
+// instead of changing them, so a view always sees one consistent version, and holding it takes
+// no lock and never blocks a writer. The view pins the reclamation epoch, so what it points at
+// isn't deleted until it is released. Hold one only for the duration of a request, on the
+// thread that created it. The view also holds the generation of the catalog it was taken from
+// (see ExpectedState).
+template <typename T> class CatalogView {
+public:
+    CatalogView() : item(nullptr), generation(0) {}
+    CatalogView(EpochGuard guard, const T* item, uint64_t generation)
+        : guard(std::move(guard)), item(item), generation(generation) {}
+
+    explicit operator bool() const {
+        return item != nullptr;
+    }
+    const T& operator*() const {
+        return *item;
+    }
+    const T* operator->() const {
+        return item;
+    }
+    uint64_t getGeneration() const {
+        return generation;
+    }
+
+private:
+    std::optional<EpochGuard> guard;
+    const T* item;
+    uint64_t generation;
+};
+
+using DepartmentView = CatalogView<Department>;
+using CourseView = CatalogView<Course>;
 
 class MyFileDatabase {
 public:
     MyFileDatabase(int flag, const std::string& filePath);
+    ~MyFileDatabase();
+
+    MyFileDatabase(const MyFileDatabase&) = delete;
+    MyFileDatabase& operator=(const MyFileDatabase&) = delete;
 
-    void setMapping(const std::map<std::string, Department>& mapping);
+    void setMapping(std::map<std::string, Department> mapping);
     void saveContentsToFile() const;
     void deSerializeObjectFromFile();
+    void checkpoint();
+    void startCheckpointer(std::chrono::milliseconds interval, uint64_t mutationThreshold);
+    void stopCheckpointer();
+    CheckpointStats getCheckpointStats() const;
+    void setSnapshotFormat(SnapshotFormat format);
+    void setSnapshotCompression(CompactCompression compression);
+    void setLoadThreadCount(size_t threadCount);
+    void setWriterThreads(size_t threadCount, std::map<std::string, size_t> assignment = {});
+    void setAllocationMode(AllocationMode mode);
+    void setCompactionGarbageRatio(double ratio);
 
     std::map<std::string, Department> getDepartmentMapping() const;
+    DepartmentView viewDepartment(std::string_view deptCode) const;
+    CourseView viewCourse(std::string_view deptCode, std::string_view courseCode) const;
+    size_t getLoadedDepartmentCount() const;
+    std::vector<CourseKey> findFullCourses() const;
+    std::vector<CourseKey> findCoursesByLocation(std::string_view location) const;
+    std::vector<CourseKey> findCoursesByInstructor(std::string_view instructor) const;
+    std::vector<CourseKey> findCoursesByTimeSlot(std::string_view timeSlot) const;
+    std::vector<CourseKey> findCoursesMeetingDuring(TimeRange range) const;
+    std::vector<SearchResult> search(std::string_view query, size_t limit) const;
     std::string display() const;
 
+    MutationStatus setEnrollmentCount(const std::string& deptCode,
+                                      const std::string& courseCode,
+                                      int count,
+                                      Durability durability = Durability::Sync,
+                                      std::optional<ExpectedState> expected = std::nullopt);
+    MutationStatus setCourseLocation(const std::string& deptCode,
+                                     const std::string& courseCode,
+                                     const std::string& location,
+                                     Durability durability = Durability::Sync,
+                                     std::optional<ExpectedState> expected = std::nullopt);
+    MutationStatus setCourseInstructor(const std::string& deptCode,
+                                       const std::string& courseCode,
+                                       const std::string& instructor,
+                                       Durability durability = Durability::Sync,
+                                       std::optional<ExpectedState> expected = std::nullopt);
+    MutationStatus setCourseTime(const std::string& deptCode,
+                                 const std::string& courseCode,
+                                 const std::string& time,
+                                 Durability durability = Durability::Sync,
+                                 std::optional<ExpectedState> expected = std::nullopt);
+    MutationStatus addMajorToDept(const std::string& deptCode,
+                                  Durability durability = Durability::Sync,
+                                  std::optional<ExpectedState> expected = std::nullopt);
+    MutationStatus removeMajorFromDept(const std::string& deptCode,
+                                       Durability durability = Durability::Sync,
+                                       std::optional<ExpectedState> expected = std::nullopt);
+    MutationStatus enrollStudentInCourse(const std::string& deptCode,
+                                         const std::string& courseCode,
+                                         Durability durability = Durability::Sync);
+    MutationStatus dropStudentFromCourse(const std::string& deptCode,
+                                         const std::string& courseCode,
+                                         Durability durability = Durability::Sync);
+
+    void setGroupCommitWindow(std::chrono::microseconds window);
+    WalStats getWalStats() const;
+
 private:
-    std::map<std::string, Department> departmentMapping;
+    struct Catalog;
+
+    const Department* loadDepartment(Catalog& catalog, size_t index) const;
+    void loadAllDepartments() const;
+    const CourseColumns& loadColumns(Catalog& catalog) const;
+    const TimeIndex& loadTimeIndex(Catalog& catalog) const;
+    const SearchIndex& loadSearchIndex(Catalog& catalog) const;
+    void publishCatalog(Catalog* next);
+    void publishDepartment(Catalog& catalog, size_t index, const Department* next);
+    std::string encodeSnapshot(const std::map<std::string, Department>& mapping) const;
+    void noteMutation();
+    void runCheckpointer(std::chrono::milliseconds interval);
+    MutationStatus mutateDepartment(
+        const std::string& deptCode,
+        Durability durability,
+        std::optional<ExpectedState> expected,
+        const std::function<std::optional<WalRecord>(Department&)>& fn);
+    MutationStatus mutateCourse(const std::string& deptCode,
+                                const std::string& courseCode,
+                                Durability durability,
+                                std::optional<ExpectedState> expected,
+                                const std::function<std::optional<WalRecord>(Course&)>& fn);
+    MutationStatus changeSeats(
+        const std::string& deptCode,
+        const std::string& courseCode,
+        Durability durability,
+        std::optional<ExpectedState> expected,
+        const std::function<SeatChange(Course&, std::optional<CourseState>)>& fn);
+    MutationStatus commit(const std::optional<WalRecord>& record,
+                          Durability durability,
+                          std::optional<uint64_t>& lsn);
+    MutationStatus awaitCommit(uint64_t lsn);
+    void applyRecord(const WalRecord& record);
+    void replayWriteAheadLog();
+
+    // The published catalog, read without locks (see CatalogView). Writers publish a new version
+    // of a department by swapping its slot, and replace the whole catalog only when the set of
+    // departments changes; whatever they unpublish is retired through the EpochReclaimer.
+    std::atomic<Catalog*> catalog;
     std::string filePath;
+    SnapshotFormat snapshotFormat;
+    CompactCompression snapshotCompression;
+    size_t loadThreadCount;
+    AllocationMode allocationMode;
+    double compactionGarbageRatio;
+    WriteAheadLog writeAheadLog;
+
+    // writers applies the changes to each department one at a time, under the department's stripe
+    // or on its owner thread if owner threads were opted into (see setWriterThreads()), so
+    // changes to different departments run in parallel and each department's log order matches
+    // the order its changes are published in. Whole-catalog writers, such as setMapping() and the
+    // checkpoint pause, exclude every department writer. Readers never wait on the writers,
+    // except to build a catalog's course columns and indexes. Seat changes don't go through the
+    // writers (see changeSeats()). Lock order is checkpointMutex, then writers.
+    std::unique_ptr<DepartmentWriters> writers;
+
+    // Batches the seat changes of enrollments and drops that contend on a course (see
+    // SeatCombiner).
+    SeatCombiner seatCombiner;
+
+    // checkpointMutex serializes checkpoints; checkpointerMutex guards the background
+    // checkpointer's state and the statistics.
+    std::mutex checkpointMutex;
+    mutable std::mutex checkpointerMutex;
+    std::condition_variable checkpointerCondition;
+    std::atomic<uint64_t> mutationsSinceCheckpoint;
+    std::atomic<uint64_t> checkpointMutationThreshold;
+    std::atomic<bool> forceFullCheckpoint;
+    bool checkpointerStopping;
+    CheckpointStats checkpointStats;
+    std::thread checkpointer;
 };
 
 #endif
@@ -0,0 +1,169 @@
+// Copyright 2024 Jason Han
+#ifndef PACKEDINDEX_H
+#define PACKEDINDEX_H
+
+#include "HashIndex.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Packs a code of 1 to limit bytes into an integer, first byte in the most significant position,
+// so packed codes compare the way the strings do. Codes that are empty, too long or contain a NUL
+// byte don't pack; in particular, a packed code is never 0.
+inline std::optional<uint64_t> packCode(std::string_view code, size_t limit = 8) {
+    if (code.empty() || code.length() > limit) {
+        return std::nullopt;
+    }
+    uint64_t packed = 0;
+    for (char c : code) {
+        if (c == '\0') {
+            return std::nullopt;
+        }
+        packed = packed << 8 | static_cast<uint8_t>(c);
+    }
+    return packed << 8 * (8 - code.length());
+}
+
+// Packs a department code and a course code of up to 4 bytes each, such as "COMS" and "4156",
+// into one 64-bit key: the department in the high half, the course in the low half.
+inline std::optional<uint64_t> packCourseKey(std::string_view deptCode,
+                                             std::string_view courseCode) {
+    std::optional<uint64_t> dept = packCode(deptCode, 4);
+    std::optional<uint64_t> course = packCode(courseCode, 4);
+    if (!dept || !course) {
+        return std::nullopt;
+    }
+    return (*dept & 0xffffffff00000000) | *course >> 32;
+}
+
+// Open-addressing hash index from packed integer keys to values, probed linearly and kept at
+// most half full. Comparing keys is one integer compare, and the key 0, which no packed code
+// takes, marks an empty entry. Like HashIndex, entries can be added or updated but not removed.
+template <typename T> class PackedIndex {
+public:
+    PackedIndex() : count(0) {}
+
+    void reserve(size_t keys) {
+        size_t capacity = 8;
+        while (capacity < 2 * keys) {
+            capacity *= 2;
+        }
+        if (capacity > entries.size()) {
+            rehash(capacity);
+        }
+    }
+
+    void insert(uint64_t key, T value) {
+        reserve(count + 1);
+        for (size_t i = slotOf(key);; i = (i + 1) & mask()) {
+            Entry& entry = entries[i];
+            if (entry.key == 0) {
+                entry = Entry{key, std::move(value)};
+                count++;
+                return;
+            }
+            if (entry.key == key) {
+                entry.value = std::move(value);
+                return;
+            }
+        }
+    }
+
+    const T* find(uint64_t key) const {
+        if (count == 0) {
+            return nullptr;
+        }
+        for (size_t i = slotOf(key);; i = (i + 1) & mask()) {
+            const Entry& entry = entries[i];
+            if (entry.key == key) {
+                return &entry.value;
+            }
+            if (entry.key == 0) {
+                return nullptr;
+            }
+        }
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    void clear() {
+        entries.clear();
+        count = 0;
+    }
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        T value{};
+    };
+
+    size_t mask() const {
+        return entries.size() - 1;
+    }
+
+    // Packed codes differ mostly in their high bytes, so the key is multiplied to spread them
+    // and the high bits of the product are folded into the low ones the mask keeps.
+    size_t slotOf(uint64_t key) const {
+        uint64_t hash = key * 0x9e3779b97f4a7c15;
+        return static_cast<size_t>(hash ^ hash >> 32) & mask();
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Entry> previous(capacity);
+        previous.swap(entries);
+        count = 0;
+        for (Entry& entry : previous) {
+            if (entry.key != 0) {
+                insert(entry.key, std::move(entry.value));
+            }
+        }
+    }
+
+    std::vector<Entry> entries;
+    size_t count;
+};
+
+// Index from department or course codes to values. Codes of up to 8 bytes, which is all of them
+// in practice, are packed into integers once per lookup and kept in a PackedIndex; any other code
+// falls back to a HashIndex, whose stored views must stay valid as with HashIndex itself.
+template <typename T> class CodeIndex {
+public:
+    void reserve(size_t keys) {
+        packed.reserve(keys);
+    }
+
+    void insert(std::string_view code, T value) {
+        if (std::optional<uint64_t> key = packCode(code)) {
+            packed.insert(*key, std::move(value));
+        } else {
+            unpacked.insert(code, std::move(value));
+        }
+    }
+
+    const T* find(std::string_view code) const {
+        if (std::optional<uint64_t> key = packCode(code)) {
+            return packed.find(*key);
+        }
+        return unpacked.find(code);
+    }
+
+    size_t size() const {
+        return packed.size() + unpacked.size();
+    }
+
+    void clear() {
+        packed.clear();
+        unpacked.clear();
+    }
+
+private:
+    PackedIndex<T> packed;
+    HashIndex<T> unpacked;
+};
+
+#endif
@@ -0,0 +1,42 @@
+// Copyright 2024 Jason Han
+#ifndef POSTINGINDEX_H
+#define POSTINGINDEX_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Secondary index from the interned string IDs in one course column to the courses holding each
+// ID, so listing the k courses with a given value costs O(k) rather than a scan. Each ID's
+// course list is immutable and published through an atomic pointer in a chunked table, as in
+// InternTable. One writer at a time moves a course between lists by publishing new copies of
+// both and retiring the old ones to the epoch reclaimer; readers hold an epoch guard and never
+// block.
+class PostingIndex {
+public:
+    PostingIndex();
+    ~PostingIndex();
+
+    PostingIndex(const PostingIndex&) = delete;
+    PostingIndex& operator=(const PostingIndex&) = delete;
+
+    void build(const std::atomic<uint32_t>* column, size_t count);
+    std::vector<uint32_t> find(uint32_t value) const;
+    void move(uint32_t course, uint32_t from, uint32_t to);
+
+private:
+    using Postings = std::vector<uint32_t>;
+
+    static constexpr size_t kChunkBits = 12;
+    static constexpr size_t kChunkSize = size_t{1} << kChunkBits;
+    static constexpr size_t kMaxChunks = size_t{1} << 14;
+
+    std::atomic<const Postings*>& slotFor(uint32_t value);
+    void publish(uint32_t value, Postings postings);
+
+    std::unique_ptr<std::atomic<std::atomic<const Postings*>*>[]> chunks;
+};
+
+#endif
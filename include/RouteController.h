@@ -22,13 +22,21 @@ public:
     void findCourseLocation(const crow::request& req, crow::response& res);
     void findCourseInstructor(const crow::request& req, crow::response& res);
     void findCourseTime(const crow::request& req, crow::response& res);
+    void retrieveCoursesByInstructor(const crow::request& req, crow::response& res);
+    void retrieveCoursesByLocation(const crow::request& req, crow::response& res);
+    void retrieveCoursesByTimeSlot(const crow::request& req, crow::response& res);
+    void retrieveCoursesMeetingDuring(const crow::request& req, crow::response& res);
+    void search(const crow::request& req, crow::response& res);
+    void retrieveOverlappingCourses(const crow::request& req, crow::response& res);
     void addMajorToDept(const crow::request& req, crow::response& res);
     void removeMajorFromDept(const crow::request& req, crow::response& res);
     void setEnrollmentCount(const crow::request& req, crow::response& res);
     void setCourseLocation(const crow::request& req, crow::response& res);
     void setCourseInstructor(const crow::request& req, crow::response& res);
     void setCourseTime(const crow::request& req, crow::response& res);
+    void enrollStudentInCourse(const crow::request& req, crow::response& res);
     void dropStudentFromCourse(const crow::request&, crow::response& res);
+    void retrieveStats(crow::response& res);
 };
 
 #endif
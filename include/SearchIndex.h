@@ -0,0 +1,83 @@
+// Copyright 2024 Jason Han
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include "InternTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+enum class SearchField { Course, Instructor, Location };
+
+// A term that matched a search: a course code, naming one course, or an instructor or location,
+// naming every course that has it. Scores are in (0, 1]; prefix matches score above 0.5 and
+// fuzzy matches at most 0.5.
+struct SearchMatch {
+    SearchField field;
+    InternedString name;  // The instructor or location; empty for a course code.
+    uint32_t course;      // The course's ID in the course columns, for a course code.
+    std::string text;
+    double score;
+};
+
+// Search index over the course codes, instructor names and locations of a catalog. Terms are
+// normalized to lowercase words. A trie over every word-initial suffix of every term answers
+// prefix queries such as "kais" for "Gail Kaiser": each trie node keeps the best few terms below
+// it, shortest first, so a lookup doesn't walk the subtree. Word trigrams of instructors and
+// locations answer fuzzy queries such as "dolen" for "Dolan", probing only the rarest of the
+// query's trigrams that any match must share. Terms are only ever added; a term that no course
+// holds any more is skipped by whoever expands the matches into courses. Searches take a shared
+// lock and additions an exclusive one.
+class SearchIndex {
+public:
+    SearchIndex();
+
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+    void addCourse(uint32_t course, std::string_view code);
+    void addName(SearchField field, InternedString name);
+    std::vector<SearchMatch> search(std::string_view query, size_t limit) const;
+    size_t size() const;
+
+    static std::string normalize(std::string_view text);
+
+private:
+    static constexpr size_t kTopTerms = 32;
+
+    struct Term {
+        SearchField field;
+        InternedString name;
+        uint32_t course;
+        std::string text;
+        std::string normalized;
+        std::vector<uint32_t> trigrams;  // Sorted and unique.
+    };
+
+    struct Node {
+        std::vector<std::pair<char, uint32_t>> children;  // Sorted by character.
+        std::vector<uint32_t> top;  // The best terms at or below this node, best first.
+    };
+
+    void addTerm(Term term);
+    void insertSuffix(std::string_view suffix, uint32_t term);
+    bool ranksBefore(uint32_t lhs, uint32_t rhs) const;
+    const Node* findNode(std::string_view prefix) const;
+    double prefixScore(std::string_view query, const Term& term) const;
+
+    static std::vector<uint32_t> trigramsOf(std::string_view normalized);
+
+    mutable std::shared_mutex mutex;
+    std::vector<Term> terms;
+    std::vector<Node> nodes;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigramTerms;
+    std::unordered_set<uint64_t> names;
+};
+
+#endif
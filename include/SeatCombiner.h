@@ -0,0 +1,47 @@
+// Copyright 2024 Jason Han
+#ifndef SEATCOMBINER_H
+#define SEATCOMBINER_H
+
+#include "Course.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Flat combining for seat changes on hot courses. A change is first tried as one
+// compare-and-swap on the course's seat count; a thread that loses that race to another thread
+// publishes its change in a slot instead. Whichever waiting thread takes the combiner lock
+// applies every published change, grouped by course, with one compare-and-swap per course (see
+// Course::changeSeats()), and hands each caller its own outcome. Under contention a hot course
+// then takes one atomic update per batch instead of one per request plus the failed retries.
+//
+// Callers must keep the courses they pass alive until apply() returns, for instance by holding
+// an epoch guard, since another thread may be applying their change.
+class SeatCombiner {
+public:
+    SeatCombiner();
+
+    SeatCombiner(const SeatCombiner&) = delete;
+    SeatCombiner& operator=(const SeatCombiner&) = delete;
+
+    SeatChange apply(Course& course, int delta);
+
+    static constexpr size_t kSlotCount = 64;
+
+private:
+    enum SlotState : uint32_t { kFree, kClaimed, kPending, kDone };
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> state{kFree};
+        Course* course = nullptr;
+        int delta = 0;
+        SeatChange result = SeatChange::Applied;
+    };
+
+    Slot* claimSlot();
+    void combine();
+
+    Slot slots[kSlotCount];
+    alignas(64) std::atomic<bool> combining;
+};
+
+#endif
@@ -0,0 +1,34 @@
+// Copyright 2024 Jason Han
+#ifndef STRIPEDMUTEX_H
+#define STRIPEDMUTEX_H
+
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+
+// A fixed set of mutexes that keys are hashed onto, so holders of different keys rarely contend
+// while the memory used stays constant however many keys there are. Each stripe sits on a cache
+// line of its own. lock() and unlock() take and release every stripe, in a fixed order, so the
+// whole set can be held through std::lock_guard to exclude all holders of any key at once.
+class StripedMutex {
+public:
+    StripedMutex();
+
+    StripedMutex(const StripedMutex&) = delete;
+    StripedMutex& operator=(const StripedMutex&) = delete;
+
+    std::mutex& stripeFor(std::string_view key);
+    void lock();
+    void unlock();
+
+    static constexpr size_t kStripeCount = 64;
+
+private:
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+    };
+
+    Stripe stripes[kStripeCount];
+};
+
+#endif
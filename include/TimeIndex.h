@@ -0,0 +1,34 @@
+// Copyright 2024 Jason Han
+#ifndef TIMEINDEX_H
+#define TIMEINDEX_H
+
+#include "TimeRange.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Immutable interval tree over the time ranges of a set of courses. The ranges are sorted by
+// start time and the tree is implicit in the sorted array: each subrange's middle entry is its
+// root and records the latest end time below it, so a query skips every subtree that ends before
+// the queried range starts or starts after it ends.
+class TimeIndex {
+public:
+    explicit TimeIndex(std::vector<std::pair<TimeRange, uint32_t>> courses);
+
+    size_t size() const;
+    std::vector<uint32_t> findOverlapping(TimeRange range) const;
+
+private:
+    uint16_t build(size_t first, size_t last);
+    void collect(size_t first,
+                 size_t last,
+                 TimeRange range,
+                 std::vector<uint32_t>& matches) const;
+
+    std::vector<std::pair<TimeRange, uint32_t>> entries;
+    std::vector<uint16_t> maxEnd;
+    size_t idLimit;  // One more than the largest ID.
+};
+
+#endif
@@ -0,0 +1,29 @@
+// Copyright 2024 Jason Han
+#ifndef TIMERANGE_H
+#define TIMERANGE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// The minutes of the day a course meets, as the half-open range [start, end), parsed from a time
+// slot such as "11:40-12:55".
+struct TimeRange {
+    uint16_t start;
+    uint16_t end;
+
+    static std::optional<TimeRange> parse(std::string_view timeSlot);
+
+    bool overlaps(TimeRange other) const {
+        return start < other.end && other.start < end;
+    }
+
+    bool operator==(TimeRange rhs) const {
+        return start == rhs.start && end == rhs.end;
+    }
+
+    std::string display() const;
+};
+
+#endif
@@ -0,0 +1,115 @@
+// Copyright 2024 Jason Han
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class WalRecordType : uint8_t {
+    SetEnrollmentCount = 1,
+    SetCourseLocation = 2,
+    SetCourseInstructor = 3,
+    SetCourseTime = 4,
+    SetNumberOfMajors = 5,
+};
+
+// How long a caller waits for its mutation to reach the disk.
+//   Sync:  until the group commit containing the record has been fsynced.
+//   Async: not at all; the record is fsynced with the next group commit.
+//   None:  the record isn't logged; the change reaches the disk at the next checkpoint.
+// The change itself is applied before its record is logged. If the commit fails, a Sync caller
+// is told so, but the change stays applied and its record is retried with later commits.
+enum class Durability { Sync, Async, None };
+
+struct WalRecord {
+    WalRecordType type;
+    std::string deptCode;
+    std::string courseCode;
+    int32_t intValue = 0;
+    std::string stringValue;
+
+    bool operator==(const WalRecord& rhs) const;
+};
+
+struct WalStats {
+    uint64_t batches = 0;
+    uint64_t records = 0;
+    uint64_t lastBatchSize = 0;
+    uint64_t maxBatchSize = 0;
+    uint64_t lastCommitLatencyMicros = 0;
+    uint64_t maxCommitLatencyMicros = 0;
+    uint64_t totalCommitLatencyMicros = 0;
+
+    std::string display() const;
+};
+
+class WriteAheadLog {
+public:
+    explicit WriteAheadLog(const std::string& path);
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    uint64_t enqueue(const WalRecord& record);
+    uint64_t enqueue(const std::function<WalRecord()>& makeRecord);
+    void waitForDurable(uint64_t lsn);
+    void append(const WalRecord& record);
+    void flush();
+
+    std::vector<WalRecord> recover();
+    void truncate();
+    void rotate();
+    void discardRotated();
+
+    void setGroupCommitWindow(std::chrono::microseconds window);
+    WalStats getStats() const;
+    const std::string& getPath() const;
+
+    static std::string encode(const WalRecord& record);
+    static std::optional<Durability> parseDurability(const std::string& name);
+
+private:
+    void openForAppend();
+    void recoverFile(const std::string& file, std::vector<WalRecord>& records);
+    void runFlusher();
+    void writeAll(const std::string& data);
+
+    std::string path;
+    std::string rotatedPath;
+    int fd;
+    // Size of the log file up to the end of the last committed batch, known once the file is
+    // open. A batch that fails partway is cut back to it. Guarded by ioMutex.
+    std::optional<uint64_t> committedSize;
+
+    // Guards everything below. ioMutex is held by whoever is writing to or truncating the file,
+    // so a truncation can never interleave with a batch that is being written.
+    mutable std::mutex mutex;
+    std::mutex ioMutex;
+    std::condition_variable pendingCondition;
+    std::condition_variable durableCondition;
+    std::string pending;
+    uint64_t pendingRecords;
+    std::chrono::steady_clock::time_point oldestPending;
+    uint64_t nextLsn;
+    uint64_t durableLsn;
+    std::chrono::microseconds groupCommitWindow;
+    // Error of the last failed commit, which held every record up to failedLsn that isn't
+    // durable yet. Cleared once a retry commits them.
+    std::exception_ptr flushError;
+    uint64_t failedLsn;
+    std::chrono::steady_clock::time_point retryAt;
+    WalStats stats;
+    bool stopping;
+    std::thread flusher;
+};
+
+#endif
@@ -0,0 +1,69 @@
+// Copyright 2024 Jason Han
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+constexpr size_t kMaxSlabBytes = 1 << 20;
+
+}  // namespace
+
+/**
+ * Constructs an empty arena. No memory is allocated until the first allocation.
+ *
+ * @param firstSlabBytes     The size of the first slab; each later slab is twice as large, up to
+ *                           a megabyte.
+ */
+Arena::Arena(size_t firstSlabBytes)
+    : nextSlabBytes(std::max<size_t>(firstSlabBytes, 64)),
+      cursor(nullptr),
+      end(nullptr),
+      bytesAllocated(0) {}
+
+/**
+ * Allocates memory from the current slab, starting a new slab when it doesn't fit. Allocations
+ * larger than a slab get a slab of their own.
+ *
+ * @param bytes              The number of bytes to allocate.
+ * @param alignment          The required alignment, a power of two.
+ * @return The allocated memory.
+ */
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    auto address = reinterpret_cast<uintptr_t>(cursor);
+    size_t padding = (alignment - address % alignment) % alignment;
+    if (!cursor || padding + bytes > static_cast<size_t>(end - cursor)) {
+        // new[] only aligns to alignof(std::max_align_t), so the slab leaves room to pad up to
+        // larger alignments, such as the cache line a Course is aligned to.
+        size_t slabBytes = std::max(nextSlabBytes, bytes + alignment);
+        slabs.emplace_back(new char[slabBytes]);
+        cursor = slabs.back().get();
+        end = cursor + slabBytes;
+        nextSlabBytes = std::min(nextSlabBytes * 2, kMaxSlabBytes);
+        address = reinterpret_cast<uintptr_t>(cursor);
+        padding = (alignment - address % alignment) % alignment;
+    }
+    char* result = cursor + padding;
+    cursor = result + bytes;
+    bytesAllocated += bytes;
+    return result;
+}
+
+/**
+ * Returns the number of bytes handed out so far, not counting alignment padding or the unused
+ * tail of each slab.
+ *
+ * @return The number of bytes allocated.
+ */
+size_t Arena::getBytesAllocated() const {
+    return bytesAllocated;
+}
+
+/**
+ * Returns the number of slabs allocated so far.
+ *
+ * @return The number of slabs.
+ */
+size_t Arena::getSlabCount() const {
+    return slabs.size();
+}
@@ -0,0 +1,163 @@
+// Copyright 2024 Jason Han
+#include "ByteReader.h"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * Constructs a reader over a buffer. The buffer must outlive the reader.
+ *
+ * @param data               The bytes to parse.
+ * @param source             What the bytes are, for error messages (e.g. a file path).
+ */
+ByteReader::ByteReader(std::string_view data, std::string source)
+    : data(data), position(0), source(std::move(source)) {}
+
+/**
+ * Reads an unsigned 8-bit integer.
+ *
+ * @return The value.
+ */
+uint8_t ByteReader::readU8() {
+    return static_cast<uint8_t>(readBytes(1)[0]);
+}
+
+/**
+ * Reads an unsigned 16-bit integer in host byte order.
+ *
+ * @return The value.
+ */
+uint16_t ByteReader::readU16() {
+    uint16_t value;
+    std::memcpy(&value, readBytes(sizeof(value)).data(), sizeof(value));
+    return value;
+}
+
+/**
+ * Reads an unsigned 32-bit integer in host byte order.
+ *
+ * @return The value.
+ */
+uint32_t ByteReader::readU32() {
+    uint32_t value;
+    std::memcpy(&value, readBytes(sizeof(value)).data(), sizeof(value));
+    return value;
+}
+
+/**
+ * Reads an unsigned 64-bit integer in host byte order.
+ *
+ * @return The value.
+ */
+uint64_t ByteReader::readU64() {
+    uint64_t value;
+    std::memcpy(&value, readBytes(sizeof(value)).data(), sizeof(value));
+    return value;
+}
+
+/**
+ * Reads a signed 32-bit integer in host byte order.
+ *
+ * @return The value.
+ */
+int32_t ByteReader::readI32() {
+    int32_t value;
+    std::memcpy(&value, readBytes(sizeof(value)).data(), sizeof(value));
+    return value;
+}
+
+/**
+ * Reads an unsigned LEB128 varint of at most 64 bits.
+ *
+ * @return The value.
+ */
+uint64_t ByteReader::readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = readU8();
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    fail("malformed varint");
+}
+
+/**
+ * Reads a zigzag-encoded varint that must fit in a signed 32-bit integer.
+ *
+ * @return The value.
+ */
+int32_t ByteReader::readSignedVarint32() {
+    uint64_t encoded = readVarint();
+    int64_t value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+    if (value < std::numeric_limits<int32_t>::min() ||
+        value > std::numeric_limits<int32_t>::max()) {
+        fail("integer out of range");
+    }
+    return static_cast<int32_t>(value);
+}
+
+/**
+ * Reads raw bytes without copying them.
+ *
+ * @param length             The number of bytes.
+ * @return The bytes, pointing into the buffer.
+ */
+std::string_view ByteReader::readBytes(uint64_t length) {
+    if (length > remaining()) {
+        fail("needs " + std::to_string(length) + " bytes but only " +
+             std::to_string(remaining()) + " remain");
+    }
+    std::string_view bytes = data.substr(position, length);
+    position += length;
+    return bytes;
+}
+
+/**
+ * Reads a string of the given length. The length is checked before anything is allocated.
+ *
+ * @param length             The length of the string.
+ * @return The string.
+ */
+std::string ByteReader::readString(uint64_t length) {
+    return std::string(readBytes(length));
+}
+
+/**
+ * Returns the number of bytes left to read.
+ *
+ * @return The number of bytes.
+ */
+size_t ByteReader::remaining() const {
+    return data.length() - position;
+}
+
+/**
+ * Returns the offset of the next byte to read.
+ *
+ * @return The offset.
+ */
+size_t ByteReader::offset() const {
+    return position;
+}
+
+/**
+ * Throws unless every byte has been read.
+ */
+void ByteReader::expectEnd() const {
+    if (remaining() != 0) {
+        fail(std::to_string(remaining()) + " unexpected trailing bytes");
+    }
+}
+
+/**
+ * Throws a std::runtime_error describing a problem at the current offset.
+ *
+ * @param reason             What is wrong.
+ */
+void ByteReader::fail(const std::string& reason) const {
+    throw std::runtime_error(source + " is corrupt at offset " + std::to_string(position) + ": " +
+                             reason);
+}
@@ -0,0 +1,786 @@
+// Copyright 2024 Jason Han
+#include "CatalogImporter.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum class Field {
+    Department,
+    Chair,
+    Majors,
+    Course,
+    Instructor,
+    Location,
+    Time,
+    Capacity,
+    Enrolled,
+};
+
+constexpr size_t kFieldCount = 9;
+constexpr const char* kFieldNames[kFieldCount] = {
+    "department", "chair", "majors", "course", "instructor", "location", "time", "capacity",
+    "enrolled"};
+
+using FieldValues = std::array<std::optional<std::string>, kFieldCount>;
+
+struct ImportRecord {
+    std::string deptCode;
+    std::optional<std::string> chair;
+    std::optional<int> majors;
+    std::string courseId;
+    std::shared_ptr<Course> course;
+};
+
+struct Chunk {
+    size_t index;
+    uint64_t firstLine;
+    std::string text;
+};
+
+struct ParsedChunk {
+    std::vector<ImportRecord> records;
+    std::exception_ptr error;
+};
+
+struct DepartmentDraft {
+    std::string chair;
+    int majors = 0;
+    std::map<std::string, std::shared_ptr<Course>> courses;
+};
+
+[[noreturn]] void fail(const std::string& source, uint64_t line, const std::string& reason) {
+    throw std::runtime_error(source + ":" + std::to_string(line) + ": " + reason);
+}
+
+std::optional<Field> fieldForName(std::string_view name) {
+    for (size_t i = 0; i < kFieldCount; ++i) {
+        if (name == kFieldNames[i]) {
+            return static_cast<Field>(i);
+        }
+    }
+    // Header rows from spreadsheets often capitalize or pad the names.
+    std::string lower;
+    for (char c : name) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    for (size_t i = 0; i < kFieldCount; ++i) {
+        if (lower == kFieldNames[i]) {
+            return static_cast<Field>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string>& valueOf(FieldValues& values, Field field) {
+    return values[static_cast<size_t>(field)];
+}
+
+int parseInt(const std::string& text, Field field, const std::string& source, uint64_t line) {
+    int value = 0;
+    const char* end = text.data() + text.length();
+    auto result = std::from_chars(text.data(), end, value);
+    if (text.empty() || result.ec != std::errc() || result.ptr != end) {
+        fail(source,
+             line,
+             std::string(kFieldNames[static_cast<size_t>(field)]) + " is not an integer: '" +
+                 text + "'");
+    }
+    return value;
+}
+
+/**
+ * Turns the values of one record into an ImportRecord, building its Course if it has one. The
+ * values are moved from.
+ */
+ImportRecord makeRecord(FieldValues& values, const std::string& source, uint64_t line) {
+    ImportRecord record;
+    std::optional<std::string>& deptCode = valueOf(values, Field::Department);
+    if (!deptCode || deptCode->empty()) {
+        fail(source, line, "record has no department");
+    }
+    record.deptCode = std::move(*deptCode);
+    record.chair = std::move(valueOf(values, Field::Chair));
+    if (const auto& majors = valueOf(values, Field::Majors)) {
+        record.majors = parseInt(*majors, Field::Majors, source, line);
+    }
+
+    std::optional<std::string>& courseId = valueOf(values, Field::Course);
+    if (!courseId || courseId->empty()) {
+        return record;
+    }
+    record.courseId = std::move(*courseId);
+    const std::optional<std::string>& capacity = valueOf(values, Field::Capacity);
+    if (!capacity) {
+        fail(source, line, "course " + record.courseId + " has no capacity");
+    }
+    record.course =
+        std::make_shared<Course>(parseInt(*capacity, Field::Capacity, source, line),
+                                 valueOf(values, Field::Instructor).value_or(""),
+                                 valueOf(values, Field::Location).value_or(""),
+                                 valueOf(values, Field::Time).value_or(""));
+    if (const auto& enrolled = valueOf(values, Field::Enrolled)) {
+        record.course->setEnrolledStudentCount(
+            parseInt(*enrolled, Field::Enrolled, source, line));
+    }
+    return record;
+}
+
+/**
+ * Parses the CSV record that starts at pos into fields, following RFC 4180: quoted fields may
+ * hold commas, line breaks and doubled quotes. Advances pos past the record's line break and line
+ * by every line break consumed.
+ *
+ * @return false if there is no record left.
+ */
+bool readCsvRecord(std::string_view text,
+                   size_t& pos,
+                   uint64_t& line,
+                   std::vector<std::string>& fields,
+                   const std::string& source) {
+    if (pos >= text.length()) {
+        return false;
+    }
+    fields.clear();
+    uint64_t recordLine = line;
+    while (true) {
+        std::string field;
+        if (pos < text.length() && text[pos] == '"') {
+            ++pos;
+            while (true) {
+                size_t quote = text.find('"', pos);
+                if (quote == std::string_view::npos) {
+                    fail(source, recordLine, "unterminated quoted field");
+                }
+                std::string_view part = text.substr(pos, quote - pos);
+                line += static_cast<uint64_t>(std::count(part.begin(), part.end(), '\n'));
+                field += part;
+                pos = quote + 1;
+                if (pos < text.length() && text[pos] == '"') {
+                    field += '"';
+                    ++pos;
+                    continue;
+                }
+                break;
+            }
+            if (pos + 1 < text.length() && text[pos] == '\r' && text[pos + 1] == '\n') {
+                ++pos;
+            }
+            if (pos < text.length() && text[pos] != ',' && text[pos] != '\n') {
+                fail(source, line, "unexpected character after a quoted field");
+            }
+        } else {
+            size_t end = std::min(text.find_first_of(",\n", pos), text.length());
+            field.assign(text.substr(pos, end - pos));
+            pos = end;
+            if (!field.empty() && field.back() == '\r' &&
+                (pos == text.length() || text[pos] == '\n')) {
+                field.pop_back();
+            }
+        }
+        fields.push_back(std::move(field));
+        if (pos >= text.length()) {
+            return true;
+        }
+        if (text[pos++] == '\n') {
+            ++line;
+            return true;
+        }
+    }
+}
+
+/**
+ * Parses one line of JSON Lines: a flat object whose values are strings, numbers or null. Nested
+ * objects and arrays are rejected; keys that don't name a column are skipped.
+ */
+class JsonObjectParser {
+public:
+    JsonObjectParser(std::string_view text, const std::string& source, uint64_t line)
+        : text(text), pos(0), source(source), line(line) {}
+
+    void parse(FieldValues& values) {
+        skipSpace();
+        expect('{');
+        skipSpace();
+        if (peek() == '}') {
+            ++pos;
+        } else {
+            while (true) {
+                skipSpace();
+                std::string key = parseString();
+                skipSpace();
+                expect(':');
+                skipSpace();
+                std::optional<std::string> value = parseValue();
+                if (std::optional<Field> field = fieldForName(key)) {
+                    valueOf(values, *field) = std::move(value);
+                }
+                skipSpace();
+                if (peek() == ',') {
+                    ++pos;
+                    continue;
+                }
+                expect('}');
+                break;
+            }
+        }
+        skipSpace();
+        if (pos != text.length()) {
+            fail(source, line, "unexpected characters after the object");
+        }
+    }
+
+private:
+    char peek() const {
+        return pos < text.length() ? text[pos] : '\0';
+    }
+
+    void skipSpace() {
+        while (pos < text.length() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+    }
+
+    void expect(char c) {
+        if (peek() != c) {
+            std::string expected(1, c);
+            fail(source, line, "expected '" + expected + "' at column " + std::to_string(pos + 1));
+        }
+        ++pos;
+    }
+
+    std::optional<std::string> parseValue() {
+        char c = peek();
+        if (c == '"') {
+            return parseString();
+        }
+        if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+            size_t start = pos;
+            while (pos < text.length() &&
+                   (std::isdigit(static_cast<unsigned char>(text[pos])) ||
+                    std::string_view("+-.eE").find(text[pos]) != std::string_view::npos)) {
+                ++pos;
+            }
+            return std::string(text.substr(start, pos - start));
+        }
+        if (text.substr(pos, 4) == "null") {
+            pos += 4;
+            return std::nullopt;
+        }
+        if (c == '{' || c == '[') {
+            fail(source, line, "nested values are not supported");
+        }
+        fail(source, line, "unsupported value at column " + std::to_string(pos + 1));
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        while (true) {
+            if (pos >= text.length()) {
+                fail(source, line, "unterminated string");
+            }
+            char c = text[pos++];
+            if (c == '"') {
+                return out;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                fail(source, line, "control character in string");
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            char escape = peek();
+            ++pos;
+            switch (escape) {
+            case '"':
+            case '\\':
+            case '/':
+                out += escape;
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u':
+                appendCodePoint(out, parseCodePoint());
+                break;
+            default:
+                fail(source, line, "invalid escape in string");
+            }
+        }
+    }
+
+    uint32_t parseHex4() {
+        uint32_t value = 0;
+        if (text.length() - pos < 4 ||
+            std::from_chars(text.data() + pos, text.data() + pos + 4, value, 16).ptr !=
+                text.data() + pos + 4) {
+            fail(source, line, "invalid \\u escape");
+        }
+        pos += 4;
+        return value;
+    }
+
+    uint32_t parseCodePoint() {
+        uint32_t code = parseHex4();
+        if (code >= 0xdc00 && code <= 0xdfff) {
+            fail(source, line, "unpaired surrogate in \\u escape");
+        }
+        if (code >= 0xd800 && code <= 0xdbff) {
+            if (text.substr(pos, 2) != "\\u") {
+                fail(source, line, "unpaired surrogate in \\u escape");
+            }
+            pos += 2;
+            uint32_t low = parseHex4();
+            if (low < 0xdc00 || low > 0xdfff) {
+                fail(source, line, "unpaired surrogate in \\u escape");
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        }
+        return code;
+    }
+
+    static void appendCodePoint(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xc0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xe0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        } else {
+            out += static_cast<char>(0xf0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+
+    std::string_view text;
+    size_t pos;
+    const std::string& source;
+    uint64_t line;
+};
+
+/**
+ * Parses every record of a chunk.
+ *
+ * @param format             The input format.
+ * @param chunk              The chunk, which starts and ends on record boundaries.
+ * @param columns            The field of each CSV column, or std::nullopt for ignored columns.
+ * @param source             The name of the input, for error messages.
+ * @return The records, in input order.
+ */
+std::vector<ImportRecord> parseChunk(ImportFormat format,
+                                     const Chunk& chunk,
+                                     const std::vector<std::optional<Field>>& columns,
+                                     const std::string& source) {
+    std::vector<ImportRecord> records;
+    FieldValues values;
+    std::string_view text = chunk.text;
+    size_t pos = 0;
+    uint64_t line = chunk.firstLine;
+    if (format == ImportFormat::Csv) {
+        std::vector<std::string> fields;
+        uint64_t recordLine = line;
+        while (readCsvRecord(text, pos, line, fields, source)) {
+            if (fields.size() == 1 && fields[0].empty()) {
+                recordLine = line;
+                continue;
+            }
+            if (fields.size() > columns.size()) {
+                fail(source, recordLine, "record has more fields than the header");
+            }
+            values.fill(std::nullopt);
+            for (size_t i = 0; i < fields.size(); ++i) {
+                if (columns[i] && !fields[i].empty()) {
+                    valueOf(values, *columns[i]) = std::move(fields[i]);
+                }
+            }
+            records.push_back(makeRecord(values, source, recordLine));
+            recordLine = line;
+        }
+        return records;
+    }
+
+    while (pos < text.length()) {
+        size_t end = std::min(text.find('\n', pos), text.length());
+        std::string_view row = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (row.find_first_not_of(" \t\r") != std::string_view::npos) {
+            values.fill(std::nullopt);
+            JsonObjectParser(row, source, line).parse(values);
+            records.push_back(makeRecord(values, source, line));
+        }
+        ++line;
+    }
+    return records;
+}
+
+/**
+ * Cuts an input stream into chunks of about chunkSize bytes that end on record boundaries. A CSV
+ * line break only ends a record outside quotes; each chunk starts outside quotes, so the quote
+ * state can be tracked from the start of the chunk.
+ */
+class ChunkReader {
+public:
+    ChunkReader(std::istream& in, ImportFormat format, size_t chunkSize)
+        : in(in), format(format), chunkSize(chunkSize), line(1), bytes(0), atEnd(false) {}
+
+    bool next(std::string& chunk, uint64_t& firstLine) {
+        chunk.swap(carry);
+        carry.clear();
+        size_t scanned = 0;
+        bool inQuotes = false;
+        size_t split = std::string::npos;
+        while (!atEnd) {
+            size_t offset = chunk.length();
+            chunk.resize(offset + chunkSize);
+            in.read(&chunk[offset], static_cast<std::streamsize>(chunkSize));
+            size_t count = static_cast<size_t>(in.gcount());
+            chunk.resize(offset + count);
+            bytes += count;
+            atEnd = count < chunkSize;
+            if (format == ImportFormat::Csv) {
+                for (size_t i = scanned; i < chunk.length(); ++i) {
+                    if (chunk[i] == '"') {
+                        inQuotes = !inQuotes;
+                    } else if (chunk[i] == '\n' && !inQuotes) {
+                        split = i + 1;
+                    }
+                }
+            } else if (size_t newline = chunk.rfind('\n'); newline != std::string::npos) {
+                split = newline + 1;
+            }
+            scanned = chunk.length();
+            if (split != std::string::npos) {
+                break;
+            }
+        }
+        if (atEnd) {
+            split = chunk.length();
+        }
+        carry.assign(chunk, split, std::string::npos);
+        chunk.resize(split);
+        firstLine = line;
+        line += static_cast<uint64_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+        return !chunk.empty();
+    }
+
+    uint64_t bytesRead() const {
+        return bytes;
+    }
+
+private:
+    std::istream& in;
+    ImportFormat format;
+    size_t chunkSize;
+    std::string carry;
+    uint64_t line;
+    uint64_t bytes;
+    bool atEnd;
+};
+
+}  // namespace
+
+/**
+ * Returns the import statistics as a human-readable string.
+ *
+ * @return The display string.
+ */
+std::string ImportStats::display() const {
+    std::ostringstream result;
+    result << "importBytes: " << bytes << "\n";
+    result << "importRecords: " << records << "\n";
+    result << "importChunks: " << chunks << "\n";
+    result << "importDepartments: " << departments << "\n";
+    result << "importCourses: " << courses << "\n";
+    result << "importParseMicros: " << parseMicros << "\n";
+    result << "importSnapshotMicros: " << snapshotMicros << "\n";
+    return result.str();
+}
+
+/**
+ * Constructs an importer for the given format. Parsing uses one thread per core and 1 MiB
+ * chunks by default.
+ *
+ * @param format             The input format.
+ */
+CatalogImporter::CatalogImporter(ImportFormat format)
+    : format(format),
+      threadCount(std::max(1u, std::thread::hardware_concurrency())),
+      chunkSize(1 << 20) {}
+
+/**
+ * Sets how many threads parse chunks. With one thread, chunks are parsed on the calling thread.
+ *
+ * @param threadCount        The number of parsing threads.
+ */
+void CatalogImporter::setThreadCount(size_t threadCount) {
+    this->threadCount = std::max<size_t>(1, threadCount);
+}
+
+/**
+ * Sets how many bytes are read per chunk. At most two chunks per thread are in flight at once,
+ * which bounds the memory used for input regardless of the input size.
+ *
+ * @param chunkSize          The chunk size in bytes.
+ */
+void CatalogImporter::setChunkSize(size_t chunkSize) {
+    this->chunkSize = std::max<size_t>(1, chunkSize);
+}
+
+/**
+ * Returns the statistics of the last import.
+ *
+ * @return The statistics.
+ */
+ImportStats CatalogImporter::getStats() const {
+    return stats;
+}
+
+/**
+ * Picks the import format from a file extension: .csv for CSV, .jsonl or .ndjson for JSON Lines.
+ *
+ * @param path               The path to the input file.
+ * @return The format, or std::nullopt if the extension isn't recognized.
+ */
+std::optional<ImportFormat> CatalogImporter::formatForPath(const std::string& path) {
+    auto endsWith = [&](std::string_view suffix) {
+        return path.length() >= suffix.length() &&
+               path.compare(path.length() - suffix.length(), suffix.length(), suffix) == 0;
+    };
+    if (endsWith(".csv")) {
+        return ImportFormat::Csv;
+    }
+    if (endsWith(".jsonl") || endsWith(".ndjson")) {
+        return ImportFormat::JsonLines;
+    }
+    return std::nullopt;
+}
+
+/**
+ * Reads a catalog export and builds the department mapping. The calling thread reads the input
+ * in chunks that end on record boundaries and hands them to the parsing threads, which build the
+ * Course objects; parsed chunks are merged back in input order, so the result doesn't depend on
+ * the thread count. Reading stalls while too many chunks are in flight, so memory use stays
+ * bounded by the chunk size, the thread count and the catalog itself.
+ *
+ * @param in                 The input stream.
+ * @param source             The name of the input, for error messages.
+ * @return The department mapping.
+ */
+std::map<std::string, Department> CatalogImporter::parse(std::istream& in,
+                                                         const std::string& source) {
+    auto start = std::chrono::steady_clock::now();
+    stats = ImportStats();
+    ChunkReader reader(in, format, chunkSize);
+    std::map<std::string, DepartmentDraft> drafts;
+    auto merge = [&](std::vector<ImportRecord>& records) {
+        for (ImportRecord& record : records) {
+            DepartmentDraft& draft = drafts[record.deptCode];
+            if (record.chair) {
+                draft.chair = std::move(*record.chair);
+            }
+            if (record.majors) {
+                draft.majors = *record.majors;
+            }
+            if (record.course) {
+                draft.courses[record.courseId] = std::move(record.course);
+            }
+        }
+        stats.records += records.size();
+        stats.chunks++;
+    };
+
+    Chunk chunk{0, 1, ""};
+    bool haveChunk = reader.next(chunk.text, chunk.firstLine);
+    if (haveChunk && chunk.text.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+        chunk.text.erase(0, 3);
+    }
+    std::vector<std::optional<Field>> columns;
+    if (haveChunk && format == ImportFormat::Csv) {
+        std::vector<std::string> header;
+        size_t pos = 0;
+        readCsvRecord(chunk.text, pos, chunk.firstLine, header, source);
+        for (const std::string& name : header) {
+            columns.push_back(fieldForName(name));
+        }
+        if (std::find(columns.begin(), columns.end(), Field::Department) == columns.end()) {
+            fail(source, 1, "header has no department column");
+        }
+        chunk.text.erase(0, pos);
+    }
+
+    if (threadCount <= 1) {
+        while (haveChunk) {
+            std::vector<ImportRecord> records = parseChunk(format, chunk, columns, source);
+            merge(records);
+            haveChunk = reader.next(chunk.text, chunk.firstLine);
+        }
+    } else {
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable chunkParsed;
+        std::deque<Chunk> work;
+        std::map<size_t, ParsedChunk> parsed;
+        bool closed = false;
+
+        std::vector<std::thread> workers;
+        auto stopWorkers = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+                work.clear();
+            }
+            workAvailable.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            workers.clear();
+        };
+        for (size_t t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&]() {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    workAvailable.wait(lock, [&] { return closed || !work.empty(); });
+                    if (work.empty()) {
+                        return;
+                    }
+                    Chunk next = std::move(work.front());
+                    work.pop_front();
+                    lock.unlock();
+                    ParsedChunk result;
+                    try {
+                        result.records = parseChunk(format, next, columns, source);
+                    } catch (...) {
+                        result.error = std::current_exception();
+                    }
+                    lock.lock();
+                    parsed.emplace(next.index, std::move(result));
+                    chunkParsed.notify_all();
+                }
+            });
+        }
+
+        size_t nextIndex = 0;
+        size_t nextToMerge = 0;
+        size_t maxInFlight = 2 * threadCount;
+        // Merges parsed chunks in input order, waiting for the next one while more than
+        // maxInFlight chunks are outstanding. Called with the lock held; merges without it.
+        auto mergeParsed = [&](std::unique_lock<std::mutex>& lock, size_t maxOutstanding) {
+            while (nextToMerge < nextIndex) {
+                auto it = parsed.find(nextToMerge);
+                if (it == parsed.end()) {
+                    if (nextIndex - nextToMerge <= maxOutstanding) {
+                        return;
+                    }
+                    chunkParsed.wait(lock, [&] { return parsed.count(nextToMerge) > 0; });
+                    it = parsed.find(nextToMerge);
+                }
+                ParsedChunk result = std::move(it->second);
+                parsed.erase(it);
+                nextToMerge++;
+                lock.unlock();
+                if (result.error) {
+                    std::rethrow_exception(result.error);
+                }
+                merge(result.records);
+                lock.lock();
+            }
+        };
+
+        try {
+            while (haveChunk) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    mergeParsed(lock, maxInFlight - 1);
+                    chunk.index = nextIndex++;
+                    work.push_back(std::move(chunk));
+                }
+                workAvailable.notify_one();
+                chunk = Chunk{0, 1, ""};
+                haveChunk = reader.next(chunk.text, chunk.firstLine);
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            mergeParsed(lock, 0);
+        } catch (...) {
+            stopWorkers();
+            throw;
+        }
+        stopWorkers();
+    }
+
+    std::map<std::string, Department> mapping;
+    for (auto& [deptCode, draft] : drafts) {
+        stats.courses += draft.courses.size();
+        mapping.emplace_hint(
+            mapping.end(),
+            deptCode,
+            Department(deptCode, std::move(draft.courses), std::move(draft.chair), draft.majors));
+    }
+    stats.departments = mapping.size();
+    stats.bytes = reader.bytesRead();
+    stats.parseMicros =
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count());
+    return mapping;
+}
+
+/**
+ * Imports a catalog export into the database, replacing its contents, and checkpoints it so the
+ * snapshot on disk holds the imported catalog.
+ *
+ * @param path               The path to the export.
+ * @param database           The database to import into.
+ * @return The import statistics.
+ */
+ImportStats CatalogImporter::importFile(const std::string& path, MyFileDatabase& database) {
+    std::ifstream inFile(path, std::ios::binary);
+    if (!inFile) {
+        throw std::runtime_error("Failed to open catalog export " + path);
+    }
+    std::map<std::string, Department> mapping = parse(inFile, path);
+
+    auto start = std::chrono::steady_clock::now();
+    database.setMapping(std::move(mapping));
+    database.checkpoint();
+    stats.snapshotMicros =
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count());
+    return stats;
+}
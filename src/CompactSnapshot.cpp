@@ -0,0 +1,281 @@
+// Copyright 2024 Jason Han
+#include "CompactSnapshot.h"
+#include "ByteReader.h"
+#include "Crc32c.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'A', 'T', 'S', 'N', 'A', 'P', 'C'};
+constexpr uint64_t kVersion = 3;
+constexpr size_t kBlockSize = 256 * 1024;
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void putSigned(std::string& out, int64_t value) {
+    putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * Assigns each distinct string an index in order of first use.
+ */
+class Dictionary {
+public:
+    uint64_t add(const std::string& value) {
+        auto it = indices.find(value);
+        if (it != indices.end()) {
+            return it->second;
+        }
+        uint64_t index = strings.size();
+        strings.push_back(&indices.emplace(value, index).first->first);
+        return index;
+    }
+
+    void write(std::string& out) const {
+        putVarint(out, strings.size());
+        for (const std::string* value : strings) {
+            putVarint(out, value->length());
+            out += *value;
+        }
+    }
+
+private:
+    std::unordered_map<std::string, uint64_t> indices;
+    std::vector<const std::string*> strings;
+};
+
+uint64_t readIndex(const std::vector<std::string>& strings, ByteReader& reader) {
+    uint64_t index = reader.readVarint();
+    if (index >= strings.size()) {
+        reader.fail("string index " + std::to_string(index) + " out of range");
+    }
+    return index;
+}
+
+const std::string& lookup(const std::vector<std::string>& strings, ByteReader& reader) {
+    return strings[readIndex(strings, reader)];
+}
+
+}  // namespace
+
+/**
+ * Encodes the department mapping in the compact format.
+ *
+ * @param mapping            The department mapping to encode.
+ * @param compression        Whether to zlib-compress each block.
+ * @return The file contents.
+ */
+std::string CompactSnapshot::encode(const std::map<std::string, Department>& mapping,
+                                    CompactCompression compression) {
+    Dictionary dictionary;
+    std::string body;
+    putVarint(body, mapping.size());
+    for (const auto& [deptCode, dept] : mapping) {
+        const auto& courses = dept.getCourseSelection();
+        putVarint(body, dictionary.add(deptCode));
+        putVarint(body, dictionary.add(dept.getDepartmentChair()));
+        putSigned(body, dept.getNumberOfMajors());
+        putVarint(body, courses.size());
+        for (const auto& [courseId, course] : courses) {
+            putVarint(body, dictionary.add(courseId));
+            putVarint(body, dictionary.add(course->getCourseLocation()));
+            putVarint(body, dictionary.add(course->getInstructorName()));
+            putVarint(body, dictionary.add(course->getCourseTimeSlot()));
+            putSigned(body, course->getEnrollmentCapacity());
+            putSigned(body, course->getEnrolledStudentCount());
+        }
+    }
+    std::string payload;
+    dictionary.write(payload);
+    payload += body;
+
+    std::string out(kMagic, sizeof(kMagic));
+    putVarint(out, kVersion);
+    out.push_back(static_cast<char>(compression));
+    std::string compressed;
+    for (size_t offset = 0; offset < payload.length(); offset += kBlockSize) {
+        size_t rawLength = std::min(kBlockSize, payload.length() - offset);
+        putVarint(out, rawLength);
+        if (compression == CompactCompression::None) {
+            putVarint(out, rawLength);
+            putU32(out, crc32c(payload.data() + offset, rawLength));
+            out.append(payload, offset, rawLength);
+            continue;
+        }
+        uLongf storedLength = compressBound(rawLength);
+        compressed.resize(storedLength);
+        if (compress2(reinterpret_cast<Bytef*>(&compressed[0]),
+                      &storedLength,
+                      reinterpret_cast<const Bytef*>(payload.data() + offset),
+                      rawLength,
+                      Z_BEST_SPEED) != Z_OK) {
+            throw std::runtime_error("Failed to compress snapshot block");
+        }
+        putVarint(out, storedLength);
+        putU32(out, crc32c(compressed.data(), storedLength));
+        out.append(compressed, 0, storedLength);
+    }
+    putVarint(out, 0);
+    return out;
+}
+
+/**
+ * Decodes a department mapping from compact format bytes. Every block's checksum is verified
+ * before it is decompressed, and every length and index is checked against the data actually
+ * present, so a truncated or corrupt file fails with an exception.
+ *
+ * @param bytes              The file contents.
+ * @param mode               Where to allocate the courses.
+ * @return The department mapping.
+ */
+std::map<std::string, Department> CompactSnapshot::decode(const std::string& bytes,
+                                                          AllocationMode mode) {
+    if (bytes.length() < sizeof(kMagic) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic))) {
+        throw std::runtime_error("Not a compact snapshot");
+    }
+    ByteReader file(bytes, "Compact snapshot");
+    file.readBytes(sizeof(kMagic));
+    if (file.readVarint() != kVersion) {
+        throw std::runtime_error("Unsupported compact snapshot version");
+    }
+    auto compression = static_cast<CompactCompression>(file.readU8());
+    if (compression != CompactCompression::None && compression != CompactCompression::Zlib) {
+        throw std::runtime_error("Unsupported compact snapshot compression");
+    }
+
+    std::string payload;
+    while (uint64_t rawLength = file.readVarint()) {
+        uint64_t storedLength = file.readVarint();
+        uint32_t crc = file.readU32();
+        std::string_view stored = file.readBytes(storedLength);
+        if (rawLength > kBlockSize) {
+            file.fail("oversized block");
+        }
+        if (crc32c(stored.data(), stored.length()) != crc) {
+            file.fail("block checksum mismatch");
+        }
+        if (compression == CompactCompression::None) {
+            if (storedLength != rawLength) {
+                file.fail("block length mismatch");
+            }
+            payload += stored;
+            continue;
+        }
+        size_t offset = payload.length();
+        payload.resize(offset + rawLength);
+        uLongf decodedLength = rawLength;
+        if (uncompress(reinterpret_cast<Bytef*>(&payload[offset]),
+                       &decodedLength,
+                       reinterpret_cast<const Bytef*>(stored.data()),
+                       storedLength) != Z_OK ||
+            decodedLength != rawLength) {
+            file.fail("block does not decompress");
+        }
+    }
+    file.expectEnd();
+
+    ByteReader reader(payload, "Compact snapshot payload");
+    // Every entry takes at least one byte, which bounds the counts by the bytes that remain.
+    uint64_t stringCount = reader.readVarint();
+    if (stringCount > reader.remaining()) {
+        reader.fail("string count exceeds the remaining bytes");
+    }
+    std::vector<std::string> strings;
+    strings.reserve(stringCount);
+    for (uint64_t i = 0; i < stringCount; ++i) {
+        strings.push_back(reader.readString(reader.readVarint()));
+    }
+
+    // Course strings are interned once per dictionary entry rather than once per course.
+    std::vector<std::optional<InternedString>> interned(strings.size());
+    auto internedAt = [&](uint64_t index) {
+        if (!interned[index]) {
+            interned[index] = InternedString::intern(strings[index]);
+        }
+        return *interned[index];
+    };
+
+    std::shared_ptr<Arena> arena =
+        mode == AllocationMode::Arena ? std::make_shared<Arena>() : nullptr;
+    std::map<std::string, Department> mapping;
+    uint64_t departmentCount = reader.readVarint();
+    if (departmentCount > reader.remaining()) {
+        reader.fail("department count exceeds the remaining bytes");
+    }
+    for (uint64_t d = 0; d < departmentCount; ++d) {
+        const std::string& deptCode = lookup(strings, reader);
+        const std::string& chair = lookup(strings, reader);
+        int numberOfMajors = reader.readSignedVarint32();
+        uint64_t courseCount = reader.readVarint();
+        if (courseCount > reader.remaining()) {
+            reader.fail("course count exceeds the remaining bytes");
+        }
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (uint64_t c = 0; c < courseCount; ++c) {
+            const std::string& courseId = lookup(strings, reader);
+            InternedString location = internedAt(readIndex(strings, reader));
+            InternedString instructor = internedAt(readIndex(strings, reader));
+            InternedString timeSlot = internedAt(readIndex(strings, reader));
+            int capacity = reader.readSignedVarint32();
+            auto course =
+                arena ? arena->makeShared<Course>(capacity, instructor, location, timeSlot)
+                      : std::make_shared<Course>(capacity, instructor, location, timeSlot);
+            course->setEnrolledStudentCount(reader.readSignedVarint32());
+            courses.emplace_hint(courses.end(), courseId, std::move(course));
+        }
+        mapping.emplace_hint(mapping.end(),
+                             deptCode,
+                             Department(deptCode, std::move(courses), chair, numberOfMajors));
+    }
+    reader.expectEnd();
+    return mapping;
+}
+
+/**
+ * Returns whether the file at the given path starts with the compact snapshot magic.
+ *
+ * @param path               The path to the snapshot file.
+ * @return true if the file is a compact snapshot, false otherwise.
+ */
+bool CompactSnapshot::isCompactSnapshot(const std::string& path) {
+    std::ifstream inFile(path, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return inFile.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+/**
+ * Reads a compact snapshot file with a single read and decodes it from memory.
+ *
+ * @param path               The path to the snapshot file.
+ * @param mode               Where to allocate the courses.
+ * @return The department mapping.
+ */
+std::map<std::string, Department> CompactSnapshot::read(const std::string& path,
+                                                        AllocationMode mode) {
+    std::ifstream inFile(path, std::ios::binary);
+    if (!inFile) {
+        throw std::runtime_error("Failed to open snapshot " + path);
+    }
+    std::string bytes((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    return decode(bytes, mode);
+}
@@ -2,6 +2,21 @@
 #include "Course.h"
 #include <iostream>
 #include <string>
+#include <string_view>
+
+namespace {
+
+/**
+ * Parses a time slot, mapping slots that don't parse to the empty range {0, 0}.
+ *
+ * @param timeSlot           The time slot.
+ * @return The time range.
+ */
+TimeRange parseTimeRange(InternedString timeSlot) {
+    return TimeRange::parse(timeSlot.view()).value_or(TimeRange{0, 0});
+}
+
+}  // namespace
 
 /**
  * Constructs a new Course object with the given parameters. Initial count starts at 0.
@@ -12,24 +27,71 @@
  * @param capacity           The maximum number of students that can enroll in the course.
  */
 Course::Course(int capacity,
-               const std::string& instructorName,
-               const std::string& courseLocation,
-               const std::string& timeSlot)
-    : enrollmentCapacity(capacity),
-      enrolledStudentCount(0),
+               std::string_view instructorName,
+               std::string_view courseLocation,
+               std::string_view timeSlot)
+    : Course(capacity,
+             InternedString::intern(instructorName),
+             InternedString::intern(courseLocation),
+             InternedString::intern(timeSlot)) {}
+
+/**
+ * Constructs a new Course object from strings that are already interned, as snapshot loads do
+ * once per distinct string. Initial count starts at 0.
+ *
+ * @param instructorName     The name of the instructor teaching the course.
+ * @param courseLocation     The location where the course is held.
+ * @param timeSlot           The time slot of the course.
+ * @param capacity           The maximum number of students that can enroll in the course.
+ */
+Course::Course(int capacity,
+               InternedString instructorName,
+               InternedString courseLocation,
+               InternedString timeSlot)
+    : seats(0),
+      version(0),
+      enrollmentCapacity(capacity),
       courseLocation(courseLocation),
       instructorName(instructorName),
-      courseTimeSlot(timeSlot) {}
+      courseTimeSlot(timeSlot),
+      timeRange(parseTimeRange(timeSlot)) {}
 
 /**
  * Constructs a default Course object with the default parameters.
  */
-Course::Course()
-    : enrollmentCapacity(0),
-      enrolledStudentCount(0),
-      courseLocation(""),
-      instructorName(""),
-      courseTimeSlot("") {}
+Course::Course() : seats(0), version(0), enrollmentCapacity(0), timeRange{0, 0} {}
+
+/**
+ * Constructs a copy of a course. The copy takes the current seat count and version, but isn't
+ * retired even if the original is.
+ *
+ * @param other              The course to copy.
+ */
+Course::Course(const Course& other)
+    : seats(other.seats.load() & ~kRetired),
+      version(other.version),
+      enrollmentCapacity(other.enrollmentCapacity),
+      courseLocation(other.courseLocation),
+      instructorName(other.instructorName),
+      courseTimeSlot(other.courseTimeSlot),
+      timeRange(other.timeRange) {}
+
+/**
+ * Replaces this course's fields with those of another course, as the copy constructor does.
+ *
+ * @param other              The course to copy.
+ * @return This course.
+ */
+Course& Course::operator=(const Course& other) {
+    seats = other.seats.load() & ~kRetired;
+    version = other.version;
+    enrollmentCapacity = other.enrollmentCapacity;
+    courseLocation = other.courseLocation;
+    instructorName = other.instructorName;
+    courseTimeSlot = other.courseTimeSlot;
+    timeRange = other.timeRange;
+    return *this;
+}
 
 /**
  * Returns the course's location.
@@ -37,7 +99,7 @@ Course::Course()
  * @return The location as a string.
  */
 std::string Course::getCourseLocation() const {
-    return courseLocation;
+    return std::string(courseLocation.view());
 }
 
 /**
@@ -46,7 +108,7 @@ std::string Course::getCourseLocation() const {
  * @return The instructor as a string.
  */
 std::string Course::getInstructorName() const {
-    return instructorName;
+    return std::string(instructorName.view());
 }
 
 /**
@@ -55,9 +117,86 @@ std::string Course::getInstructorName() const {
  * @return The time slot as a string.
  */
 std::string Course::getCourseTimeSlot() const {
+    return std::string(courseTimeSlot.view());
+}
+
+/**
+ * Returns the course's interned location, which compares as an integer.
+ *
+ * @return The interned location.
+ */
+InternedString Course::getInternedLocation() const {
+    return courseLocation;
+}
+
+/**
+ * Returns the course's interned instructor, which compares as an integer.
+ *
+ * @return The interned instructor.
+ */
+InternedString Course::getInternedInstructor() const {
+    return instructorName;
+}
+
+/**
+ * Returns the course's interned time slot, which compares as an integer.
+ *
+ * @return The interned time slot.
+ */
+InternedString Course::getInternedTimeSlot() const {
     return courseTimeSlot;
 }
 
+/**
+ * Returns the minutes of the day the course meets, parsed from its time slot when the slot was
+ * set.
+ *
+ * @return The time range, or std::nullopt if the time slot isn't a valid range.
+ */
+std::optional<TimeRange> Course::getTimeRange() const {
+    if (timeRange.end == 0) {
+        return std::nullopt;
+    }
+    return timeRange;
+}
+
+/**
+ * Returns the number of students enrolled in the course.
+ *
+ * @return The enrolled student count.
+ */
+int Course::getEnrolledStudentCount() const {
+    return countOf(seats.load());
+}
+
+/**
+ * Returns the maximum number of students that can enroll in the course.
+ *
+ * @return The enrollment capacity.
+ */
+int Course::getEnrollmentCapacity() const {
+    return enrollmentCapacity;
+}
+
+/**
+ * Returns the course's version, which replacing the course with a newer version advances.
+ *
+ * @return The version.
+ */
+uint64_t Course::getVersion() const {
+    return version;
+}
+
+/**
+ * Returns the course's version and current seat count, for a later change to be made
+ * conditional on.
+ *
+ * @return The state.
+ */
+CourseState Course::getState() const {
+    return CourseState{version, getEnrolledStudentCount()};
+}
+
 /**
  * Returns the course info as a human-readable string.
  *
@@ -65,9 +204,12 @@ std::string Course::getCourseTimeSlot() const {
  */
 std::string Course::display() const {
     std::string str;
-    str += "\nInstructor: " + instructorName;
-    str += "; Location: " + courseLocation;
-    str += "; Time: " + courseTimeSlot;
+    str += "\nInstructor: ";
+    str += instructorName.view();
+    str += "; Location: ";
+    str += courseLocation.view();
+    str += "; Time: ";
+    str += courseTimeSlot.view();
     return str;
 }
 
@@ -77,16 +219,17 @@ std::string Course::display() const {
  * @return true if the course is full, false otherwise.
  */
 bool Course::isCourseFull() const {
-    return enrolledStudentCount >= enrollmentCapacity;
+    return getEnrolledStudentCount() >= enrollmentCapacity;
 }
 
 /**
- * Sets the enrollment count.
+ * Sets the enrollment count, keeping the version. Unlike storeSeats(), this also clears the
+ * retired mark, so it is only for courses no other thread can see.
  *
  * @param count              The new count.
  */
 void Course::setEnrolledStudentCount(int count) {
-    enrolledStudentCount = count;
+    seats = packSeats(count);
 }
 
 /**
@@ -95,12 +238,7 @@ void Course::setEnrolledStudentCount(int count) {
  * @return true if the student is successfully enrolled, false otherwise.
  */
 bool Course::enrollStudent() {
-    if (!isCourseFull()) {
-        enrolledStudentCount++;
-        return true;
-    } else {
-        return false;
-    }
+    return reserveSeat() == SeatChange::Applied;
 }
 
 /**
@@ -109,39 +247,192 @@ bool Course::enrollStudent() {
  * @return true if the student is successfully dropped, false otherwise.
  */
 bool Course::dropStudent() {
-    if (enrolledStudentCount > 0) {
-        enrolledStudentCount--;
-        return true;
-    } else {
+    return releaseSeat() == SeatChange::Applied;
+}
+
+/**
+ * Takes a seat with a single compare-and-swap, retried only when another thread changed the
+ * count in between, so concurrent callers can never overbook the course.
+ *
+ * @return SeatChange::Rejected if the course is full, SeatChange::Stale if it was retired.
+ */
+SeatChange Course::reserveSeat() {
+    return changeSeats(1);
+}
+
+/**
+ * Gives a seat back with a single compare-and-swap, as reserveSeat() takes one.
+ *
+ * @return SeatChange::Rejected if nobody is enrolled, SeatChange::Stale if the course was
+ *         retired.
+ */
+SeatChange Course::releaseSeat() {
+    return changeSeats(-1);
+}
+
+/**
+ * Adds to or takes from the seat count with a compare-and-swap, retried until it succeeds or the
+ * change is rejected. Taking seats is rejected if it would leave the count above capacity, and
+ * giving them back if it would leave it below zero.
+ *
+ * @param delta              The number of seats to take, or to give back if negative.
+ * @return The outcome of the change.
+ */
+SeatChange Course::changeSeats(int delta) {
+    for (;;) {
+        if (std::optional<SeatChange> change = tryChangeSeats(delta)) {
+            return *change;
+        }
+    }
+}
+
+/**
+ * Makes a single attempt at changeSeats(), for callers that would rather do something else than
+ * retry when other threads are changing the count too.
+ *
+ * @param delta              The number of seats to take, or to give back if negative.
+ * @return The outcome of the change, or std::nullopt if another thread changed the count first.
+ */
+std::optional<SeatChange> Course::tryChangeSeats(int delta) {
+    uint64_t current = seats.load();
+    SeatChange change = checkSeats(current, delta);
+    if (change != SeatChange::Applied) {
+        return change;
+    }
+    if (!seats.compare_exchange_strong(current, packSeats(countOf(current) + delta))) {
+        return std::nullopt;
+    }
+    return change;
+}
+
+/**
+ * Applies a batch of seat changes in order with one compare-and-swap, so that a thread combining
+ * the requests of others pays for one atomic update however many there are. Each change is
+ * checked against the count the earlier ones leave, as if they had been applied one at a time.
+ *
+ * @param deltas             The changes, as for changeSeats().
+ * @param results            Set to the outcome of each change: SeatChange::Applied or
+ *                           SeatChange::Rejected.
+ * @param count              The number of changes.
+ * @return SeatChange::Applied, or SeatChange::Stale if the course was retired, in which case no
+ *         change was applied and results is unset.
+ */
+SeatChange Course::changeSeats(const int* deltas, SeatChange* results, size_t count) {
+    uint64_t current = seats.load();
+    uint64_t next;
+    do {
+        if (current & kRetired) {
+            return SeatChange::Stale;
+        }
+        next = current;
+        for (size_t i = 0; i < count; ++i) {
+            results[i] = checkSeats(next, deltas[i]);
+            if (results[i] == SeatChange::Applied) {
+                next = packSeats(countOf(next) + deltas[i]);
+            }
+        }
+    } while (next != current && !seats.compare_exchange_weak(current, next));
+    return SeatChange::Applied;
+}
+
+/**
+ * Sets the enrollment count of a course that other threads may be changing, unless it was
+ * retired or, if a state is expected, the course has moved on from it. The expected count is
+ * checked by the compare-and-swap; a count that has come back to it since it was read leaves
+ * the course as the caller saw it, so that matches too.
+ *
+ * @param count              The new count.
+ * @param expected           The state the course must be at, if any.
+ * @return SeatChange::Applied, SeatChange::Stale if the course was retired, or
+ *         SeatChange::Conflict if it isn't at the expected state.
+ */
+SeatChange Course::storeSeats(int count, std::optional<CourseState> expected) {
+    if (expected && expected->version != version) {
+        return SeatChange::Conflict;
+    }
+    uint64_t current = seats.load();
+    do {
+        if (current & kRetired) {
+            return SeatChange::Stale;
+        }
+        if (expected && countOf(current) != expected->count) {
+            return SeatChange::Conflict;
+        }
+    } while (!seats.compare_exchange_weak(current, packSeats(count)));
+    return SeatChange::Applied;
+}
+
+/**
+ * Freezes the seat count of a course that is about to be replaced by a newer version, so that
+ * seat changes made from now on fail with SeatChange::Stale instead of being lost with this
+ * version. The count keeps reading as it was.
+ *
+ * @return The final count, for the newer version to start from.
+ */
+int Course::retireSeats() {
+    return countOf(seats.fetch_or(kRetired));
+}
+
+/**
+ * Makes this course the newer version of another one, which is retired as by retireSeats(). This
+ * course takes the other's final seat count and the version after the other's. The count check
+ * and the retirement are one compare-and-swap, so a seat change can't slip in between them.
+ *
+ * @param previous           The course this one replaces.
+ * @param expected           The state previous must be at, if any.
+ * @return true, or false if previous isn't at the expected state, in which case neither course
+ *         is changed.
+ */
+bool Course::supersede(Course& previous, std::optional<CourseState> expected) {
+    if (expected && expected->version != previous.version) {
         return false;
     }
+    uint64_t current = previous.seats.load();
+    do {
+        if (expected && countOf(current) != expected->count) {
+            return false;
+        }
+    } while (!previous.seats.compare_exchange_weak(current, current | kRetired));
+    seats = packSeats(countOf(current));
+    version = previous.version + 1;
+    return true;
 }
 
 /**
- * Assigns the course to a new location.
+ * Returns whether retireSeats() has been called.
+ *
+ * @return true if the course was retired.
+ */
+bool Course::isRetired() const {
+    return seats.load() & kRetired;
+}
+
+/**
+ * Assigns the course to a new location, interning it.
  *
  * @param newLocation        The new location.
  */
 void Course::reassignLocation(const std::string& newLocation) {
-    courseLocation = newLocation;
+    courseLocation = InternedString::intern(newLocation);
 }
 
 /**
- * Assigns the course to a new instructor.
+ * Assigns the course to a new instructor, interning the name.
  *
  * @param newInstructorName  The new instructor name.
  */
 void Course::reassignInstructor(const std::string& newInstructorName) {
-    instructorName = newInstructorName;
+    instructorName = InternedString::intern(newInstructorName);
 }
 
 /**
- * Assigns the course to a new time slot.
+ * Assigns the course to a new time slot, interning and parsing it.
  *
  * @param newTime            The new time slot.
  */
 void Course::reassignTime(const std::string& newTime) {
-    courseTimeSlot = newTime;
+    courseTimeSlot = InternedString::intern(newTime);
+    timeRange = parseTimeRange(courseTimeSlot);
 }
 
 /**
@@ -150,55 +441,51 @@ void Course::reassignTime(const std::string& newTime) {
  * @param out                The out stream to write to.
  */
 void Course::serialize(std::ostream& out) const {
+    int enrolledStudentCount = getEnrolledStudentCount();
     out.write(reinterpret_cast<const char*>(&enrollmentCapacity), sizeof(enrollmentCapacity));
     out.write(reinterpret_cast<const char*>(&enrolledStudentCount), sizeof(enrolledStudentCount));
 
-    size_t locationLen = courseLocation.length();
+    std::string_view location = courseLocation.view();
+    size_t locationLen = location.length();
     out.write(reinterpret_cast<const char*>(&locationLen), sizeof(locationLen));
-    out.write(courseLocation.c_str(), locationLen);
+    out.write(location.data(), locationLen);
 
-    size_t instructorLen = instructorName.length();
+    std::string_view instructor = instructorName.view();
+    size_t instructorLen = instructor.length();
     out.write(reinterpret_cast<const char*>(&instructorLen), sizeof(instructorLen));
-    out.write(instructorName.c_str(), instructorLen);
+    out.write(instructor.data(), instructorLen);
 
-    size_t timeSlotLen = courseTimeSlot.length();
+    std::string_view timeSlot = courseTimeSlot.view();
+    size_t timeSlotLen = timeSlot.length();
     out.write(reinterpret_cast<const char*>(&timeSlotLen), sizeof(timeSlotLen));
-    out.write(courseTimeSlot.c_str(), timeSlotLen);
+    out.write(timeSlot.data(), timeSlotLen);
 }
 
 /**
  * De-serializes the course from a binary format, setting this object's members accordingly.
+ * Lengths are checked against the bytes that remain, so a corrupt snapshot throws instead of
+ * allocating or reading past the end.
  *
- * @param in                 The in stream to read from.
+ * @param in                 The reader to read from.
  */
-void Course::deserialize(std::istream& in) {
-    in.read(reinterpret_cast<char*>(&enrollmentCapacity), sizeof(enrollmentCapacity));
-    in.read(reinterpret_cast<char*>(&enrolledStudentCount), sizeof(enrolledStudentCount));
-
-    size_t locationLen;
-    in.read(reinterpret_cast<char*>(&locationLen), sizeof(locationLen));
-    courseLocation.resize(locationLen);
-    in.read(&courseLocation[0], locationLen);
-
-    size_t instructorLen;
-    in.read(reinterpret_cast<char*>(&instructorLen), sizeof(instructorLen));
-    instructorName.resize(instructorLen);
-    in.read(&instructorName[0], instructorLen);
-
-    size_t timeSlotLen;
-    in.read(reinterpret_cast<char*>(&timeSlotLen), sizeof(timeSlotLen));
-    courseTimeSlot.resize(timeSlotLen);
-    in.read(&courseTimeSlot[0], timeSlotLen);
+void Course::deserialize(ByteReader& in) {
+    enrollmentCapacity = in.readI32();
+    seats = packSeats(in.readI32());
+    // Interned from views of the buffer, so strings the table already holds cost no allocation.
+    courseLocation = InternedString::intern(in.readBytes(in.readU64()));
+    instructorName = InternedString::intern(in.readBytes(in.readU64()));
+    courseTimeSlot = InternedString::intern(in.readBytes(in.readU64()));
+    timeRange = parseTimeRange(courseTimeSlot);
 }
 
 /**
- * Checks if this course is equal to another course.
+ * Checks if this course is equal to another course. Interned strings compare by ID.
  *
  * @param rhs                The right hand side Course object to compare to.
  */
 bool Course::operator==(const Course& rhs) const {
     return enrollmentCapacity == rhs.enrollmentCapacity &&
-           enrolledStudentCount == rhs.enrolledStudentCount &&
+           getEnrolledStudentCount() == rhs.getEnrolledStudentCount() &&
            courseLocation == rhs.courseLocation && instructorName == rhs.instructorName &&
            courseTimeSlot == rhs.courseTimeSlot;
 }
@@ -211,3 +498,42 @@ bool Course::operator==(const Course& rhs) const {
 bool Course::operator!=(const Course& rhs) const {
     return !operator==(rhs);
 }
+
+/**
+ * Packs an enrolled count into the seats word, without the retired mark.
+ *
+ * @param count              The count.
+ * @return The packed word.
+ */
+uint64_t Course::packSeats(int count) {
+    return static_cast<uint32_t>(count);
+}
+
+/**
+ * Unpacks the enrolled count from the seats word.
+ *
+ * @param word               The seats word.
+ * @return The count.
+ */
+int Course::countOf(uint64_t word) {
+    return static_cast<int32_t>(static_cast<uint32_t>(word));
+}
+
+/**
+ * Checks whether a seat change can be applied to a given seats word.
+ *
+ * @param word               The seats word.
+ * @param delta              The number of seats to take, or to give back if negative.
+ * @return SeatChange::Applied if it can, otherwise why not.
+ */
+SeatChange Course::checkSeats(uint64_t word, int delta) const {
+    if (word & kRetired) {
+        return SeatChange::Stale;
+    }
+    int64_t next = static_cast<int64_t>(countOf(word)) + delta;
+    if (delta > 0 ? next > enrollmentCapacity : next < 0) {
+        return SeatChange::Rejected;
+    }
+    return SeatChange::Applied;
+}
+
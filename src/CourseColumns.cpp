@@ -0,0 +1,252 @@
+// Copyright 2024 Jason Han
+#include "CourseColumns.h"
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+
+/**
+ * Builds the columns from one version of every department.
+ *
+ * @param departments        Each department's code and version, in the order their courses get
+ *                           their IDs.
+ */
+CourseColumns::CourseColumns(
+    const std::vector<std::pair<std::string_view, const Department*>>& departments)
+    : count(0) {
+    for (const auto& [deptCode, dept] : departments) {
+        count += dept->getCourseSelection().size();
+    }
+    if (count > UINT32_MAX) {
+        throw std::runtime_error("Too many courses for the course columns");
+    }
+    full.reset(new std::atomic<uint8_t>[count]);
+    location.reset(new std::atomic<uint32_t>[count]);
+    instructor.reset(new std::atomic<uint32_t>[count]);
+    timeSlot.reset(new std::atomic<uint32_t>[count]);
+    timeRange.reset(new std::atomic<uint32_t>[count]);
+    deptCodes.reserve(departments.size());
+    deptStart.reserve(departments.size() + 1);
+    deptOf.reserve(count);
+    courseCodes.reserve(count);
+
+    for (const auto& [deptCode, dept] : departments) {
+        deptStart.push_back(static_cast<uint32_t>(courseCodes.size()));
+        for (const auto& [courseCode, course] : dept->getCourseSelection()) {
+            store(static_cast<uint32_t>(courseCodes.size()), *course);
+            deptOf.push_back(static_cast<uint32_t>(deptCodes.size()));
+            courseCodes.push_back(courseCode);
+        }
+        deptCodes.emplace_back(deptCode);
+    }
+    deptStart.push_back(static_cast<uint32_t>(courseCodes.size()));
+    locationIndex.build(location.get(), count);
+    instructorIndex.build(instructor.get(), count);
+    timeSlotIndex.build(timeSlot.get(), count);
+    // deptCodes doesn't grow past this point, so the views the index keeps stay valid.
+    deptIndex.reserve(deptCodes.size());
+    for (size_t i = 0; i < deptCodes.size(); ++i) {
+        deptIndex.insert(deptCodes[i], static_cast<uint32_t>(i));
+    }
+    courseIndex.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::optional<uint64_t> key = packCourseKey(deptCodes[deptOf[i]], courseCodes[i]);
+        if (key) {
+            courseIndex.insert(*key, static_cast<uint32_t>(i));
+        }
+    }
+}
+
+/**
+ * Returns the number of courses.
+ *
+ * @return The number of courses.
+ */
+size_t CourseColumns::size() const {
+    return count;
+}
+
+/**
+ * Finds the dense ID of a course. Codes that pack into one 64-bit key are found with a single
+ * probe of the composite index; otherwise a department's courses are numbered in code order, so
+ * the course is found by binary search within its department's range.
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @return The course's ID, or std::nullopt if the course doesn't exist.
+ */
+std::optional<uint32_t> CourseColumns::find(std::string_view deptCode,
+                                            std::string_view courseCode) const {
+    if (std::optional<uint64_t> key = packCourseKey(deptCode, courseCode)) {
+        const uint32_t* course = courseIndex.find(*key);
+        return course ? std::optional<uint32_t>(*course) : std::nullopt;
+    }
+    const uint32_t* dept = deptIndex.find(deptCode);
+    if (!dept) {
+        return std::nullopt;
+    }
+    auto first = courseCodes.begin() + deptStart[*dept];
+    auto last = courseCodes.begin() + deptStart[*dept + 1];
+    auto it = std::lower_bound(first, last, courseCode, [](const std::string& code, auto key) {
+        return code < key;
+    });
+    if (it == last || *it != courseCode) {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>(it - courseCodes.begin());
+}
+
+/**
+ * Returns the department and course code of a course.
+ *
+ * @param course             The course's ID.
+ * @return The course's key.
+ */
+CourseKey CourseColumns::getKey(uint32_t course) const {
+    return CourseKey{deptCodes[deptOf[course]], courseCodes[course]};
+}
+
+/**
+ * Returns the location of a course.
+ *
+ * @param course             The course's ID.
+ * @return The location.
+ */
+InternedString CourseColumns::getLocation(uint32_t course) const {
+    return InternedString::fromId(location[course].load(std::memory_order_relaxed));
+}
+
+/**
+ * Returns the instructor of a course.
+ *
+ * @param course             The course's ID.
+ * @return The instructor.
+ */
+InternedString CourseColumns::getInstructor(uint32_t course) const {
+    return InternedString::fromId(instructor[course].load(std::memory_order_relaxed));
+}
+
+/**
+ * Returns the parsed time slot of a course.
+ *
+ * @param course             The course's ID.
+ * @return The time range, or std::nullopt if the course's time slot doesn't parse.
+ */
+std::optional<TimeRange> CourseColumns::getTimeRange(uint32_t course) const {
+    uint32_t packed = timeRange[course].load(std::memory_order_relaxed);
+    if (packed == 0) {
+        return std::nullopt;
+    }
+    return TimeRange{static_cast<uint16_t>(packed >> 16), static_cast<uint16_t>(packed)};
+}
+
+/**
+ * Stores the current field values of a course and moves it between the value indexes. Calls for
+ * the same course must be serialized with each other; calls for different courses can run
+ * concurrently, and all of them alongside scans and lookups. Only a call that changes an indexed
+ * value takes the index lock, so enrollment changes never contend.
+ *
+ * @param course             The course's ID.
+ * @param value              The course's current version.
+ */
+void CourseColumns::update(uint32_t course, const Course& value) {
+    uint32_t previousLocation = location[course].load(std::memory_order_relaxed);
+    uint32_t previousInstructor = instructor[course].load(std::memory_order_relaxed);
+    uint32_t previousTimeSlot = timeSlot[course].load(std::memory_order_relaxed);
+    store(course, value);
+    uint32_t nextLocation = value.getInternedLocation().getId();
+    uint32_t nextInstructor = value.getInternedInstructor().getId();
+    uint32_t nextTimeSlot = value.getInternedTimeSlot().getId();
+    if (nextLocation == previousLocation && nextInstructor == previousInstructor &&
+        nextTimeSlot == previousTimeSlot) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(indexMutex);
+    locationIndex.move(course, previousLocation, nextLocation);
+    instructorIndex.move(course, previousInstructor, nextInstructor);
+    timeSlotIndex.move(course, previousTimeSlot, nextTimeSlot);
+}
+
+/**
+ * Brings a course's fullness column up to date with a course whose seat count other threads
+ * change in place, writing only if the column disagrees with it. The column is read again after
+ * each store, so when several threads refresh it at once, the last store always agrees with the
+ * final count.
+ *
+ * @param course             The course's ID.
+ * @param value              The course's current version.
+ */
+void CourseColumns::refreshFullness(uint32_t course, const Course& value) {
+    for (;;) {
+        uint8_t isFull = value.isCourseFull() ? 1 : 0;
+        // Sequentially consistent, unlike other column accesses, so that a store can't be
+        // ordered after the next reading of the count.
+        if (full[course].load() == isFull) {
+            return;
+        }
+        full[course].store(isFull);
+    }
+}
+
+/**
+ * Returns every full course, reading only the fullness column.
+ *
+ * @return The IDs of the full courses, in ID order.
+ */
+std::vector<uint32_t> CourseColumns::findFull() const {
+    std::vector<uint32_t> matches;
+    for (size_t i = 0; i < count; ++i) {
+        if (full[i].load(std::memory_order_relaxed)) {
+            matches.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return matches;
+}
+
+/**
+ * Returns every course held in a location, from the location index.
+ *
+ * @param location           The location.
+ * @return The IDs of the matching courses, in ID order.
+ */
+std::vector<uint32_t> CourseColumns::findByLocation(InternedString location) const {
+    return locationIndex.find(location.getId());
+}
+
+/**
+ * Returns every course taught by an instructor, from the instructor index.
+ *
+ * @param instructor         The instructor.
+ * @return The IDs of the matching courses, in ID order.
+ */
+std::vector<uint32_t> CourseColumns::findByInstructor(InternedString instructor) const {
+    return instructorIndex.find(instructor.getId());
+}
+
+/**
+ * Returns every course in a time slot, from the time slot index.
+ *
+ * @param timeSlot           The time slot.
+ * @return The IDs of the matching courses, in ID order.
+ */
+std::vector<uint32_t> CourseColumns::findByTimeSlot(InternedString timeSlot) const {
+    return timeSlotIndex.find(timeSlot.getId());
+}
+
+/**
+ * Stores the current field values of a course in the columns.
+ *
+ * @param course             The course's ID.
+ * @param value              The course's current version.
+ */
+void CourseColumns::store(uint32_t course, const Course& value) {
+    // Sequentially consistent, as in refreshFullness(), since seat changes refresh the column
+    // while a writer that replaced the course stores it here.
+    full[course].store(value.isCourseFull() ? 1 : 0);
+    location[course].store(value.getInternedLocation().getId(), std::memory_order_relaxed);
+    instructor[course].store(value.getInternedInstructor().getId(), std::memory_order_relaxed);
+    timeSlot[course].store(value.getInternedTimeSlot().getId(), std::memory_order_relaxed);
+    std::optional<TimeRange> range = value.getTimeRange();
+    timeRange[course].store(range ? static_cast<uint32_t>(range->start) << 16 | range->end : 0,
+                            std::memory_order_relaxed);
+}
@@ -0,0 +1,140 @@
+// Copyright 2024 Jason Han
+#include "Crc32c.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define CRC32C_ARM 1
+#endif
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0x82f63b78;  // Castagnoli, reflected.
+
+constexpr std::array<std::array<uint32_t, 256>, 8> makeTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (kPolynomial & (0u - (crc & 1)));
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (size_t t = 1; t < 8; ++t) {
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+        }
+    }
+    return tables;
+}
+
+constexpr auto kTables = makeTables();
+
+#if defined(CRC32C_X86)
+__attribute__((target("sse4.2"))) uint32_t crc32cHardware(const uint8_t* bytes,
+                                                          size_t length,
+                                                          uint32_t crc) {
+    uint64_t crc64 = crc;
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        bytes += 8;
+        length -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+    while (length-- > 0) {
+        crc = _mm_crc32_u8(crc, *bytes++);
+    }
+    return crc;
+}
+
+bool detectHardware() {
+    return __builtin_cpu_supports("sse4.2");
+}
+#elif defined(CRC32C_ARM)
+uint32_t crc32cHardware(const uint8_t* bytes, size_t length, uint32_t crc) {
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        crc = __crc32cd(crc, word);
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = __crc32cb(crc, *bytes++);
+    }
+    return crc;
+}
+
+bool detectHardware() {
+    return true;
+}
+#endif
+
+}  // namespace
+
+/**
+ * Computes the CRC-32C of a buffer with the slicing-by-8 tables, eight bytes per step.
+ *
+ * @param data               The bytes.
+ * @param length             The number of bytes.
+ * @param crc                The checksum of the preceding data, or 0.
+ * @return The checksum.
+ */
+uint32_t crc32cPortable(const void* data, size_t length, uint32_t crc) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    while (length >= 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, bytes, sizeof(low));
+        std::memcpy(&high, bytes + 4, sizeof(high));
+        low ^= crc;
+        crc = kTables[7][low & 0xff] ^ kTables[6][(low >> 8) & 0xff] ^
+              kTables[5][(low >> 16) & 0xff] ^ kTables[4][low >> 24] ^
+              kTables[3][high & 0xff] ^ kTables[2][(high >> 8) & 0xff] ^
+              kTables[1][(high >> 16) & 0xff] ^ kTables[0][high >> 24];
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = (crc >> 8) ^ kTables[0][(crc ^ *bytes++) & 0xff];
+    }
+    return ~crc;
+}
+
+/**
+ * Returns whether crc32c() runs on CRC instructions rather than lookup tables.
+ *
+ * @return true if the CPU's CRC instructions are used, false otherwise.
+ */
+bool crc32cIsHardwareAccelerated() {
+#if defined(CRC32C_X86) || defined(CRC32C_ARM)
+    static const bool hardware = detectHardware();
+    return hardware;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Computes the CRC-32C of a buffer.
+ *
+ * @param data               The bytes.
+ * @param length             The number of bytes.
+ * @param crc                The checksum of the preceding data, or 0.
+ * @return The checksum.
+ */
+uint32_t crc32c(const void* data, size_t length, uint32_t crc) {
+#if defined(CRC32C_X86) || defined(CRC32C_ARM)
+    if (crc32cIsHardwareAccelerated()) {
+        return ~crc32cHardware(static_cast<const uint8_t*>(data), length, ~crc);
+    }
+#endif
+    return crc32cPortable(data, length, crc);
+}
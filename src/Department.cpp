@@ -1,6 +1,7 @@
 // Copyright 2024 Jason Han
 #include "Department.h"
 #include <sstream>
+#include <utility>
 
 /**
  * Constructs a new Department object with the given parameters.
@@ -15,11 +16,68 @@ Department::Department(std::string deptCode,
                        std::string departmentChair,
                        int numberOfMajors)
     : numberOfMajors(numberOfMajors),
-      deptCode(deptCode),
-      departmentChair(departmentChair),
-      courses(courses) {}
+      version(0),
+      deptCode(std::move(deptCode)),
+      departmentChair(std::move(departmentChair)),
+      courses(std::move(courses)) {
+    indexCourses();
+}
+
+Department::Department() : numberOfMajors(0), version(0) {}
+
+/**
+ * Copies a department. The copy shares its courses with the original, and indexes its own copy
+ * of the course keys.
+ *
+ * @param other              The department to copy.
+ */
+Department::Department(const Department& other)
+    : numberOfMajors(other.numberOfMajors),
+      version(other.version),
+      deptCode(other.deptCode),
+      departmentChair(other.departmentChair),
+      courses(other.courses) {
+    indexCourses();
+}
 
-Department::Department() : numberOfMajors(0) {}
+/**
+ * Replaces this department with a copy of another one.
+ *
+ * @param other              The department to copy.
+ * @return This department.
+ */
+Department& Department::operator=(const Department& other) {
+    if (this != &other) {
+        numberOfMajors = other.numberOfMajors;
+        version = other.version;
+        deptCode = other.deptCode;
+        departmentChair = other.departmentChair;
+        courses = other.courses;
+        indexCourses();
+    }
+    return *this;
+}
+
+/**
+ * Rebuilds the course index from the course map. The index refers to the map's keys, so it is
+ * rebuilt whenever the map is copied.
+ */
+void Department::indexCourses() {
+    courseIndex.clear();
+    courseIndex.reserve(courses.size());
+    for (const auto& [courseId, course] : courses) {
+        courseIndex.insert(courseId, course.get());
+    }
+}
+
+/**
+ * Gets the code of the department.
+ *
+ * @return The department code.
+ */
+std::string Department::getDeptCode() const {
+    return deptCode;
+}
 
 /**
  * Gets the number of majors in the department.
@@ -30,6 +88,15 @@ int Department::getNumberOfMajors() const {
     return numberOfMajors;
 }
 
+/**
+ * Gets the version of the department, which every change to its own fields advances.
+ *
+ * @return The version.
+ */
+uint64_t Department::getVersion() const {
+    return version;
+}
+
 /**
  * Gets the name of the department chair.
  *
@@ -48,6 +115,18 @@ const std::map<std::string, std::shared_ptr<Course>>& Department::getCourseSelec
     return courses;
 }
 
+/**
+ * Finds a course offered by the department through its hash index, without copying the course
+ * selection or allocating.
+ *
+ * @param courseId           The course code.
+ * @return The course, or nullptr if the department doesn't offer it.
+ */
+const Course* Department::findCourse(std::string_view courseId) const {
+    const Course* const* course = courseIndex.find(courseId);
+    return course ? *course : nullptr;
+}
+
 /**
  * Returns a string representation of the department, including its code and the courses offered.
  *
@@ -77,6 +156,24 @@ void Department::dropPersonFromMajor() {
     }
 }
 
+/**
+ * Sets the number of majors in the department.
+ *
+ * @param count    The new number of majors.
+ */
+void Department::setNumberOfMajors(int count) {
+    numberOfMajors = count;
+}
+
+/**
+ * Sets the version of the department, as the writer publishing it as a newer version does.
+ *
+ * @param next     The new version.
+ */
+void Department::setVersion(uint64_t next) {
+    version = next;
+}
+
 /**
  * Adds a new course to the department's course selection.
  *
@@ -84,7 +181,8 @@ void Department::dropPersonFromMajor() {
  * @param course   The Course object to add.
  */
 void Department::addCourse(std::string courseId, std::shared_ptr<Course> course) {
-    courses[courseId] = course;
+    auto courseIt = courses.insert_or_assign(std::move(courseId), std::move(course)).first;
+    courseIndex.insert(courseIt->first, courseIt->second.get());
 }
 
 /**
@@ -134,32 +232,29 @@ void Department::serialize(std::ostream& out) const {
 
 /**
  * De-serializes the department from a binary format, setting this object's members accordingly.
+ * Lengths and counts are checked against the bytes that remain, so a corrupt snapshot throws
+ * instead of allocating or reading past the end.
  *
- * @param in                 The in stream to read from.
- */
-void Department::deserialize(std::istream& in) {
-    size_t deptCodeLen;
-    in.read(reinterpret_cast<char*>(&deptCodeLen), sizeof(deptCodeLen));
-    deptCode.resize(deptCodeLen);
-    in.read(&deptCode[0], deptCodeLen);
-
-    size_t chairLen;
-    in.read(reinterpret_cast<char*>(&chairLen), sizeof(chairLen));
-    departmentChair.resize(chairLen);
-    in.read(&departmentChair[0], chairLen);
-
-    in.read(reinterpret_cast<char*>(&numberOfMajors), sizeof(numberOfMajors));
-
-    size_t mapSize;
-    in.read(reinterpret_cast<char*>(&mapSize), sizeof(mapSize));
-    for (size_t i = 0; i < mapSize; ++i) {
-        size_t courseIdLen;
-        in.read(reinterpret_cast<char*>(&courseIdLen), sizeof(courseIdLen));
-        std::string courseId(courseIdLen, ' ');
-        in.read(&courseId[0], courseIdLen);
-        std::shared_ptr<Course> course = std::make_shared<Course>();
+ * @param in                 The reader to read from.
+ * @param arena              The arena to create the courses in, or nullptr for the heap.
+ */
+void Department::deserialize(ByteReader& in, const std::shared_ptr<Arena>& arena) {
+    deptCode = in.readString(in.readU64());
+    departmentChair = in.readString(in.readU64());
+    numberOfMajors = in.readI32();
+
+    // A course takes at least its four lengths and two counts.
+    constexpr uint64_t kMinCourseBytes = 4 * sizeof(uint64_t) + 2 * sizeof(int32_t);
+    uint64_t mapSize = in.readU64();
+    if (mapSize > in.remaining() / kMinCourseBytes) {
+        in.fail("course count " + std::to_string(mapSize) + " exceeds the remaining bytes");
+    }
+    for (uint64_t i = 0; i < mapSize; ++i) {
+        std::string courseId = in.readString(in.readU64());
+        std::shared_ptr<Course> course =
+            arena ? arena->makeShared<Course>() : std::make_shared<Course>();
         course->deserialize(in);
-        courses[courseId] = course;
+        addCourse(std::move(courseId), std::move(course));
     }
 }
 
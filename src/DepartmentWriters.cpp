@@ -0,0 +1,248 @@
+// Copyright 2024 Jason Han
+#include "DepartmentWriters.h"
+#include <utility>
+
+/**
+ * Starts the owner threads.
+ *
+ * @param threadCount        The number of owner threads; with none, changes run on the threads
+ *                           that submit them.
+ * @param assignment         Departments mapped to the index of the owner thread that runs their
+ *                           changes, modulo the number of threads. Any other department is
+ *                           hashed onto an owner.
+ */
+DepartmentWriters::DepartmentWriters(size_t threadCount, std::map<std::string, size_t> assignment)
+    : assignment(assignment.begin(), assignment.end()),
+      paused(false),
+      parked(0),
+      parkFn([this]() { park(); }) {
+    for (size_t i = 0; i < threadCount; ++i) {
+        owners.push_back(std::make_unique<Owner>());
+        owners.back()->park.fn = &parkFn;
+    }
+    for (std::unique_ptr<Owner>& owner : owners) {
+        owner->thread = std::thread(&DepartmentWriters::serve, this, std::ref(*owner));
+    }
+}
+
+/**
+ * Stops the owner threads once their queues are empty. No change may be submitted meanwhile.
+ */
+DepartmentWriters::~DepartmentWriters() {
+    for (std::unique_ptr<Owner>& owner : owners) {
+        std::lock_guard<std::mutex> lock(owner->mutex);
+        owner->stopping = true;
+        owner->condition.notify_one();
+    }
+    for (std::unique_ptr<Owner>& owner : owners) {
+        owner->thread.join();
+    }
+}
+
+/**
+ * Runs a change to a department and waits for it to finish: on the department's owner thread, or
+ * on this thread while holding the department's stripe if there are no owner threads. Changes to
+ * one department run one at a time; on an owner thread, also in the order they were submitted in.
+ * Changes to departments with different owners or stripes run in parallel. Must not be called
+ * from inside a change.
+ *
+ * @param deptCode           The department code.
+ * @param fn                 The change; an exception it throws is rethrown here.
+ */
+void DepartmentWriters::run(std::string_view deptCode, const std::function<void()>& fn) {
+    if (owners.empty()) {
+        std::lock_guard<std::mutex> lock(stripes.stripeFor(deptCode));
+        fn();
+        return;
+    }
+    Task task;
+    task.fn = &fn;
+    push(*owners[ownerOf(deptCode)], task);
+    std::unique_lock<std::mutex> lock(task.mutex);
+    task.condition.wait(lock, [&task]() { return task.done; });
+    if (task.error) {
+        std::rethrow_exception(task.error);
+    }
+}
+
+/**
+ * Returns the owner thread of a department.
+ *
+ * @param deptCode           The department code.
+ * @return The index of the owner thread, or 0 if there are no owner threads.
+ */
+size_t DepartmentWriters::ownerOf(std::string_view deptCode) const {
+    if (owners.empty()) {
+        return 0;
+    }
+    auto it = assignment.find(deptCode);
+    if (it != assignment.end()) {
+        return it->second % owners.size();
+    }
+    return std::hash<std::string_view>()(deptCode) % owners.size();
+}
+
+/**
+ * Returns the number of owner threads.
+ *
+ * @return The number of owner threads.
+ */
+size_t DepartmentWriters::getThreadCount() const {
+    return owners.size();
+}
+
+/**
+ * Pauses every owner thread once it finishes its current change, and waits until all of them are
+ * paused, or locks every stripe if there are no owner threads. Changes submitted meanwhile wait
+ * until unlock().
+ */
+void DepartmentWriters::lock() {
+    if (owners.empty()) {
+        stripes.lock();
+        return;
+    }
+    pauseMutex.lock();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        paused = true;
+    }
+    for (std::unique_ptr<Owner>& owner : owners) {
+        owner->park.next.store(nullptr, std::memory_order_relaxed);
+        push(*owner, owner->park);
+    }
+    std::unique_lock<std::mutex> lock(stateMutex);
+    stateCondition.wait(lock, [this]() { return parked == owners.size(); });
+}
+
+/**
+ * Resumes the owner threads paused by lock(), and waits until all of them have resumed, so the
+ * next lock() can't find one still paused from this one. Unlocks the stripes if there are no
+ * owner threads.
+ */
+void DepartmentWriters::unlock() {
+    if (owners.empty()) {
+        stripes.unlock();
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        paused = false;
+        stateCondition.notify_all();
+        stateCondition.wait(lock, [this]() { return parked == 0; });
+    }
+    pauseMutex.unlock();
+}
+
+/**
+ * Appends a task to an owner's queue, waking the owner if it is asleep. The tail is swapped
+ * first and the previous tail linked to the task after, so the owner may briefly see a queue
+ * whose last task isn't linked yet (see pop()).
+ *
+ * @param owner              The owner.
+ * @param task               The task.
+ */
+void DepartmentWriters::push(Owner& owner, Task& task) {
+    Task* previous = owner.tail.exchange(&task);
+    previous->next.store(&task);
+    // Sequentially consistent with the owner's store to sleeping and its check of the queue in
+    // hasWork(): either the owner sees the task, or this sees the owner asleep.
+    if (owner.sleeping.load()) {
+        std::lock_guard<std::mutex> lock(owner.mutex);
+        owner.condition.notify_one();
+    }
+}
+
+/**
+ * Takes the oldest task off an owner's queue. The queue always holds at least one task, the
+ * owner's stub, so producers never see it empty; a task is only returned once another one is
+ * linked behind it, re-queueing the stub if needed, so no producer still refers to it. Called on
+ * the owner thread.
+ *
+ * @param owner              The owner.
+ * @return The task, or nullptr if the queue is empty or its only task is still being linked.
+ */
+DepartmentWriters::Task* DepartmentWriters::pop(Owner& owner) {
+    Task* head = owner.head;
+    Task* next = head->next.load(std::memory_order_acquire);
+    if (head == &owner.stub) {
+        if (!next) {
+            return nullptr;
+        }
+        owner.head = next;
+        head = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        owner.head = next;
+        return head;
+    }
+    if (head != owner.tail.load()) {
+        return nullptr;
+    }
+    owner.stub.next.store(nullptr, std::memory_order_relaxed);
+    push(owner, owner.stub);
+    next = head->next.load(std::memory_order_acquire);
+    if (next) {
+        owner.head = next;
+        return head;
+    }
+    return nullptr;
+}
+
+/**
+ * Returns whether an owner's queue holds a task, linked or not. Called on the owner thread.
+ *
+ * @param owner              The owner.
+ * @return true if there is a task to run.
+ */
+bool DepartmentWriters::hasWork(const Owner& owner) {
+    return owner.head != &owner.stub || owner.stub.next.load() != nullptr;
+}
+
+/**
+ * Body of an owner thread: runs queued tasks in order, and sleeps while there are none.
+ *
+ * @param owner              The owner.
+ */
+void DepartmentWriters::serve(Owner& owner) {
+    for (;;) {
+        if (Task* task = pop(owner)) {
+            try {
+                (*task->fn)();
+            } catch (...) {
+                task->error = std::current_exception();
+            }
+            // Notifying under the task's lock keeps the submitter, which then destroys the task,
+            // from returning before this thread is done with it.
+            std::lock_guard<std::mutex> lock(task->mutex);
+            task->done = true;
+            task->condition.notify_one();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(owner.mutex);
+        if (hasWork(owner)) {
+            // A producer has swapped the tail but not linked its task yet.
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+        if (owner.stopping) {
+            return;
+        }
+        owner.sleeping.store(true);
+        owner.condition.wait(lock, [&owner]() { return owner.stopping || hasWork(owner); });
+        owner.sleeping.store(false);
+    }
+}
+
+/**
+ * Runs on each owner thread paused by lock(), and waits until unlock().
+ */
+void DepartmentWriters::park() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    parked++;
+    stateCondition.notify_all();
+    stateCondition.wait(lock, [this]() { return !paused; });
+    parked--;
+    stateCondition.notify_all();
+}
@@ -0,0 +1,197 @@
+// Copyright 2024 Jason Han
+#include "EpochReclaimer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// One per thread that has ever held a guard. Records are never freed; a record whose thread has
+// exited is handed to the next new thread. Each sits on its own cache line, so pinning never
+// contends with other readers.
+struct alignas(64) EpochRecord {
+    std::atomic<uint64_t> epoch{0};  // The pinned epoch, or 0 when no guard is held.
+    std::atomic<bool> inUse{true};
+    unsigned depth = 0;
+    EpochRecord* next = nullptr;
+};
+
+namespace {
+
+struct RetiredObject {
+    uint64_t epoch;
+    std::function<void()> deleter;
+};
+
+// Objects still retired at exit are deleted then, when no reader can be left.
+struct RetiredList {
+    std::mutex mutex;
+    std::vector<RetiredObject> objects;
+
+    ~RetiredList() {
+        for (RetiredObject& object : objects) {
+            object.deleter();
+        }
+    }
+};
+
+std::atomic<uint64_t> globalEpoch{1};
+std::atomic<EpochRecord*> records{nullptr};
+RetiredList retired;
+
+EpochRecord* acquireRecord() {
+    for (EpochRecord* record = records.load(); record; record = record->next) {
+        bool inUse = false;
+        if (!record->inUse.load() && record->inUse.compare_exchange_strong(inUse, true)) {
+            return record;
+        }
+    }
+    EpochRecord* record = new EpochRecord();
+    record->next = records.load();
+    while (!records.compare_exchange_weak(record->next, record)) {
+    }
+    return record;
+}
+
+struct ThreadRecord {
+    EpochRecord* record = acquireRecord();
+
+    ~ThreadRecord() {
+        record->inUse = false;
+    }
+};
+
+EpochRecord* threadRecord() {
+    thread_local ThreadRecord threadRecord;
+    return threadRecord.record;
+}
+
+/**
+ * Returns the oldest epoch pinned by any thread, or the maximum value if no guard is held.
+ */
+uint64_t oldestPinnedEpoch() {
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (EpochRecord* record = records.load(); record; record = record->next) {
+        uint64_t epoch = record->epoch.load();
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    return oldest;
+}
+
+}  // namespace
+
+/**
+ * Pins the current epoch on the calling thread. Only the outermost guard of a thread pins; nested
+ * guards just count.
+ */
+EpochGuard::EpochGuard() : record(threadRecord()) {
+    if (record->depth++ == 0) {
+        // Sequentially consistent, so every pointer the reader loads afterwards is ordered after
+        // the pin: a writer that doesn't see the pin has already unpublished what it retires.
+        record->epoch.store(globalEpoch.load());
+    }
+}
+
+/**
+ * Releases the guard.
+ */
+EpochGuard::~EpochGuard() {
+    release();
+}
+
+/**
+ * Moves a guard, leaving the moved-from guard empty.
+ *
+ * @param other              The guard to move from.
+ */
+EpochGuard::EpochGuard(EpochGuard&& other) noexcept : record(other.record) {
+    other.record = nullptr;
+}
+
+/**
+ * Releases this guard and takes over another one.
+ *
+ * @param other              The guard to move from.
+ * @return This guard.
+ */
+EpochGuard& EpochGuard::operator=(EpochGuard&& other) noexcept {
+    if (this != &other) {
+        release();
+        record = std::exchange(other.record, nullptr);
+    }
+    return *this;
+}
+
+/**
+ * Unpins the thread's epoch when the outermost guard is released.
+ */
+void EpochGuard::release() {
+    if (record && --record->depth == 0) {
+        record->epoch.store(0, std::memory_order_release);
+    }
+    record = nullptr;
+}
+
+/**
+ * Retires an object that has already been unpublished, so no new reader can reach it, and deletes
+ * whatever retired objects no reader can still be using. Once the object is retired this doesn't
+ * throw: if there is no memory to reclaim with, the objects wait for a later call.
+ *
+ * @param deleter            Deletes the object.
+ */
+void EpochReclaimer::retire(std::function<void()> deleter) {
+    {
+        std::lock_guard<std::mutex> lock(retired.mutex);
+        // Readers pinned at this epoch or earlier may hold the object; readers that pin any later
+        // epoch loaded their pointers after it was unpublished.
+        retired.objects.push_back({globalEpoch.fetch_add(1), std::move(deleter)});
+    }
+    try {
+        reclaim();
+    } catch (const std::bad_alloc&) {
+        // The ready objects stay in the list for the next call.
+    }
+}
+
+/**
+ * Deletes every retired object that was retired before the oldest epoch still pinned. Deleters
+ * run without holding the reclaimer's lock.
+ *
+ * @return The number of objects deleted.
+ */
+size_t EpochReclaimer::reclaim() {
+    std::vector<RetiredObject> ready;
+    {
+        std::lock_guard<std::mutex> lock(retired.mutex);
+        uint64_t oldest = oldestPinnedEpoch();
+        auto firstReady = std::partition(retired.objects.begin(),
+                                         retired.objects.end(),
+                                         [oldest](const RetiredObject& object) {
+                                             return object.epoch >= oldest;
+                                         });
+        // Reserved first, so running out of memory leaves every object in the list.
+        ready.reserve(retired.objects.end() - firstReady);
+        std::move(firstReady, retired.objects.end(), std::back_inserter(ready));
+        retired.objects.erase(firstReady, retired.objects.end());
+    }
+    for (RetiredObject& object : ready) {
+        object.deleter();
+    }
+    return ready.size();
+}
+
+/**
+ * Returns how many retired objects are waiting for readers to release their guards.
+ *
+ * @return The number of pending objects.
+ */
+size_t EpochReclaimer::getPendingCount() {
+    std::lock_guard<std::mutex> lock(retired.mutex);
+    return retired.objects.size();
+}
@@ -0,0 +1,122 @@
+// Copyright 2024 Jason Han
+#include "InternTable.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+/**
+ * Constructs a table holding only the empty string, as ID 0.
+ */
+InternTable::InternTable()
+    : chunks(new std::atomic<std::string_view*>[kMaxChunks]()), nextId(1) {
+    chunkFor(0)[0] = std::string_view();
+}
+
+/**
+ * Frees the ID chunks. The strings themselves go with the shards' arenas.
+ */
+InternTable::~InternTable() {
+    for (size_t i = 0; i < kMaxChunks; ++i) {
+        delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Returns the ID of a string, adding the string to the table if it is new. Interning the same
+ * string always returns the same ID, from any thread.
+ *
+ * @param value              The string to intern.
+ * @return The string's ID.
+ */
+uint32_t InternTable::intern(std::string_view value) {
+    if (value.empty()) {
+        return 0;
+    }
+    Shard& shard = shards[std::hash<std::string_view>()(value) % kShardCount];
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        if (const uint32_t* id = shard.ids.find(value)) {
+            return *id;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (const uint32_t* id = shard.ids.find(value)) {
+        return *id;
+    }
+    uint32_t id = nextId.fetch_add(1);
+    if (id >= kMaxChunks * kChunkSize) {
+        throw std::runtime_error("Intern table is full");
+    }
+    char* characters = static_cast<char*>(shard.characters.allocate(value.length(), 1));
+    std::memcpy(characters, value.data(), value.length());
+    std::string_view stored(characters, value.length());
+    // Other threads learn the ID through this shard's lock or through whatever structure the
+    // caller publishes it in, both of which order this write before their reads.
+    chunkFor(id)[id & (kChunkSize - 1)] = stored;
+    shard.ids.insert(stored, id);
+    return id;
+}
+
+/**
+ * Returns the ID of a string without adding it to the table.
+ *
+ * @param value              The string to look up.
+ * @return The string's ID, or std::nullopt if it has never been interned.
+ */
+std::optional<uint32_t> InternTable::find(std::string_view value) const {
+    if (value.empty()) {
+        return 0;
+    }
+    const Shard& shard = shards[std::hash<std::string_view>()(value) % kShardCount];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    const uint32_t* id = shard.ids.find(value);
+    return id ? std::optional<uint32_t>(*id) : std::nullopt;
+}
+
+/**
+ * Returns the string an ID names. The view stays valid for the lifetime of the table.
+ *
+ * @param id                 An ID returned by intern().
+ * @return The string.
+ */
+std::string_view InternTable::resolve(uint32_t id) const {
+    return chunks[id >> kChunkBits].load(std::memory_order_acquire)[id & (kChunkSize - 1)];
+}
+
+/**
+ * Returns the number of distinct strings in the table, including the empty string.
+ *
+ * @return The number of strings.
+ */
+size_t InternTable::size() const {
+    return std::min<size_t>(nextId.load(), kMaxChunks * kChunkSize);
+}
+
+/**
+ * Returns the table that InternedString uses, which lives for the whole program.
+ *
+ * @return The global table.
+ */
+InternTable& InternTable::global() {
+    static InternTable* table = new InternTable();
+    return *table;
+}
+
+/**
+ * Returns the chunk that holds an ID's entry, allocating it on first use.
+ *
+ * @param id                 The ID.
+ * @return The chunk.
+ */
+std::string_view* InternTable::chunkFor(uint32_t id) {
+    std::atomic<std::string_view*>& chunk = chunks[id >> kChunkBits];
+    if (std::string_view* entries = chunk.load(std::memory_order_acquire)) {
+        return entries;
+    }
+    std::lock_guard<std::mutex> lock(chunkMutex);
+    if (!chunk.load(std::memory_order_relaxed)) {
+        chunk.store(new std::string_view[kChunkSize], std::memory_order_release);
+    }
+    return chunk.load(std::memory_order_relaxed);
+}
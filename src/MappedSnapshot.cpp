@@ -0,0 +1,703 @@
+// Copyright 2024 Jason Han
+#include "MappedSnapshot.h"
+#include "Crc32c.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[8] = {'C', 'A', 'T', 'S', 'N', 'A', 'P', 'M'};
+constexpr uint32_t kVersion = 2;
+
+template <typename T> void writePod(std::string& out, size_t offset, const T& value) {
+    std::memcpy(&out[offset], &value, sizeof(value));
+}
+
+void padToAlignment(std::string& out) {
+    out.resize((out.length() + 7) & ~static_cast<size_t>(7), '\0');
+}
+
+/**
+ * Appends a string to a string section and returns a reference to it.
+ */
+MappedStringRef addString(std::string& strings, const std::string& value) {
+    MappedStringRef ref{static_cast<uint32_t>(strings.length()),
+                        static_cast<uint32_t>(value.length())};
+    strings += value;
+    return ref;
+}
+
+/**
+ * Appends the directory for the given entries to the end of out and returns the file header that
+ * points at it, with the directory and header checksums filled in.
+ *
+ * @param out                The bytes being written; out[0] lies at fileOffset in the file.
+ * @param fileOffset         The file offset of out[0]. Must be 8-byte aligned.
+ * @param entries            The directory entries, sorted by department code.
+ * @param directoryStrings   The strings the entries refer to.
+ */
+MappedSnapshotHeader appendDirectory(std::string& out,
+                                     uint64_t fileOffset,
+                                     const std::vector<MappedDirectoryEntry>& entries,
+                                     const std::string& directoryStrings) {
+    MappedSnapshotHeader fileHeader{};
+    std::memcpy(fileHeader.magic, kMagic, sizeof(kMagic));
+    fileHeader.version = kVersion;
+    fileHeader.departmentCount = static_cast<uint32_t>(entries.size());
+    fileHeader.directoryOffset = fileOffset + out.length();
+    out.append(reinterpret_cast<const char*>(entries.data()),
+               entries.size() * sizeof(MappedDirectoryEntry));
+    out += directoryStrings;
+    fileHeader.directoryLength = fileOffset + out.length() - fileHeader.directoryOffset;
+    fileHeader.directoryCrc = crc32c(out.data() + (fileHeader.directoryOffset - fileOffset),
+                                     fileHeader.directoryLength);
+    fileHeader.headerCrc = crc32c(&fileHeader, offsetof(MappedSnapshotHeader, headerCrc));
+    padToAlignment(out);
+    return fileHeader;
+}
+
+/**
+ * Writes the whole buffer at the given file offset, retrying short writes.
+ */
+void writeAllAt(int fd, const std::string& bytes, uint64_t offset, const std::string& path) {
+    const char* cursor = bytes.data();
+    size_t remaining = bytes.length();
+    while (remaining > 0) {
+        ssize_t written = pwrite(fd, cursor, remaining, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0) {
+            throw std::runtime_error("Failed to write " + path + ": " + std::strerror(errno));
+        }
+        cursor += written;
+        offset += static_cast<uint64_t>(written);
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+}  // namespace
+
+/**
+ * Encodes one department as a self-contained segment. Courses are written in course code order
+ * so that a course can be found by binary search. A segment only refers to its own bytes, so it
+ * can be copied to any 8-byte aligned offset of another snapshot unchanged.
+ *
+ * @param dept               The department.
+ * @return The segment bytes, padded to a multiple of 8.
+ */
+std::string MappedSnapshot::encodeSegment(const Department& dept) {
+    const auto& courses = dept.getCourseSelection();
+    size_t recordsOffset = sizeof(MappedSegmentHeader);
+    std::string segment(recordsOffset + courses.size() * sizeof(MappedCourseRecord), '\0');
+    std::string strings;
+
+    MappedSegmentHeader segmentHeader{};
+    segmentHeader.deptCode = addString(strings, dept.getDeptCode());
+    segmentHeader.departmentChair = addString(strings, dept.getDepartmentChair());
+    segmentHeader.numberOfMajors = dept.getNumberOfMajors();
+    segmentHeader.courseCount = static_cast<uint32_t>(courses.size());
+
+    size_t recordOffset = recordsOffset;
+    for (const auto& [courseId, course] : courses) {
+        MappedCourseRecord record{};
+        record.courseId = addString(strings, courseId);
+        record.courseLocation = addString(strings, course->getCourseLocation());
+        record.instructorName = addString(strings, course->getInstructorName());
+        record.courseTimeSlot = addString(strings, course->getCourseTimeSlot());
+        record.enrollmentCapacity = course->getEnrollmentCapacity();
+        record.enrolledStudentCount = course->getEnrolledStudentCount();
+        writePod(segment, recordOffset, record);
+        recordOffset += sizeof(MappedCourseRecord);
+    }
+
+    segmentHeader.stringsOffset = static_cast<uint32_t>(segment.length());
+    segmentHeader.stringsLength = static_cast<uint32_t>(strings.length());
+    writePod(segment, 0, segmentHeader);
+    segment += strings;
+    padToAlignment(segment);
+    return segment;
+}
+
+/**
+ * Maps a snapshot file into memory and validates its header and directory, including their
+ * checksums. Department segments are bounds-checked as they are accessed, and checksummed when
+ * they are materialized or copied.
+ *
+ * @param path               The path to the snapshot file.
+ */
+MappedSnapshot::MappedSnapshot(const std::string& path)
+    : path(path), data(nullptr), size(0), header{}, directory(nullptr) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open snapshot " + path + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to stat snapshot " + path + ": " + std::strerror(errno));
+    }
+    size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(MappedSnapshotHeader)) {
+        close(fd);
+        throw std::runtime_error("Snapshot " + path + " is too small to be a mapped snapshot");
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map snapshot " + path + ": " + std::strerror(errno));
+    }
+    data = static_cast<const char*>(mapping);
+
+    try {
+        // The header is copied out of the mapping: an incremental write rewrites it in place,
+        // and this snapshot must keep seeing the directory it was opened with.
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion) {
+            throw std::runtime_error("Snapshot " + path + " is not a supported mapped snapshot");
+        }
+        if (crc32c(&header, offsetof(MappedSnapshotHeader, headerCrc)) != header.headerCrc) {
+            throw std::runtime_error("Snapshot " + path + " has a corrupt header checksum");
+        }
+        uint64_t entriesLength =
+            static_cast<uint64_t>(header.departmentCount) * sizeof(MappedDirectoryEntry);
+        if (header.directoryLength < entriesLength ||
+            header.directoryOffset % alignof(MappedDirectoryEntry) != 0) {
+            throw std::runtime_error("Snapshot " + path + " has a corrupt directory");
+        }
+        const char* directoryData = checkedRange(header.directoryOffset, header.directoryLength);
+        if (crc32c(directoryData, header.directoryLength) != header.directoryCrc) {
+            throw std::runtime_error("Snapshot " + path + " has a corrupt directory checksum");
+        }
+        directory = reinterpret_cast<const MappedDirectoryEntry*>(directoryData);
+    } catch (...) {
+        munmap(const_cast<char*>(data), size);
+        throw;
+    }
+}
+
+/**
+ * Unmaps the snapshot file.
+ */
+MappedSnapshot::~MappedSnapshot() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+/**
+ * Returns whether the file at the given path starts with the mapped snapshot magic. Files in the
+ * original stream format start with the department count instead and return false.
+ *
+ * @param path               The path to the snapshot file.
+ * @return true if the file is a mapped snapshot, false otherwise.
+ */
+bool MappedSnapshot::isMappedSnapshot(const std::string& path) {
+    std::ifstream inFile(path, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return inFile.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+/**
+ * Writes the department mapping as a mapped snapshot, replacing the file atomically.
+ *
+ * @param path               The path to the snapshot file.
+ * @param mapping            The department mapping to write.
+ */
+void MappedSnapshot::write(const std::string& path,
+                           const std::map<std::string, Department>& mapping) {
+    writeAtomically(path, encode(mapping));
+}
+
+/**
+ * Encodes the department mapping as the bytes of a mapped snapshot file.
+ *
+ * @param mapping            The department mapping to encode.
+ * @return The file contents.
+ */
+std::string MappedSnapshot::encode(const std::map<std::string, Department>& mapping) {
+    std::string out(sizeof(MappedSnapshotHeader), '\0');
+    std::vector<MappedDirectoryEntry> entries;
+    std::string directoryStrings;
+    for (const auto& [deptCode, dept] : mapping) {
+        std::string segment = encodeSegment(dept);
+        entries.push_back({addString(directoryStrings, deptCode),
+                           out.length(),
+                           segment.length(),
+                           crc32c(segment.data(), segment.length()),
+                           0});
+        out += segment;
+    }
+    writePod(out, 0, appendDirectory(out, 0, entries, directoryStrings));
+    return out;
+}
+
+/**
+ * Updates the snapshot at path so that it holds exactly the given departments, writing only the
+ * segments that changed. New segments and a new directory are appended to the file, then the
+ * header is rewritten in place to point at the new directory; until that last write, the file
+ * still reads as the previous snapshot. Unchanged segments stay where they are. Once dead
+ * segments would make up more than maxGarbageRatio of the file, the file is compacted instead:
+ * rewritten atomically with every live segment copied over as raw bytes.
+ *
+ * @param path               The path to an existing mapped snapshot.
+ * @param segments           Every department of the new snapshot, mapped to its encoded segment,
+ *                           or to std::nullopt to reuse the segment already in the file.
+ * @param maxGarbageRatio    The share of dead bytes in the file that triggers a compaction.
+ * @return What was written.
+ */
+MappedWriteStats MappedSnapshot::writeIncremental(
+    const std::string& path,
+    const std::map<std::string, std::optional<std::string>>& segments,
+    double maxGarbageRatio) {
+    MappedSnapshot base(path);
+    std::vector<std::optional<size_t>> reused;
+    reused.reserve(segments.size());
+    uint64_t liveBytes = sizeof(MappedSnapshotHeader);
+    uint64_t appendedBytes = 0;
+    for (const auto& [deptCode, segment] : segments) {
+        if (segment) {
+            liveBytes += segment->length();
+            appendedBytes += segment->length();
+            reused.push_back(std::nullopt);
+            continue;
+        }
+        std::optional<size_t> index = base.findDepartment(deptCode);
+        if (!index) {
+            throw std::runtime_error("Department " + deptCode + " is missing from snapshot " +
+                                     path);
+        }
+        liveBytes += base.directory[*index].segmentLength;
+        reused.push_back(index);
+    }
+    uint64_t directoryBytes = segments.size() * sizeof(MappedDirectoryEntry);
+    for (const auto& entry : segments) {
+        directoryBytes += entry.first.length();
+    }
+    liveBytes += directoryBytes;
+    appendedBytes += directoryBytes;
+    uint64_t fileBytes = base.size + appendedBytes;
+
+    MappedWriteStats stats;
+    std::vector<MappedDirectoryEntry> entries;
+    std::string directoryStrings;
+    std::string out;
+    if (static_cast<double>(fileBytes - liveBytes) > maxGarbageRatio * fileBytes) {
+        out.assign(sizeof(MappedSnapshotHeader), '\0');
+        size_t i = 0;
+        for (const auto& [deptCode, segment] : segments) {
+            std::string_view bytes = segment ? std::string_view(*segment)
+                                             : base.segmentBytes(*reused[i]);
+            entries.push_back({addString(directoryStrings, deptCode),
+                               out.length(),
+                               bytes.length(),
+                               crc32c(bytes.data(), bytes.length()),
+                               0});
+            out += bytes;
+            if (segment) {
+                stats.segmentsWritten++;
+            } else {
+                stats.segmentsReused++;
+            }
+            ++i;
+        }
+        writePod(out, 0, appendDirectory(out, 0, entries, directoryStrings));
+        writeAtomically(path, out);
+        stats.bytesWritten = out.length();
+        stats.compacted = true;
+        return stats;
+    }
+
+    size_t i = 0;
+    for (const auto& [deptCode, segment] : segments) {
+        if (segment) {
+            entries.push_back({addString(directoryStrings, deptCode),
+                               base.size + out.length(),
+                               segment->length(),
+                               crc32c(segment->data(), segment->length()),
+                               0});
+            out += *segment;
+            stats.segmentsWritten++;
+        } else {
+            const MappedDirectoryEntry& entry = base.directory[*reused[i]];
+            entries.push_back({addString(directoryStrings, deptCode),
+                               entry.segmentOffset,
+                               entry.segmentLength,
+                               entry.segmentCrc,
+                               0});
+            stats.segmentsReused++;
+        }
+        ++i;
+    }
+    MappedSnapshotHeader fileHeader = appendDirectory(out, base.size, entries, directoryStrings);
+    std::string headerBytes(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+
+    int fd = open(path.c_str(), O_WRONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + path + ": " + std::strerror(errno));
+    }
+    try {
+        writeAllAt(fd, out, base.size, path);
+        if (fsync(fd) != 0) {
+            throw std::runtime_error("Failed to sync " + path + ": " + std::strerror(errno));
+        }
+        writeAllAt(fd, headerBytes, 0, path);
+        if (fsync(fd) != 0) {
+            throw std::runtime_error("Failed to sync " + path + ": " + std::strerror(errno));
+        }
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    stats.bytesWritten = out.length() + headerBytes.length();
+    return stats;
+}
+
+/**
+ * Writes the bytes to a temporary file, syncs it and renames it over the destination, so that
+ * readers (including anyone with the old file mapped) never observe a partially written file.
+ * The directory is synced as well, so the rename itself survives a crash.
+ *
+ * @param path               The path to the destination file.
+ * @param bytes              The file contents.
+ */
+void MappedSnapshot::writeAtomically(const std::string& path, const std::string& bytes) {
+    std::string tempPath = path + ".tmp";
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + tempPath + ": " + std::strerror(errno));
+    }
+    const char* cursor = bytes.data();
+    size_t remaining = bytes.length();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, cursor, remaining);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0) {
+            close(fd);
+            throw std::runtime_error("Failed to write " + tempPath + ": " + std::strerror(errno));
+        }
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    if (fsync(fd) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to sync " + tempPath + ": " + std::strerror(errno));
+    }
+    close(fd);
+    std::filesystem::rename(tempPath, path);
+
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    int dirFd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+}
+
+/**
+ * Returns the number of departments in the snapshot.
+ *
+ * @return The department count.
+ */
+size_t MappedSnapshot::getDepartmentCount() const {
+    return header.departmentCount;
+}
+
+/**
+ * Finds a department in the directory by binary search, without touching any department
+ * segment.
+ *
+ * @param deptCode           The department code.
+ * @return The index of the department, or std::nullopt if it isn't in the snapshot.
+ */
+std::optional<size_t> MappedSnapshot::findDepartment(std::string_view deptCode) const {
+    size_t low = 0;
+    size_t high = getDepartmentCount();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        std::string_view code = getDepartmentCode(mid);
+        if (code == deptCode) {
+            return mid;
+        }
+        if (code < deptCode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * Returns the code of a department, pointing directly into the mapping. Departments are ordered
+ * by code.
+ *
+ * @param index              The index of the department in the directory.
+ * @return The department code.
+ */
+std::string_view MappedSnapshot::getDepartmentCode(size_t index) const {
+    const MappedStringRef& ref = directory[index].deptCode;
+    uint64_t stringsOffset = header.directoryOffset +
+                             static_cast<uint64_t>(header.departmentCount) *
+                                 sizeof(MappedDirectoryEntry);
+    if (static_cast<uint64_t>(ref.offset) + ref.length >
+        header.directoryOffset + header.directoryLength - stringsOffset) {
+        throw std::runtime_error("Snapshot " + path + " has a corrupt directory string");
+    }
+    return std::string_view(checkedRange(stringsOffset + ref.offset, ref.length), ref.length);
+}
+
+/**
+ * Returns the department chair of a department, pointing directly into the mapping.
+ *
+ * @param index              The index of the department in the directory.
+ * @return The department chair.
+ */
+std::string_view MappedSnapshot::getDepartmentChair(size_t index) const {
+    const MappedSegmentHeader& segment = segmentHeader(index);
+    return segmentString(segment, segment.departmentChair);
+}
+
+/**
+ * Returns the number of majors in a department.
+ *
+ * @param index              The index of the department in the directory.
+ * @return The number of majors.
+ */
+int MappedSnapshot::getNumberOfMajors(size_t index) const {
+    return segmentHeader(index).numberOfMajors;
+}
+
+/**
+ * Returns the number of courses in a department.
+ *
+ * @param index              The index of the department in the directory.
+ * @return The course count.
+ */
+size_t MappedSnapshot::getCourseCount(size_t index) const {
+    return segmentHeader(index).courseCount;
+}
+
+/**
+ * Returns a view of one course record. The strings in the view point directly into the mapping
+ * and stay valid for the lifetime of this object.
+ *
+ * @param index              The index of the department in the directory.
+ * @param courseIndex        The index of the course within the department, in course code order.
+ * @return The course view.
+ */
+MappedCourseView MappedSnapshot::getCourse(size_t index, size_t courseIndex) const {
+    const MappedSegmentHeader& segment = segmentHeader(index);
+    if (courseIndex >= segment.courseCount) {
+        throw std::out_of_range("Course index out of range");
+    }
+    const auto* record = reinterpret_cast<const MappedCourseRecord*>(
+        reinterpret_cast<const char*>(&segment) + sizeof(MappedSegmentHeader) +
+        courseIndex * sizeof(MappedCourseRecord));
+    return MappedCourseView{segmentString(segment, record->courseId),
+                            segmentString(segment, record->courseLocation),
+                            segmentString(segment, record->instructorName),
+                            segmentString(segment, record->courseTimeSlot),
+                            record->enrollmentCapacity,
+                            record->enrolledStudentCount};
+}
+
+/**
+ * Builds an in-memory Department from one segment of the snapshot after verifying the segment's
+ * checksum.
+ *
+ * @param index              The index of the department in the directory.
+ * @param arena              The arena to create the courses in, or nullptr for the heap.
+ * @return The department.
+ */
+Department MappedSnapshot::materialize(size_t index, const std::shared_ptr<Arena>& arena) const {
+    verifySegment(index);
+    const MappedSegmentHeader& segment = segmentHeader(index);
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    for (size_t i = 0; i < segment.courseCount; ++i) {
+        MappedCourseView view = getCourse(index, i);
+        auto course = arena ? arena->makeShared<Course>(view.enrollmentCapacity,
+                                                        view.instructorName,
+                                                        view.courseLocation,
+                                                        view.courseTimeSlot)
+                            : std::make_shared<Course>(view.enrollmentCapacity,
+                                                       view.instructorName,
+                                                       view.courseLocation,
+                                                       view.courseTimeSlot);
+        course->setEnrolledStudentCount(view.enrolledStudentCount);
+        courses.emplace_hint(courses.end(), std::string(view.courseId), std::move(course));
+    }
+    return Department(std::string(segmentString(segment, segment.deptCode)),
+                      std::move(courses),
+                      std::string(segmentString(segment, segment.departmentChair)),
+                      segment.numberOfMajors);
+}
+
+/**
+ * Builds several departments in parallel. Segments are independent byte ranges of the mapping,
+ * so workers need no coordination beyond claiming the next index; claiming one at a time keeps
+ * the threads busy when department sizes are skewed. In arena mode each thread creates its
+ * courses in an arena of its own.
+ *
+ * @param indices            The indices of the departments in the directory.
+ * @param threadCount        The number of threads to use; 0 or 1 builds on the calling thread.
+ * @param mode               Where to allocate the courses.
+ * @return The departments, in the order of indices.
+ */
+std::vector<Department> MappedSnapshot::materialize(const std::vector<size_t>& indices,
+                                                    size_t threadCount,
+                                                    AllocationMode mode) const {
+    auto makeArena = [mode]() {
+        return mode == AllocationMode::Arena ? std::make_shared<Arena>() : nullptr;
+    };
+    std::vector<Department> departments(indices.size());
+    threadCount = std::min(threadCount, indices.size());
+    if (threadCount <= 1) {
+        std::shared_ptr<Arena> arena = makeArena();
+        for (size_t i = 0; i < indices.size(); ++i) {
+            departments[i] = materialize(indices[i], arena);
+        }
+        return departments;
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::vector<std::exception_ptr> errors(threadCount);
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+    for (size_t t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t]() {
+            try {
+                std::shared_ptr<Arena> arena = makeArena();
+                for (size_t i = next++; i < indices.size() && !failed; i = next++) {
+                    departments[i] = materialize(indices[i], arena);
+                }
+            } catch (...) {
+                errors[t] = std::current_exception();
+                failed = true;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return departments;
+}
+
+/**
+ * Builds the full in-memory department mapping from the snapshot.
+ *
+ * @param threadCount        The number of threads to build departments with.
+ * @param mode               Where to allocate the courses.
+ * @return The department mapping.
+ */
+std::map<std::string, Department> MappedSnapshot::materializeAll(size_t threadCount,
+                                                                 AllocationMode mode) const {
+    std::vector<size_t> indices(getDepartmentCount());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        indices[i] = i;
+    }
+    std::vector<Department> departments = materialize(indices, threadCount, mode);
+
+    // The directory is sorted by code, so every insert lands at the end of the map.
+    std::map<std::string, Department> mapping;
+    for (size_t i = 0; i < departments.size(); ++i) {
+        mapping.emplace_hint(
+            mapping.end(), std::string(getDepartmentCode(i)), std::move(departments[i]));
+    }
+    return mapping;
+}
+
+/**
+ * Returns the header of a department segment after checking that the segment lies within the
+ * file and that its course records and string section lie within the segment.
+ */
+const MappedSegmentHeader& MappedSnapshot::segmentHeader(size_t index) const {
+    if (index >= header.departmentCount) {
+        throw std::out_of_range("Department index out of range");
+    }
+    const MappedDirectoryEntry& entry = directory[index];
+    if (entry.segmentLength < sizeof(MappedSegmentHeader) ||
+        entry.segmentOffset % alignof(MappedSegmentHeader) != 0) {
+        throw std::runtime_error("Snapshot " + path + " has a corrupt department segment");
+    }
+    const char* segmentData = checkedRange(entry.segmentOffset, entry.segmentLength);
+    const auto* segment = reinterpret_cast<const MappedSegmentHeader*>(segmentData);
+    uint64_t recordsEnd = sizeof(MappedSegmentHeader) +
+                          static_cast<uint64_t>(segment->courseCount) * sizeof(MappedCourseRecord);
+    if (recordsEnd > segment->stringsOffset ||
+        static_cast<uint64_t>(segment->stringsOffset) + segment->stringsLength >
+            entry.segmentLength) {
+        throw std::runtime_error("Snapshot " + path + " has a corrupt department segment");
+    }
+    return *segment;
+}
+
+/**
+ * Returns the raw bytes of a department segment after verifying its checksum.
+ *
+ * @param index              The index of the department in the directory.
+ * @return The segment bytes, pointing directly into the mapping.
+ */
+std::string_view MappedSnapshot::segmentBytes(size_t index) const {
+    verifySegment(index);
+    const MappedDirectoryEntry& entry = directory[index];
+    return std::string_view(data + entry.segmentOffset, entry.segmentLength);
+}
+
+/**
+ * Checks a department segment's bounds and checksum.
+ */
+void MappedSnapshot::verifySegment(size_t index) const {
+    segmentHeader(index);
+    const MappedDirectoryEntry& entry = directory[index];
+    if (crc32c(data + entry.segmentOffset, entry.segmentLength) != entry.segmentCrc) {
+        throw std::runtime_error("Snapshot " + path + " has a corrupt checksum in department " +
+                                 std::string(getDepartmentCode(index)));
+    }
+}
+
+/**
+ * Resolves a string reference within a department segment's string section.
+ */
+std::string_view MappedSnapshot::segmentString(const MappedSegmentHeader& segment,
+                                               MappedStringRef ref) const {
+    if (static_cast<uint64_t>(ref.offset) + ref.length > segment.stringsLength) {
+        throw std::runtime_error("Snapshot " + path + " has a corrupt string reference");
+    }
+    return std::string_view(
+        reinterpret_cast<const char*>(&segment) + segment.stringsOffset + ref.offset, ref.length);
+}
+
+/**
+ * Returns a pointer to the given byte range of the mapping, or throws if it lies outside the
+ * file.
+ */
+const char* MappedSnapshot::checkedRange(uint64_t offset, uint64_t length) const {
+    if (offset > size || length > size - offset) {
+        throw std::runtime_error("Snapshot " + path + " is truncated");
+    }
+    return data + offset;
+}
@@ -1,6 +1,8 @@
 // Copyright 2024 Jason Han
 #include "MyApp.h"
+#include "CatalogImporter.h"
 #include <iostream>
+#include <stdexcept>
 
 MyFileDatabase* MyApp::myFileDatabase = nullptr;
 bool MyApp::saveData = false;
@@ -18,17 +20,37 @@ void MyApp::run(const std::string& mode) {
         return;
     }
     myFileDatabase = new MyFileDatabase(0, "testfile.bin");
+    myFileDatabase->startCheckpointer(std::chrono::seconds(60), 1000);
     std::cout << "Start up" << std::endl;
 }
 
 /**
- *  Method that runs when app is terminated. If the app is in "setup" mode, save the default
- *  database contents to disk.
+ *  Replaces the contents of the default database with a registrar export (.csv, .jsonl or
+ *  .ndjson) and writes the snapshot.
+ *
+ *  @param path              The path to the export.
+ */
+void MyApp::importCatalog(const std::string& path) {
+    std::optional<ImportFormat> format = CatalogImporter::formatForPath(path);
+    if (!format) {
+        throw std::runtime_error("Unrecognized catalog export format: " + path);
+    }
+    saveData = true;
+    myFileDatabase = new MyFileDatabase(1, "testfile.bin");
+    CatalogImporter importer(*format);
+    std::cout << importer.importFile(path, *myFileDatabase).display();
+    std::cout << "Catalog Imported" << std::endl;
+}
+
+/**
+ *  Method that runs when app is terminated. Checkpoints the database contents to disk, which also
+ *  clears the write-ahead log. Runs on the main thread once the server has stopped, never inside
+ *  a signal handler: it takes locks and allocates.
  */
 void MyApp::onTermination() {
     std::cout << "Termination" << std::endl;
     if (saveData && myFileDatabase) {
-        myFileDatabase->saveContentsToFile();
+        myFileDatabase->checkpoint();
     }
     delete myFileDatabase;
     myFileDatabase = nullptr;
@@ -1,7 +1,280 @@
 // Copyright 2024 Jason Han
 #include "MyFileDatabase.h"
+#include "ByteReader.h"
+#include "PackedIndex.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * Reads a snapshot in the legacy stream format. The file is read into memory with one read and
+ * parsed from there, with every length checked against the bytes that remain.
+ *
+ * @param path               The path to the snapshot file.
+ * @param mode               Where to allocate the courses.
+ * @return The department mapping.
+ */
+std::map<std::string, Department> readLegacySnapshot(const std::string& path,
+                                                     AllocationMode mode) {
+    std::ifstream inFile(path, std::ios::binary);
+    if (!inFile) {
+        throw std::runtime_error("Failed to open snapshot " + path);
+    }
+    std::string bytes((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    inFile.close();
+
+    ByteReader reader(bytes, "Snapshot " + path);
+    // A department takes at least its key length, code length, chair length, majors and count.
+    constexpr uint64_t kMinDepartmentBytes = 4 * sizeof(uint64_t) + sizeof(int32_t);
+    uint64_t mapSize = reader.readU64();
+    if (mapSize > reader.remaining() / kMinDepartmentBytes) {
+        reader.fail("department count " + std::to_string(mapSize) +
+                    " exceeds the remaining bytes");
+    }
+    std::shared_ptr<Arena> arena =
+        mode == AllocationMode::Arena ? std::make_shared<Arena>() : nullptr;
+    std::map<std::string, Department> mapping;
+    for (uint64_t i = 0; i < mapSize; ++i) {
+        std::string key = reader.readString(reader.readU64());
+        Department dept;
+        dept.deserialize(reader, arena);
+        mapping[key] = std::move(dept);
+    }
+    reader.expectEnd();
+    return mapping;
+}
+
+/**
+ * Resolves the IDs a course column scan returned into course keys.
+ *
+ * @param columns            The scanned columns.
+ * @param courses            The matching course IDs.
+ * @return The keys of the courses.
+ */
+std::vector<CourseKey> keysOf(const CourseColumns& columns, const std::vector<uint32_t>& courses) {
+    std::vector<CourseKey> keys;
+    keys.reserve(courses.size());
+    for (uint32_t course : courses) {
+        keys.push_back(columns.getKey(course));
+    }
+    return keys;
+}
+
+/**
+ * Returns the generation of a new catalog. Generations count up from a random start drawn when the
+ * server starts, so no two catalogs share one, even across restarts, short of a 64-bit collision.
+ *
+ * @return The generation.
+ */
+uint64_t nextGeneration() {
+    static std::atomic<uint64_t> next = []() {
+        std::random_device random;
+        uint64_t start = uint64_t{random()} << 32 | random();
+        return start ^ static_cast<uint64_t>(
+                           std::chrono::system_clock::now().time_since_epoch().count());
+    }();
+    return next.fetch_add(1);
+}
+
+/**
+ * Converts the state a course change expects into the course's terms. A state read from another
+ * catalog matches no course in this one, and a state without a seat count was sent for a
+ * department, which no course is at either.
+ *
+ * @param expected           The expected state, if any.
+ * @param generation         The generation of the catalog the course is in.
+ * @param state              Set to the course state, or std::nullopt to match any.
+ * @return false if no course can be at the expected state.
+ */
+bool toCourseState(const std::optional<ExpectedState>& expected,
+                   uint64_t generation,
+                   std::optional<CourseState>& state) {
+    state = std::nullopt;
+    if (!expected) {
+        return true;
+    }
+    if (expected->generation != generation || !expected->count) {
+        return false;
+    }
+    state = CourseState{expected->version, *expected->count};
+    return true;
+}
+
+// How long a seat change waits for the newer version of a retired course to be published before
+// giving up. The department's writer publishes it right after retiring the course, so this only
+// runs out if that writer is stuck.
+constexpr std::chrono::seconds kSupersedeTimeout{1};
+
+}  // namespace
+
+/**
+ * Returns the checkpoint statistics as a human-readable string.
+ *
+ * @return The display string.
+ */
+std::string CheckpointStats::display() const {
+    std::ostringstream result;
+    result.setf(std::ios::fixed);
+    result.precision(2);
+    result << "checkpoints: " << checkpoints << "\n";
+    result << "checkpointFailures: " << failures << "\n";
+    result << "checkpointLastDurationMicros: " << lastDurationMicros << "\n";
+    result << "checkpointMaxDurationMicros: " << maxDurationMicros << "\n";
+    result << "checkpointAverageDurationMicros: "
+           << (checkpoints ? static_cast<double>(totalDurationMicros) / checkpoints : 0.0)
+           << "\n";
+    result << "checkpointLastPauseMicros: " << lastPauseMicros << "\n";
+    result << "checkpointMaxPauseMicros: " << maxPauseMicros << "\n";
+    result << "checkpointLastBytes: " << lastBytes << "\n";
+    result << "checkpointTotalBytes: " << totalBytes << "\n";
+    result << "checkpointLastSegmentsWritten: " << lastSegmentsWritten << "\n";
+    result << "checkpointLastSegmentsReused: " << lastSegmentsReused << "\n";
+    result << "checkpointCompactions: " << compactions << "\n";
+    return result.str();
+}
+
+// One published set of departments. Its slots hold the current version of each department and are
+// swapped as a whole by writers, in order of department code. A catalog opened from a mapped
+// snapshot takes its codes from the snapshot's directory and loads each department on first
+// lookup; any other catalog is fully loaded and keeps its own codes. Either way the codes are
+// hashed when the catalog is built, so lookups neither allocate nor search.
+struct MyFileDatabase::Catalog {
+    struct Slot {
+        std::atomic<const Department*> dept{nullptr};
+        std::atomic<bool> dirty{false};
+    };
+
+    explicit Catalog(std::map<std::string, Department> mapping);
+    explicit Catalog(std::shared_ptr<const MappedSnapshot> snapshot);
+    ~Catalog();
+
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    std::optional<size_t> find(std::string_view deptCode) const;
+    std::string_view getCode(size_t index) const;
+    std::map<std::string, Department> copyDepartments(
+        const std::vector<const Department*>& departments) const;
+
+    std::shared_ptr<const MappedSnapshot> snapshot;
+    std::vector<std::string> codes;
+    CodeIndex<size_t> index;
+    size_t size;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> loadedCount;
+    // Drawn from nextGeneration(), so versions read from another catalog never match this one's.
+    uint64_t generation;
+    // Built on the first catalog-wide scan or lookup, then kept up to date by writers.
+    std::atomic<CourseColumns*> columns{nullptr};
+    // Built on the first time query; writers that change a course's time retire it.
+    std::atomic<const TimeIndex*> timeIndex{nullptr};
+    // Built on the first search; writers add the instructors and locations they assign.
+    std::atomic<SearchIndex*> searchIndex{nullptr};
+};
+
+/**
+ * Builds a fully loaded catalog. Every department starts out dirty.
+ *
+ * @param mapping            The mapping of department codes to departments.
+ */
+MyFileDatabase::Catalog::Catalog(std::map<std::string, Department> mapping)
+    : size(mapping.size()),
+      slots(new Slot[mapping.size()]),
+      loadedCount(mapping.size()),
+      generation(nextGeneration()) {
+    codes.reserve(size);
+    for (auto& [deptCode, dept] : mapping) {
+        slots[codes.size()].dept = new Department(std::move(dept));
+        slots[codes.size()].dirty = true;
+        codes.push_back(deptCode);
+    }
+    // codes doesn't grow past this point, so the views the index keeps stay valid.
+    index.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        index.insert(codes[i], i);
+    }
+}
+
+/**
+ * Builds a catalog whose departments are loaded from a mapped snapshot on first lookup.
+ *
+ * @param snapshot           The open snapshot.
+ */
+MyFileDatabase::Catalog::Catalog(std::shared_ptr<const MappedSnapshot> snapshot)
+    : snapshot(std::move(snapshot)),
+      size(this->snapshot->getDepartmentCount()),
+      slots(new Slot[size]),
+      loadedCount(0),
+      generation(nextGeneration()) {
+    index.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        index.insert(this->snapshot->getDepartmentCode(i), i);
+    }
+}
+
+/**
+ * Deletes the current version of every loaded department. Only runs once the catalog has been
+ * retired and no reader can still be using it.
+ */
+MyFileDatabase::Catalog::~Catalog() {
+    for (size_t i = 0; i < size; ++i) {
+        delete slots[i].dept.load();
+    }
+    delete columns.load();
+    delete timeIndex.load();
+    delete searchIndex.load();
+}
+
+/**
+ * Finds the slot of a department.
+ *
+ * @param deptCode           The department code.
+ * @return The slot index, or std::nullopt if the department doesn't exist.
+ */
+std::optional<size_t> MyFileDatabase::Catalog::find(std::string_view deptCode) const {
+    const size_t* slot = index.find(deptCode);
+    if (!slot) {
+        return std::nullopt;
+    }
+    return *slot;
+}
+
+/**
+ * Returns the code of the department in a slot.
+ *
+ * @param index              The slot index.
+ * @return The department code.
+ */
+std::string_view MyFileDatabase::Catalog::getCode(size_t index) const {
+    return snapshot ? snapshot->getDepartmentCode(index) : std::string_view(codes[index]);
+}
+
+/**
+ * Copies departments of the catalog into a mapping keyed by department code. Departments are
+ * immutable, so only their course pointers are copied, not the courses. Called with an epoch guard
+ * held; departments that aren't loaded are skipped.
+ *
+ * @param departments        The version of each department, indexed by slot.
+ * @return The department mapping.
+ */
+std::map<std::string, Department> MyFileDatabase::Catalog::copyDepartments(
+    const std::vector<const Department*>& departments) const {
+    std::map<std::string, Department> mapping;
+    for (size_t i = 0; i < departments.size(); ++i) {
+        if (departments[i]) {
+            mapping.emplace_hint(mapping.end(), std::string(getCode(i)), *departments[i]);
+        }
+    }
+    return mapping;
+}
 
 /**
  * Constructs a MyFileDatabase object and loads up the data structure with
@@ -10,66 +283,714 @@
  * @param flag               Used to distinguish mode of database
  * @param filePath           The path to the file containing the entries of the database
  */
-MyFileDatabase::MyFileDatabase(int flag, const std::string& filePath) : filePath(filePath) {
+MyFileDatabase::MyFileDatabase(int flag, const std::string& filePath)
+    : catalog(new Catalog(std::map<std::string, Department>())),
+      filePath(filePath),
+      snapshotFormat(SnapshotFormat::Mapped),
+      snapshotCompression(CompactCompression::Zlib),
+      loadThreadCount(std::max(1u, std::thread::hardware_concurrency())),
+      allocationMode(AllocationMode::Arena),
+      compactionGarbageRatio(0.5),
+      writeAheadLog(filePath + ".wal"),
+      writers(std::make_unique<DepartmentWriters>(0)),
+      mutationsSinceCheckpoint(0),
+      checkpointMutationThreshold(0),
+      forceFullCheckpoint(true),
+      checkpointerStopping(false) {
     if (flag == 0) {
-        deSerializeObjectFromFile();
+        try {
+            deSerializeObjectFromFile();
+            replayWriteAheadLog();
+        } catch (...) {
+            // The destructor won't run, and no reader can have seen the catalog yet.
+            delete catalog.load();
+            throw;
+        }
     }
 }
 
 /**
- * Sets the department mapping of the database.
+ * Stops the background checkpointer, if it is running, and retires the catalog.
+ */
+MyFileDatabase::~MyFileDatabase() {
+    stopCheckpointer();
+    EpochReclaimer::retire(catalog.exchange(nullptr));
+}
+
+/**
+ * Sets the department mapping of the database. Views of the previous mapping keep seeing it until
+ * they are released. The courses become the database's: their seat counts change in place.
  *
  * @param mapping            The mapping of department names to Department objects
  */
-void MyFileDatabase::setMapping(const std::map<std::string, Department>& mapping) {
-    departmentMapping = mapping;
+void MyFileDatabase::setMapping(std::map<std::string, Department> mapping) {
+    auto next = std::make_unique<Catalog>(std::move(mapping));
+    std::lock_guard<DepartmentWriters> pause(*writers);
+    publishCatalog(next.release());
+    forceFullCheckpoint = true;
 }
 
 /**
- * Gets the department mapping of the database.
+ * Replaces the published catalog and retires the previous one. Called with every department
+ * writer excluded.
+ *
+ * @param next               The catalog to publish.
+ */
+void MyFileDatabase::publishCatalog(Catalog* next) {
+    EpochReclaimer::retire(catalog.exchange(next));
+}
+
+/**
+ * Publishes a new version of a department, marks it for the next incremental checkpoint and
+ * retires the previous version. Called by the department's writer. The new version is published
+ * before anything that can throw.
+ *
+ * @param catalog            The published catalog.
+ * @param index              The department's slot.
+ * @param next               The new version.
+ */
+void MyFileDatabase::publishDepartment(Catalog& catalog, size_t index, const Department* next) {
+    const Department* previous = catalog.slots[index].dept.exchange(next);
+    catalog.slots[index].dirty = true;
+    EpochReclaimer::retire(previous);
+}
+
+/**
+ * Gets the department mapping of the database. Loads every department that hasn't been loaded
+ * yet. Seat counts change in place, so the courses are copied too, and the mapping doesn't change
+ * under the caller.
  *
  * @return The department mapping
  */
 std::map<std::string, Department> MyFileDatabase::getDepartmentMapping() const {
-    return departmentMapping;
+    loadAllDepartments();
+    EpochGuard guard;
+    const Catalog& current = *catalog.load();
+    std::vector<const Department*> departments(current.size);
+    for (size_t i = 0; i < current.size; ++i) {
+        departments[i] = current.slots[i].dept.load();
+    }
+    std::map<std::string, Department> mapping = current.copyDepartments(departments);
+    for (auto& [deptCode, dept] : mapping) {
+        std::map<std::string, std::shared_ptr<Course>> courses = dept.getCourseSelection();
+        for (const auto& [courseCode, course] : courses) {
+            dept.addCourse(courseCode, std::make_shared<Course>(*course));
+        }
+    }
+    return mapping;
+}
+
+/**
+ * Returns a read-only view of a department, loading it from the snapshot on first use. Nothing is
+ * copied and no lock is taken, so the cost depends neither on the size of the catalog nor on
+ * concurrent requests. Safe to call from any number of request threads.
+ *
+ * @param deptCode           The department code.
+ * @return The view, which is empty if the department doesn't exist.
+ */
+DepartmentView MyFileDatabase::viewDepartment(std::string_view deptCode) const {
+    EpochGuard guard;
+    Catalog& current = *catalog.load();
+    std::optional<size_t> index = current.find(deptCode);
+    if (!index) {
+        return DepartmentView();
+    }
+    return DepartmentView(std::move(guard), loadDepartment(current, *index), current.generation);
+}
+
+/**
+ * Returns a read-only view of a course, loading its department from the snapshot on first use.
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @return The view, which is empty if the department or the course doesn't exist.
+ */
+CourseView MyFileDatabase::viewCourse(std::string_view deptCode,
+                                      std::string_view courseCode) const {
+    EpochGuard guard;
+    Catalog& current = *catalog.load();
+    std::optional<size_t> index = current.find(deptCode);
+    const Course* course =
+        index ? loadDepartment(current, *index)->findCourse(courseCode) : nullptr;
+    if (!course) {
+        return CourseView();
+    }
+    return CourseView(std::move(guard), course, current.generation);
+}
+
+/**
+ * Returns how many departments are currently held in memory.
+ *
+ * @return The number of loaded departments.
+ */
+size_t MyFileDatabase::getLoadedDepartmentCount() const {
+    EpochGuard guard;
+    return catalog.load()->loadedCount;
+}
+
+/**
+ * Returns the current version of a department, materializing it from the catalog's snapshot if it
+ * hasn't been loaded yet. No lock is taken: if two threads race to load the same department, the
+ * first one to publish it wins and the other discards its copy. Called with an epoch guard held
+ * or by the department's writer.
+ *
+ * @param catalog            The published catalog.
+ * @param index              The department's slot.
+ * @return The department.
+ */
+const Department* MyFileDatabase::loadDepartment(Catalog& catalog, size_t index) const {
+    const Department* dept = catalog.slots[index].dept.load();
+    if (dept) {
+        return dept;
+    }
+    std::shared_ptr<Arena> arena =
+        allocationMode == AllocationMode::Arena ? std::make_shared<Arena>() : nullptr;
+    auto loaded =
+        std::make_unique<const Department>(catalog.snapshot->materialize(index, arena));
+    if (!catalog.slots[index].dept.compare_exchange_strong(dept, loaded.get())) {
+        return dept;
+    }
+    catalog.loadedCount++;
+    return loaded.release();
+}
+
+/**
+ * Materializes every department that hasn't been loaded yet, in parallel across loadThreadCount
+ * threads. Readers carry on meanwhile.
+ */
+void MyFileDatabase::loadAllDepartments() const {
+    EpochGuard guard;
+    Catalog& current = *catalog.load();
+    if (!current.snapshot || current.loadedCount == current.size) {
+        return;
+    }
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < current.size; ++i) {
+        if (!current.slots[i].dept.load()) {
+            missing.push_back(i);
+        }
+    }
+
+    std::vector<Department> departments =
+        current.snapshot->materialize(missing, loadThreadCount, allocationMode);
+    for (size_t i = 0; i < missing.size(); ++i) {
+        auto loaded = std::make_unique<const Department>(std::move(departments[i]));
+        const Department* expected = nullptr;
+        if (current.slots[missing[i]].dept.compare_exchange_strong(expected, loaded.get())) {
+            loaded.release();
+            current.loadedCount++;
+        }
+    }
+}
+
+/**
+ * Returns the course columns of a catalog, building them on first use. Building loads every
+ * department and excludes every department writer while it reads them, so no change can slip in
+ * between the read and the columns being published; from then on, writers update the columns as
+ * they publish. Called with an epoch guard held.
+ *
+ * @param catalog            The published catalog.
+ * @return The course columns.
+ */
+const CourseColumns& MyFileDatabase::loadColumns(Catalog& catalog) const {
+    if (const CourseColumns* columns = catalog.columns.load()) {
+        return *columns;
+    }
+    loadAllDepartments();
+    std::lock_guard<DepartmentWriters> pause(*writers);
+    if (const CourseColumns* columns = catalog.columns.load()) {
+        return *columns;
+    }
+    std::vector<std::pair<std::string_view, const Department*>> departments;
+    departments.reserve(catalog.size);
+    for (size_t i = 0; i < catalog.size; ++i) {
+        departments.emplace_back(catalog.getCode(i), loadDepartment(catalog, i));
+    }
+    auto columns = new CourseColumns(departments);
+    catalog.columns = columns;
+    return *columns;
+}
+
+/**
+ * Returns the time index of a catalog, building it from the course columns on first use. Writers
+ * retire the index when they change a course's time, so the next query rebuilds it. Called with
+ * an epoch guard held.
+ *
+ * @param catalog            The published catalog.
+ * @return The time index.
+ */
+const TimeIndex& MyFileDatabase::loadTimeIndex(Catalog& catalog) const {
+    if (const TimeIndex* index = catalog.timeIndex.load()) {
+        return *index;
+    }
+    const CourseColumns& columns = loadColumns(catalog);
+    std::lock_guard<DepartmentWriters> pause(*writers);
+    if (const TimeIndex* index = catalog.timeIndex.load()) {
+        return *index;
+    }
+    std::vector<std::pair<TimeRange, uint32_t>> courses;
+    courses.reserve(columns.size());
+    for (uint32_t i = 0; i < columns.size(); ++i) {
+        if (std::optional<TimeRange> range = columns.getTimeRange(i)) {
+            courses.emplace_back(*range, i);
+        }
+    }
+    auto index = new TimeIndex(std::move(courses));
+    catalog.timeIndex = index;
+    return *index;
+}
+
+/**
+ * Returns the search index of a catalog, building it from the course columns on first use: every
+ * course code, instructor and location becomes a term. Called with an epoch guard held.
+ *
+ * @param catalog            The published catalog.
+ * @return The search index.
+ */
+const SearchIndex& MyFileDatabase::loadSearchIndex(Catalog& catalog) const {
+    if (const SearchIndex* index = catalog.searchIndex.load()) {
+        return *index;
+    }
+    const CourseColumns& columns = loadColumns(catalog);
+    std::lock_guard<DepartmentWriters> pause(*writers);
+    if (const SearchIndex* index = catalog.searchIndex.load()) {
+        return *index;
+    }
+    auto index = new SearchIndex();
+    for (uint32_t i = 0; i < columns.size(); ++i) {
+        CourseKey key = columns.getKey(i);
+        index->addCourse(i, key.deptCode + " " + key.courseCode);
+        index->addName(SearchField::Instructor, columns.getInstructor(i));
+        index->addName(SearchField::Location, columns.getLocation(i));
+    }
+    catalog.searchIndex = index;
+    return *index;
+}
+
+/**
+ * Returns every course whose enrollment has reached its capacity, found by a scan over the
+ * course columns.
+ *
+ * @return The full courses, in department and course order.
+ */
+std::vector<CourseKey> MyFileDatabase::findFullCourses() const {
+    EpochGuard guard;
+    const CourseColumns& columns = loadColumns(*catalog.load());
+    return keysOf(columns, columns.findFull());
+}
+
+/**
+ * Returns every course held in a location, found through the location index.
+ *
+ * @param location           The location.
+ * @return The matching courses, in department and course order.
+ */
+std::vector<CourseKey> MyFileDatabase::findCoursesByLocation(std::string_view location) const {
+    std::optional<InternedString> interned = InternedString::find(location);
+    if (!interned) {
+        return {};
+    }
+    EpochGuard guard;
+    const CourseColumns& columns = loadColumns(*catalog.load());
+    return keysOf(columns, columns.findByLocation(*interned));
+}
+
+/**
+ * Returns every course taught by an instructor, found through the instructor index.
+ *
+ * @param instructor         The instructor.
+ * @return The matching courses, in department and course order.
+ */
+std::vector<CourseKey> MyFileDatabase::findCoursesByInstructor(
+    std::string_view instructor) const {
+    std::optional<InternedString> interned = InternedString::find(instructor);
+    if (!interned) {
+        return {};
+    }
+    EpochGuard guard;
+    const CourseColumns& columns = loadColumns(*catalog.load());
+    return keysOf(columns, columns.findByInstructor(*interned));
+}
+
+/**
+ * Returns every course in a time slot, found through the time slot index. The slot must match
+ * the course's exactly; findCoursesMeetingDuring() matches by overlap instead.
+ *
+ * @param timeSlot           The time slot.
+ * @return The matching courses, in department and course order.
+ */
+std::vector<CourseKey> MyFileDatabase::findCoursesByTimeSlot(std::string_view timeSlot) const {
+    std::optional<InternedString> interned = InternedString::find(timeSlot);
+    if (!interned) {
+        return {};
+    }
+    EpochGuard guard;
+    const CourseColumns& columns = loadColumns(*catalog.load());
+    return keysOf(columns, columns.findByTimeSlot(*interned));
+}
+
+/**
+ * Returns every course that meets at some point during a time range, found through the time
+ * index. Courses whose time slot doesn't parse never match.
+ *
+ * @param range              The time range.
+ * @return The matching courses, in department and course order.
+ */
+std::vector<CourseKey> MyFileDatabase::findCoursesMeetingDuring(TimeRange range) const {
+    EpochGuard guard;
+    Catalog& current = *catalog.load();
+    const TimeIndex& index = loadTimeIndex(current);
+    return keysOf(*current.columns.load(), index.findOverlapping(range));
+}
+
+/**
+ * Searches the course codes, instructors and locations of the catalog, by prefix and fuzzily.
+ * Matching terms are expanded into the courses they name, best term first and each course once,
+ * so an instructor or location match lists all of its courses in department and course order.
+ *
+ * @param query              The query, such as "Kais" or "Dolen".
+ * @param limit              The most courses to return.
+ * @return The courses found, best first.
+ */
+std::vector<SearchResult> MyFileDatabase::search(std::string_view query, size_t limit) const {
+    EpochGuard guard;
+    Catalog& current = *catalog.load();
+    const SearchIndex& index = loadSearchIndex(current);
+    const CourseColumns& columns = *current.columns.load();
+    std::vector<SearchResult> results;
+    std::vector<uint32_t> found;
+    for (const SearchMatch& match : index.search(query, limit)) {
+        std::vector<uint32_t> courses;
+        switch (match.field) {
+            case SearchField::Course:
+                courses.push_back(match.course);
+                break;
+            case SearchField::Instructor:
+                courses = columns.findByInstructor(match.name);
+                break;
+            case SearchField::Location:
+                courses = columns.findByLocation(match.name);
+                break;
+        }
+        for (uint32_t course : courses) {
+            if (results.size() == limit) {
+                return results;
+            }
+            if (std::find(found.begin(), found.end(), course) != found.end()) {
+                continue;
+            }
+            found.push_back(course);
+            results.push_back(
+                SearchResult{columns.getKey(course), match.field, match.text, match.score});
+        }
+    }
+    return results;
+}
+
+/**
+ * Sets the format that saveContentsToFile() writes. Loading detects the format from the file.
+ *
+ * @param format             The snapshot format.
+ */
+void MyFileDatabase::setSnapshotFormat(SnapshotFormat format) {
+    snapshotFormat = format;
+}
+
+/**
+ * Sets whether snapshots in the compact format are block-compressed. Defaults to zlib.
+ *
+ * @param compression        The block compression.
+ */
+void MyFileDatabase::setSnapshotCompression(CompactCompression compression) {
+    snapshotCompression = compression;
 }
 
 /**
  * Saves the contents of the internal data structure to the file. Contents of the file are
- * overwritten with this operation.
+ * replaced atomically with this operation.
  */
 void MyFileDatabase::saveContentsToFile() const {
-    std::ofstream outFile(filePath, std::ios::binary);
-    size_t mapSize = departmentMapping.size();
-    outFile.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
-    for (const auto& it : departmentMapping) {
+    MappedSnapshot::writeAtomically(filePath, encodeSnapshot(getDepartmentMapping()));
+}
+
+/**
+ * Encodes a department mapping in the configured snapshot format.
+ *
+ * @param mapping            The department mapping.
+ * @return The snapshot file contents.
+ */
+std::string MyFileDatabase::encodeSnapshot(
+    const std::map<std::string, Department>& mapping) const {
+    if (snapshotFormat == SnapshotFormat::Mapped) {
+        return MappedSnapshot::encode(mapping);
+    }
+    if (snapshotFormat == SnapshotFormat::Compact) {
+        return CompactSnapshot::encode(mapping, snapshotCompression);
+    }
+    std::ostringstream out(std::ios::binary);
+    size_t mapSize = mapping.size();
+    out.write(reinterpret_cast<const char*>(&mapSize), sizeof(mapSize));
+    for (const auto& it : mapping) {
         size_t keyLen = it.first.length();
-        outFile.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
-        outFile.write(it.first.c_str(), keyLen);
-        it.second.serialize(outFile);
+        out.write(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+        out.write(it.first.c_str(), keyLen);
+        it.second.serialize(out);
     }
-    outFile.close();
+    return out.str();
 }
 
 /**
- * De-serializes the object from the file and returns the department mapping.
- *
- * @return The de-serialized department mapping.
+ * De-serializes the object from the file and publishes it as the catalog. Files in the mapped
+ * format are opened through mmap and only their directory is read; each department is loaded on
+ * first lookup. Compact snapshots are read in full, and anything else is read in full as the
+ * legacy stream format: the file is read into memory with one read and parsed from there, with
+ * every length checked against the bytes that remain. A missing or corrupt file throws and leaves
+ * the catalog as it was.
  */
 void MyFileDatabase::deSerializeObjectFromFile() {
-    std::ifstream inFile(filePath, std::ios::binary);
-    size_t mapSize;
-    inFile.read(reinterpret_cast<char*>(&mapSize), sizeof(mapSize));
-    for (size_t i = 0; i < mapSize; ++i) {
-        size_t keyLen;
-        inFile.read(reinterpret_cast<char*>(&keyLen), sizeof(keyLen));
-        std::string key(keyLen, ' ');
-        inFile.read(&key[0], keyLen);
-        Department dept;
-        dept.deserialize(inFile);
-        departmentMapping[key] = dept;
+    std::unique_ptr<Catalog> next;
+    bool mapped = MappedSnapshot::isMappedSnapshot(filePath);
+    if (mapped) {
+        next = std::make_unique<Catalog>(std::make_shared<const MappedSnapshot>(filePath));
+    } else if (CompactSnapshot::isCompactSnapshot(filePath)) {
+        next = std::make_unique<Catalog>(CompactSnapshot::read(filePath, allocationMode));
+    } else {
+        next = std::make_unique<Catalog>(readLegacySnapshot(filePath, allocationMode));
+    }
+    std::lock_guard<DepartmentWriters> pause(*writers);
+    publishCatalog(next.release());
+    forceFullCheckpoint = !mapped;
+}
+
+/**
+ * Sets the number of threads used to load every remaining department of a mapped snapshot at
+ * once. Defaults to the number of hardware threads.
+ *
+ * @param threadCount        The number of threads.
+ */
+void MyFileDatabase::setLoadThreadCount(size_t threadCount) {
+    loadThreadCount = std::max<size_t>(1, threadCount);
+}
+
+/**
+ * Opts into owner threads that apply changes to departments (see DepartmentWriters), with
+ * departments hashed onto them; a hot department can be given an owner of its own by assigning
+ * every other department elsewhere. By default there are none, and each change runs on its
+ * request thread under its department's stripe of a striped mutex, which is faster unless a few
+ * departments take most changes on a host with cores to spare. Must not be called while changes
+ * are being made.
+ *
+ * @param threadCount        The number of owner threads, or 0 to go back to the striped mutex.
+ * @param assignment         Departments mapped to the index of their owner thread; any other
+ *                           department is hashed onto one.
+ */
+void MyFileDatabase::setWriterThreads(size_t threadCount,
+                                      std::map<std::string, size_t> assignment) {
+    writers = std::make_unique<DepartmentWriters>(threadCount, std::move(assignment));
+}
+
+/**
+ * Sets where departments loaded from now on allocate their courses. In arena mode, which is the
+ * default, the courses of each load come from the contiguous slabs of an Arena, which is freed in
+ * one step once no catalog version refers to any of them.
+ *
+ * @param mode               The allocation mode.
+ */
+void MyFileDatabase::setAllocationMode(AllocationMode mode) {
+    allocationMode = mode;
+}
+
+/**
+ * Sets how much of a mapped snapshot file may be taken up by segments that incremental
+ * checkpoints have superseded before the next checkpoint compacts it.
+ *
+ * @param ratio              The share of dead bytes, between 0 and 1.
+ */
+void MyFileDatabase::setCompactionGarbageRatio(double ratio) {
+    compactionGarbageRatio = ratio;
+}
+
+/**
+ * Writes a point-in-time image of the catalog to the file and then discards the write-ahead log
+ * records it covers. Published departments are immutable, so the image is captured as pointers to
+ * their current versions: mutations are held off only while those pointers are collected and the
+ * log is rotated. The image is encoded, written and synced while requests carry on, and records
+ * logged meanwhile go to the new log file. Readers are never blocked. Seat counts change in place
+ * and may reach the image after the rotation, but they are logged as absolute values, so
+ * replaying the new log over the image still ends at the right count.
+ *
+ * In the mapped format, only departments that changed since the last checkpoint are encoded and
+ * appended to the existing file, so the I/O scales with the write set rather than the catalog;
+ * the file is compacted once superseded segments pile up. The whole catalog is rewritten after
+ * setMapping(), after a failed checkpoint, and when the file isn't a mapped snapshot yet.
+ */
+void MyFileDatabase::checkpoint() {
+    std::lock_guard<std::mutex> checkpointLock(checkpointMutex);
+    auto start = std::chrono::steady_clock::now();
+    bool incremental = snapshotFormat == SnapshotFormat::Mapped && !forceFullCheckpoint &&
+                       MappedSnapshot::isMappedSnapshot(filePath);
+    uint64_t pauseMicros = 0;
+    MappedWriteStats written;
+    try {
+        if (!incremental) {
+            loadAllDepartments();
+        }
+        EpochGuard guard;
+        const Catalog* image;
+        std::vector<const Department*> departments;
+        {
+            std::lock_guard<DepartmentWriters> pause(*writers);
+            auto pauseStart = std::chrono::steady_clock::now();
+            writeAheadLog.rotate();
+            Catalog& current = *catalog.load();
+            departments.resize(current.size);
+            for (size_t i = 0; i < current.size; ++i) {
+                bool dirty = current.slots[i].dirty.exchange(false);
+                if (!incremental) {
+                    departments[i] = loadDepartment(current, i);
+                } else if (dirty) {
+                    departments[i] = current.slots[i].dept.load();
+                }
+            }
+            image = &current;
+            forceFullCheckpoint = false;
+            mutationsSinceCheckpoint = 0;
+            pauseMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - pauseStart)
+                              .count();
+        }
+        if (incremental) {
+            // Every department in the catalog, mapped to its new segment, or to std::nullopt if
+            // the segment in the file is still current.
+            std::map<std::string, std::optional<std::string>> segments;
+            for (size_t i = 0; i < departments.size(); ++i) {
+                std::optional<std::string> segment;
+                if (departments[i]) {
+                    segment = MappedSnapshot::encodeSegment(*departments[i]);
+                }
+                segments.emplace(std::string(image->getCode(i)), std::move(segment));
+            }
+            written = MappedSnapshot::writeIncremental(filePath, segments, compactionGarbageRatio);
+        } else {
+            std::string bytes = encodeSnapshot(image->copyDepartments(departments));
+            MappedSnapshot::writeAtomically(filePath, bytes);
+            written.bytesWritten = bytes.length();
+            written.segmentsWritten = departments.size();
+        }
+        writeAheadLog.discardRotated();
+    } catch (...) {
+        // The dirty flags were cleared for an image that never made it to disk.
+        forceFullCheckpoint = true;
+        std::lock_guard<std::mutex> lock(checkpointerMutex);
+        checkpointStats.failures++;
+        throw;
+    }
+    uint64_t durationMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count();
+
+    std::lock_guard<std::mutex> lock(checkpointerMutex);
+    checkpointStats.checkpoints++;
+    checkpointStats.lastDurationMicros = durationMicros;
+    checkpointStats.maxDurationMicros =
+        std::max(checkpointStats.maxDurationMicros, durationMicros);
+    checkpointStats.totalDurationMicros += durationMicros;
+    checkpointStats.lastPauseMicros = pauseMicros;
+    checkpointStats.maxPauseMicros = std::max(checkpointStats.maxPauseMicros, pauseMicros);
+    checkpointStats.lastBytes = written.bytesWritten;
+    checkpointStats.totalBytes += written.bytesWritten;
+    checkpointStats.lastSegmentsWritten = written.segmentsWritten;
+    checkpointStats.lastSegmentsReused = written.segmentsReused;
+    if (written.compacted) {
+        checkpointStats.compactions++;
+    }
+}
+
+/**
+ * Starts a background thread that checkpoints the database every interval, or as soon as
+ * mutationThreshold mutations have been applied since the last checkpoint, whichever comes
+ * first. Intervals with no mutations are skipped. Restarts the thread if it is already running.
+ *
+ * @param interval           The time between checkpoints; zero disables the timer.
+ * @param mutationThreshold  The number of mutations that triggers a checkpoint; zero disables
+ *                           the trigger.
+ */
+void MyFileDatabase::startCheckpointer(std::chrono::milliseconds interval,
+                                       uint64_t mutationThreshold) {
+    stopCheckpointer();
+    checkpointMutationThreshold = mutationThreshold;
+    checkpointer = std::thread(&MyFileDatabase::runCheckpointer, this, interval);
+}
+
+/**
+ * Stops the background checkpointer and waits for a checkpoint in progress to finish.
+ */
+void MyFileDatabase::stopCheckpointer() {
+    {
+        std::lock_guard<std::mutex> lock(checkpointerMutex);
+        checkpointerStopping = true;
+    }
+    checkpointerCondition.notify_all();
+    if (checkpointer.joinable()) {
+        checkpointer.join();
+    }
+    std::lock_guard<std::mutex> lock(checkpointerMutex);
+    checkpointerStopping = false;
+    checkpointMutationThreshold = 0;
+}
+
+/**
+ * Returns the checkpoint statistics.
+ *
+ * @return The statistics.
+ */
+CheckpointStats MyFileDatabase::getCheckpointStats() const {
+    std::lock_guard<std::mutex> lock(checkpointerMutex);
+    return checkpointStats;
+}
+
+/**
+ * Body of the background checkpointer: checkpoints whenever the interval elapses or the mutation
+ * threshold is reached, skipping intervals without mutations.
+ *
+ * @param interval           The time between checkpoints; zero disables the timer.
+ */
+void MyFileDatabase::runCheckpointer(std::chrono::milliseconds interval) {
+    auto due = [this] {
+        uint64_t threshold = checkpointMutationThreshold;
+        return checkpointerStopping ||
+               (threshold > 0 && mutationsSinceCheckpoint >= threshold);
+    };
+    std::unique_lock<std::mutex> lock(checkpointerMutex);
+    while (!checkpointerStopping) {
+        if (interval.count() > 0) {
+            checkpointerCondition.wait_for(lock, interval, due);
+        } else {
+            checkpointerCondition.wait(lock, due);
+        }
+        if (checkpointerStopping || mutationsSinceCheckpoint == 0) {
+            continue;
+        }
+        lock.unlock();
+        try {
+            checkpoint();
+        } catch (const std::exception& e) {
+            std::cerr << "Background checkpoint failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+/**
+ * Counts an applied mutation towards the checkpointer's threshold and wakes the checkpointer when
+ * the threshold is reached.
+ */
+void MyFileDatabase::noteMutation() {
+    uint64_t threshold = checkpointMutationThreshold;
+    if (++mutationsSinceCheckpoint == threshold) {
+        std::lock_guard<std::mutex> lock(checkpointerMutex);
+        checkpointerCondition.notify_all();
     }
-    inFile.close();
 }
 
 /**
@@ -78,9 +999,535 @@ void MyFileDatabase::deSerializeObjectFromFile() {
  * @return A string representation of the database.
  */
 std::string MyFileDatabase::display() const {
+    loadAllDepartments();
+    EpochGuard guard;
+    Catalog& current = *catalog.load();
     std::string result;
-    for (const auto& it : departmentMapping) {
-        result += "For the " + it.first + " department:\n" + it.second.display() + "\n";
+    for (size_t i = 0; i < current.size; ++i) {
+        result += "For the " + std::string(current.getCode(i)) + " department:\n" +
+                  loadDepartment(current, i)->display() + "\n";
     }
     return result;
 }
+
+/**
+ * Sets the enrollment count of a course and logs the change. The count is changed in place (see
+ * changeSeats()), and the check of the expected count is part of the same compare-and-swap.
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @param count              The new enrollment count.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the course must be at, if any.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::setEnrollmentCount(const std::string& deptCode,
+                                                  const std::string& courseCode,
+                                                  int count,
+                                                  Durability durability,
+                                                  std::optional<ExpectedState> expected) {
+    return changeSeats(deptCode,
+                       courseCode,
+                       durability,
+                       expected,
+                       [&](Course& course, std::optional<CourseState> state) {
+                           return course.storeSeats(count, state);
+                       });
+}
+
+/**
+ * Assigns a course to a new location and logs the change.
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @param location           The new location.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the course must be at, if any.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::setCourseLocation(const std::string& deptCode,
+                                                 const std::string& courseCode,
+                                                 const std::string& location,
+                                                 Durability durability,
+                                                 std::optional<ExpectedState> expected) {
+    return mutateCourse(deptCode, courseCode, durability, expected, [&](Course& course) {
+        course.reassignLocation(location);
+        return WalRecord{WalRecordType::SetCourseLocation, deptCode, courseCode, 0, location};
+    });
+}
+
+/**
+ * Assigns a course to a new instructor and logs the change.
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @param instructor         The new instructor name.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the course must be at, if any.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::setCourseInstructor(const std::string& deptCode,
+                                                   const std::string& courseCode,
+                                                   const std::string& instructor,
+                                                   Durability durability,
+                                                   std::optional<ExpectedState> expected) {
+    return mutateCourse(deptCode, courseCode, durability, expected, [&](Course& course) {
+        course.reassignInstructor(instructor);
+        return WalRecord{WalRecordType::SetCourseInstructor, deptCode, courseCode, 0, instructor};
+    });
+}
+
+/**
+ * Assigns a course to a new time slot and logs the change.
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @param time               The new time slot.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the course must be at, if any.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::setCourseTime(const std::string& deptCode,
+                                             const std::string& courseCode,
+                                             const std::string& time,
+                                             Durability durability,
+                                             std::optional<ExpectedState> expected) {
+    return mutateCourse(deptCode, courseCode, durability, expected, [&](Course& course) {
+        course.reassignTime(time);
+        return WalRecord{WalRecordType::SetCourseTime, deptCode, courseCode, 0, time};
+    });
+}
+
+/**
+ * Adds a major to a department and logs the resulting number of majors.
+ *
+ * @param deptCode           The department code.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the department must be at, if any.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::addMajorToDept(const std::string& deptCode,
+                                              Durability durability,
+                                              std::optional<ExpectedState> expected) {
+    return mutateDepartment(deptCode, durability, expected, [&](Department& dept) {
+        dept.addPersonToMajor();
+        return WalRecord{
+            WalRecordType::SetNumberOfMajors, deptCode, "", dept.getNumberOfMajors(), ""};
+    });
+}
+
+/**
+ * Removes a major from a department and logs the resulting number of majors.
+ *
+ * @param deptCode           The department code.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the department must be at, if any.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::removeMajorFromDept(const std::string& deptCode,
+                                                   Durability durability,
+                                                   std::optional<ExpectedState> expected) {
+    return mutateDepartment(deptCode, durability, expected, [&](Department& dept) {
+        dept.dropPersonFromMajor();
+        return WalRecord{
+            WalRecordType::SetNumberOfMajors, deptCode, "", dept.getNumberOfMajors(), ""};
+    });
+}
+
+/**
+ * Enrolls a student in a course if a seat is free and logs the resulting enrollment count. The
+ * seat is taken with a compare-and-swap (see changeSeats()), so concurrent requests never
+ * overbook the course; requests that contend on a course are combined into one compare-and-swap
+ * per batch (see SeatCombiner).
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @return The outcome of the mutation; Rejected if the course is full.
+ */
+MutationStatus MyFileDatabase::enrollStudentInCourse(const std::string& deptCode,
+                                                     const std::string& courseCode,
+                                                     Durability durability) {
+    return changeSeats(deptCode,
+                       courseCode,
+                       durability,
+                       std::nullopt,
+                       [this](Course& course, std::optional<CourseState>) {
+                           return seatCombiner.apply(course, 1);
+                       });
+}
+
+/**
+ * Drops a student from a course and logs the resulting enrollment count. The seat is given back
+ * with a compare-and-swap (see changeSeats()), combined with contending requests as for
+ * enrollStudentInCourse().
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @return The outcome of the mutation; Rejected if the course has no students to drop.
+ */
+MutationStatus MyFileDatabase::dropStudentFromCourse(const std::string& deptCode,
+                                                     const std::string& courseCode,
+                                                     Durability durability) {
+    return changeSeats(deptCode,
+                       courseCode,
+                       durability,
+                       std::nullopt,
+                       [this](Course& course, std::optional<CourseState>) {
+                           return seatCombiner.apply(course, -1);
+                       });
+}
+
+/**
+ * Applies a change to a copy of a department, publishes the copy and logs the record the change
+ * returns to the write-ahead log. The copy shares its courses with the previous version. Records
+ * always hold the value after the change rather than the change itself, so replaying a record
+ * that is already reflected in the file is harmless.
+ *
+ * The change runs as the department's only writer (see DepartmentWriters). Only writers retire
+ * departments, each only its own, and catalogs are only retired while every writer is excluded,
+ * so no epoch guard is needed there. The writer is also the only one to change the department's
+ * version, so checking it against the expected one and publishing the next version can't be
+ * interleaved with another change, nor with the catalog being replaced by one of another
+ * generation.
+ *
+ * @param deptCode           The department code.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the department must be at, if any.
+ * @param fn                 Applies the change and returns the record to log, or std::nullopt
+ *                           if the change was rejected.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::mutateDepartment(
+    const std::string& deptCode,
+    Durability durability,
+    std::optional<ExpectedState> expected,
+    const std::function<std::optional<WalRecord>(Department&)>& fn) {
+    MutationStatus status = MutationStatus::DepartmentNotFound;
+    std::optional<uint64_t> lsn;
+    writers->run(deptCode, [&]() {
+        Catalog& current = *catalog.load();
+        std::optional<size_t> index = current.find(deptCode);
+        if (!index) {
+            return;
+        }
+        const Department* dept = loadDepartment(current, *index);
+        if (expected && (expected->generation != current.generation || expected->count ||
+                         expected->version != dept->getVersion())) {
+            status = MutationStatus::Conflict;
+            return;
+        }
+        auto next = std::make_unique<Department>(*dept);
+        std::optional<WalRecord> record = fn(*next);
+        if (record) {
+            next->setVersion(dept->getVersion() + 1);
+            publishDepartment(current, *index, next.release());
+        }
+        status = commit(record, durability, lsn);
+    });
+    if (lsn && durability == Durability::Sync) {
+        return awaitCommit(*lsn);
+    }
+    return status;
+}
+
+/**
+ * Applies a change to a copy of a course, publishes a copy of its department holding the new
+ * course and logs the record the change returns to the write-ahead log. The department's other
+ * courses are shared with its previous version. The new course is at the next version, and the
+ * check of the expected seat count is part of the compare-and-swap that retires the previous one
+ * (see Course::supersede()), so a concurrent seat change either lands before it or fails as
+ * stale and is retried on the new course.
+ *
+ * Seat changes wait for a retired course's newer version, so everything that can throw is done
+ * before the previous version is retired, and the new department is published right after it.
+ * The indexes brought up to date after that may still throw, but by then the course is live.
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the course must be at, if any.
+ * @param fn                 Applies the change and returns the record to log, or std::nullopt
+ *                           if the change was rejected.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::mutateCourse(
+    const std::string& deptCode,
+    const std::string& courseCode,
+    Durability durability,
+    std::optional<ExpectedState> expected,
+    const std::function<std::optional<WalRecord>(Course&)>& fn) {
+    MutationStatus status = MutationStatus::DepartmentNotFound;
+    std::optional<uint64_t> lsn;
+    writers->run(deptCode, [&]() {
+        Catalog& current = *catalog.load();
+        std::optional<size_t> index = current.find(deptCode);
+        if (!index) {
+            return;
+        }
+        const Department* dept = loadDepartment(current, *index);
+        const Course* course = dept->findCourse(courseCode);
+        if (!course) {
+            status = MutationStatus::CourseNotFound;
+            return;
+        }
+        // The catalog can't be replaced under the writer, and the course's version and count are
+        // checked again when it is retired; this only saves copying for a change that already
+        // conflicts.
+        std::optional<CourseState> state;
+        if (!toCourseState(expected, current.generation, state) ||
+            (state && course->getVersion() != state->version)) {
+            status = MutationStatus::Conflict;
+            return;
+        }
+        auto nextCourse = std::make_shared<Course>(*course);
+        std::optional<WalRecord> record = fn(*nextCourse);
+        if (record) {
+            auto next = std::make_unique<Department>(*dept);
+            next->addCourse(courseCode, nextCourse);
+            CourseColumns* columns = current.columns.load();
+            std::optional<uint32_t> slot;
+            if (columns && !(slot = columns->find(deptCode, courseCode))) {
+                throw std::runtime_error("Course " + deptCode + " " + courseCode +
+                                         " is missing from the course columns");
+            }
+            // Terms are only ever added, and a dropped time index is rebuilt on the next query,
+            // so neither needs undoing if the change conflicts.
+            if (SearchIndex* search = current.searchIndex.load()) {
+                search->addName(SearchField::Instructor, nextCourse->getInternedInstructor());
+                search->addName(SearchField::Location, nextCourse->getInternedLocation());
+            }
+            if (!(nextCourse->getTimeRange() == course->getTimeRange())) {
+                EpochReclaimer::retire(current.timeIndex.exchange(nullptr));
+            }
+
+            // Seat changes don't go through the department's writer, so freeze the count the new
+            // version starts from; seat changes on the old version fail as stale until the new
+            // one is published, which nothing between here and publishDepartment() can prevent.
+            if (!nextCourse->supersede(const_cast<Course&>(*course), state)) {
+                status = MutationStatus::Conflict;
+                return;
+            }
+            publishDepartment(current, *index, next.release());
+            if (columns) {
+                columns->update(*slot, *nextCourse);
+            }
+        }
+        status = commit(record, durability, lsn);
+    });
+    if (lsn && durability == Durability::Sync) {
+        return awaitCommit(*lsn);
+    }
+    return status;
+}
+
+/**
+ * Queues the record of an applied change for the next group commit. The record is queued by the
+ * department's writer, so the log order of each department always matches the order its changes
+ * were applied in; changes to different departments commute, since records hold values rather
+ * than deltas. Synchronous callers then wait for the fsync once the writer is done, which leaves
+ * it free to apply the next change and lets other request threads join the same batch.
+ *
+ * @param record             The record to log, or std::nullopt if the change was rejected.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param lsn                Set to the record's log sequence number if it was queued.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::commit(const std::optional<WalRecord>& record,
+                                      Durability durability,
+                                      std::optional<uint64_t>& lsn) {
+    if (!record) {
+        return MutationStatus::Rejected;
+    }
+    noteMutation();
+    if (durability != Durability::None) {
+        lsn = writeAheadLog.enqueue(*record);
+    }
+    return MutationStatus::Applied;
+}
+
+/**
+ * Waits for the group commit holding the record of an applied change. If the commit fails, the
+ * change stays applied and the write-ahead log keeps retrying its record, so the caller is told
+ * the change isn't durable yet rather than that it failed.
+ *
+ * @param lsn                The log sequence number of the record.
+ * @return Applied once the record is durable, or NotDurable if its commit failed.
+ */
+MutationStatus MyFileDatabase::awaitCommit(uint64_t lsn) {
+    try {
+        writeAheadLog.waitForDurable(lsn);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return MutationStatus::NotDurable;
+    }
+    return MutationStatus::Applied;
+}
+
+/**
+ * Applies a change to the seat count of a published course in place, without a lock or a copy:
+ * the count is atomic, so the change is a compare-and-swap, and writers of the same course never
+ * block each other. A writer that replaces the course with a newer version retires the old one
+ * first, so a change that finds it retired looks the course up again and retries on the newer
+ * version.
+ *
+ * The change is logged with the count read while the log's lock is held, from the latest
+ * version, so the last record logged for the course always holds its final count even when
+ * concurrent changes are logged out of order. A retired version's count is the one its newer
+ * version starts from, so that read doesn't wait for the newer version to be published.
+ *
+ * The course columns are only refreshed when the course fills up or stops being full, so changes
+ * to a hot course don't write to the cache lines of its neighbours there.
+ *
+ * @param deptCode           The department code.
+ * @param courseCode         The course code.
+ * @param durability         How long to wait for the change to reach the disk.
+ * @param expected           The state the course must be at, if any.
+ * @param fn                 Applies the change to a version of the course, given the state it
+ *                           must be at, if any.
+ * @return The outcome of the mutation.
+ */
+MutationStatus MyFileDatabase::changeSeats(
+    const std::string& deptCode,
+    const std::string& courseCode,
+    Durability durability,
+    std::optional<ExpectedState> expected,
+    const std::function<SeatChange(Course&, std::optional<CourseState>)>& fn) {
+    EpochGuard guard;
+    Catalog& current = *catalog.load();
+    std::optional<size_t> index = current.find(deptCode);
+    if (!index) {
+        return MutationStatus::DepartmentNotFound;
+    }
+    auto latest = [&]() {
+        auto deadline = std::chrono::steady_clock::now() + kSupersedeTimeout;
+        for (;;) {
+            const Course* course = loadDepartment(current, *index)->findCourse(courseCode);
+            if (!course || !course->isRetired()) {
+                return course;
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error("Course " + deptCode + " " + courseCode +
+                                         " was retired without a newer version");
+            }
+            std::this_thread::yield();
+        }
+    };
+    const Course* course = latest();
+    if (!course) {
+        return MutationStatus::CourseNotFound;
+    }
+    std::optional<CourseState> state;
+    if (!toCourseState(expected, current.generation, state)) {
+        return MutationStatus::Conflict;
+    }
+    SeatChange change;
+    // Published courses are const, but their seat counts are atomic and change in place.
+    while ((change = fn(const_cast<Course&>(*course), state)) == SeatChange::Stale) {
+        course = latest();
+    }
+    if (change == SeatChange::Rejected) {
+        return MutationStatus::Rejected;
+    }
+    if (change == SeatChange::Conflict) {
+        return MutationStatus::Conflict;
+    }
+    if (!current.slots[*index].dirty.load(std::memory_order_relaxed)) {
+        current.slots[*index].dirty = true;
+    }
+    if (CourseColumns* columns = current.columns.load()) {
+        if (std::optional<uint32_t> slot = columns->find(deptCode, courseCode)) {
+            // The course may have been replaced since the change, and the column stored from its
+            // newer version, so refresh from the latest version until it's one still live.
+            const Course* newest;
+            do {
+                newest = latest();
+                columns->refreshFullness(*slot, *newest);
+            } while (newest->isRetired());
+        }
+    }
+    noteMutation();
+    if (durability == Durability::None) {
+        return MutationStatus::Applied;
+    }
+    uint64_t lsn = writeAheadLog.enqueue([&]() {
+        const Course* newest = loadDepartment(current, *index)->findCourse(courseCode);
+        return WalRecord{WalRecordType::SetEnrollmentCount,
+                         deptCode,
+                         courseCode,
+                         newest->getEnrolledStudentCount(),
+                         ""};
+    });
+    if (durability == Durability::Sync) {
+        return awaitCommit(lsn);
+    }
+    return MutationStatus::Applied;
+}
+
+/**
+ * Sets the group commit batch window of the write-ahead log.
+ *
+ * @param window             The batch window.
+ */
+void MyFileDatabase::setGroupCommitWindow(std::chrono::microseconds window) {
+    writeAheadLog.setGroupCommitWindow(window);
+}
+
+/**
+ * Returns the group commit statistics of the write-ahead log.
+ *
+ * @return The statistics.
+ */
+WalStats MyFileDatabase::getWalStats() const {
+    return writeAheadLog.getStats();
+}
+
+/**
+ * Applies a logged record to the in-memory data without logging it again. Records that refer to
+ * departments or courses that no longer exist are skipped.
+ *
+ * @param record             The record to apply.
+ */
+void MyFileDatabase::applyRecord(const WalRecord& record) {
+    if (record.type == WalRecordType::SetNumberOfMajors) {
+        mutateDepartment(record.deptCode, Durability::None, std::nullopt, [&](Department& dept) {
+            dept.setNumberOfMajors(record.intValue);
+            return record;
+        });
+        return;
+    }
+    if (record.type == WalRecordType::SetEnrollmentCount) {
+        setEnrollmentCount(record.deptCode, record.courseCode, record.intValue, Durability::None);
+        return;
+    }
+    auto apply = [&](Course& course) -> std::optional<WalRecord> {
+        switch (record.type) {
+            case WalRecordType::SetCourseLocation:
+                course.reassignLocation(record.stringValue);
+                break;
+            case WalRecordType::SetCourseInstructor:
+                course.reassignInstructor(record.stringValue);
+                break;
+            case WalRecordType::SetCourseTime:
+                course.reassignTime(record.stringValue);
+                break;
+            case WalRecordType::SetEnrollmentCount:
+            case WalRecordType::SetNumberOfMajors:
+                break;
+        }
+        return record;
+    };
+    mutateCourse(record.deptCode, record.courseCode, Durability::None, std::nullopt, apply);
+}
+
+/**
+ * Re-applies every record in the write-ahead log on top of the contents loaded from the file,
+ * recovering the changes made since the last checkpoint. Only the departments the log refers to
+ * are loaded; each applied record counts towards the next checkpoint.
+ */
+void MyFileDatabase::replayWriteAheadLog() {
+    for (const WalRecord& record : writeAheadLog.recover()) {
+        applyRecord(record);
+    }
+}
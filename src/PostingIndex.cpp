@@ -0,0 +1,127 @@
+// Copyright 2024 Jason Han
+#include "PostingIndex.h"
+#include "EpochReclaimer.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+/**
+ * Constructs an empty index.
+ */
+PostingIndex::PostingIndex()
+    : chunks(new std::atomic<std::atomic<const Postings*>*>[kMaxChunks]()) {}
+
+/**
+ * Frees the current course lists and the chunks. Lists replaced earlier belong to the epoch
+ * reclaimer.
+ */
+PostingIndex::~PostingIndex() {
+    for (size_t i = 0; i < kMaxChunks; ++i) {
+        std::atomic<const Postings*>* chunk = chunks[i].load(std::memory_order_relaxed);
+        if (!chunk) {
+            continue;
+        }
+        for (size_t j = 0; j < kChunkSize; ++j) {
+            delete chunk[j].load(std::memory_order_relaxed);
+        }
+        delete[] chunk;
+    }
+}
+
+/**
+ * Indexes every course in a column. Called once, on an empty index, before readers can see it.
+ *
+ * @param column             The column, holding one interned string ID per course.
+ * @param count              The number of courses.
+ */
+void PostingIndex::build(const std::atomic<uint32_t>* column, size_t count) {
+    std::vector<std::pair<uint32_t, uint32_t>> entries;
+    entries.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        entries.emplace_back(column[i].load(std::memory_order_relaxed), static_cast<uint32_t>(i));
+    }
+    std::sort(entries.begin(), entries.end());
+    for (size_t first = 0; first < entries.size();) {
+        size_t last = first;
+        Postings postings;
+        while (last < entries.size() && entries[last].first == entries[first].first) {
+            postings.push_back(entries[last++].second);
+        }
+        publish(entries[first].first, std::move(postings));
+        first = last;
+    }
+}
+
+/**
+ * Returns every course holding a value. Callers hold an epoch guard.
+ *
+ * @param value              The interned string ID.
+ * @return The IDs of the courses, in ID order.
+ */
+std::vector<uint32_t> PostingIndex::find(uint32_t value) const {
+    if (value >= kMaxChunks * kChunkSize) {
+        return {};
+    }
+    const std::atomic<const Postings*>* chunk =
+        chunks[value >> kChunkBits].load(std::memory_order_acquire);
+    if (!chunk) {
+        return {};
+    }
+    const Postings* postings = chunk[value & (kChunkSize - 1)].load(std::memory_order_acquire);
+    return postings ? *postings : Postings();
+}
+
+/**
+ * Moves a course from one value's list to another's. Calls must be serialized with each other
+ * and with build(), but can run alongside find().
+ *
+ * @param course             The course's ID.
+ * @param from               The value the course held.
+ * @param to                 The value the course now holds.
+ */
+void PostingIndex::move(uint32_t course, uint32_t from, uint32_t to) {
+    if (from == to) {
+        return;
+    }
+    if (const Postings* current = slotFor(from).load(std::memory_order_relaxed)) {
+        Postings postings;
+        postings.reserve(current->size());
+        std::remove_copy(current->begin(), current->end(), std::back_inserter(postings), course);
+        publish(from, std::move(postings));
+    }
+    Postings postings;
+    if (const Postings* current = slotFor(to).load(std::memory_order_relaxed)) {
+        postings.reserve(current->size() + 1);
+        postings.assign(current->begin(), current->end());
+    }
+    postings.insert(std::lower_bound(postings.begin(), postings.end(), course), course);
+    publish(to, std::move(postings));
+}
+
+/**
+ * Returns the entry that holds a value's course list, allocating its chunk on first use. Only
+ * the writer calls this.
+ *
+ * @param value              The interned string ID.
+ * @return The entry.
+ */
+std::atomic<const PostingIndex::Postings*>& PostingIndex::slotFor(uint32_t value) {
+    std::atomic<std::atomic<const Postings*>*>& chunk = chunks[value >> kChunkBits];
+    std::atomic<const Postings*>* entries = chunk.load(std::memory_order_relaxed);
+    if (!entries) {
+        entries = new std::atomic<const Postings*>[kChunkSize]();
+        chunk.store(entries, std::memory_order_release);
+    }
+    return entries[value & (kChunkSize - 1)];
+}
+
+/**
+ * Replaces a value's course list, retiring the previous one. An empty list is stored as null.
+ *
+ * @param value              The interned string ID.
+ * @param postings           The new list, in ID order.
+ */
+void PostingIndex::publish(uint32_t value, Postings postings) {
+    const Postings* next = postings.empty() ? nullptr : new Postings(std::move(postings));
+    EpochReclaimer::retire(slotFor(value).exchange(next, std::memory_order_acq_rel));
+}
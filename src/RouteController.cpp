@@ -1,8 +1,14 @@
 // Copyright 2024 Jason Han
+#include <algorithm>
+#include <cctype>
 #include <exception>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "MyFileDatabase.h"
 #include "RouteController.h"
@@ -19,6 +25,214 @@ crow::response handleException(const std::exception& e) {
     return crow::response{500, "An error has occurred"};
 }
 
+/**
+ * Utility function to translate the outcome of a database mutation into a response.
+ *
+ * @param status             The outcome of the mutation.
+ * @param successMessage     The body to send if the mutation was applied.
+ * @param rejectedMessage    The body to send if the mutation was rejected.
+ * @param res                The Crow response to write to.
+ */
+void writeMutationStatus(MutationStatus status,
+                         const std::string& successMessage,
+                         const std::string& rejectedMessage,
+                         crow::response& res) {
+    switch (status) {
+        case MutationStatus::Applied:
+            res.code = 200;
+            res.write(successMessage);
+            break;
+        case MutationStatus::DepartmentNotFound:
+            res.code = 404;
+            res.write("Department Not Found");
+            break;
+        case MutationStatus::CourseNotFound:
+            res.code = 404;
+            res.write("Course Not Found");
+            break;
+        case MutationStatus::Rejected:
+            res.code = 400;
+            res.write(rejectedMessage);
+            break;
+        case MutationStatus::Conflict:
+            res.code = 409;
+            res.write("Version Mismatch");
+            break;
+        case MutationStatus::NotDurable:
+            res.code = 503;
+            res.write("Change was applied but could not be made durable yet");
+            break;
+    }
+}
+
+/**
+ * Utility function to read the optional durability URL parameter, which defaults to "sync".
+ *
+ * @param req                The Crow request to read from.
+ * @param res                The Crow response to write a 400 error to if the value is invalid.
+ * @param durability         Set to the requested durability.
+ * @return true if the parameter is absent or valid, false otherwise.
+ */
+bool readDurability(const crow::request& req, crow::response& res, Durability& durability) {
+    auto name = req.url_params.get("durability");
+    if (!name) {
+        durability = Durability::Sync;
+        return true;
+    }
+    auto parsed = WriteAheadLog::parseDurability(name);
+    if (!parsed) {
+        res.code = 400;
+        res.write("durability must be one of sync, async or none");
+        return false;
+    }
+    durability = *parsed;
+    return true;
+}
+
+/**
+ * Utility function to send the version of a department as the ETag of a response, for clients to
+ * send back in an If-Match header when they change it. The tag starts with the generation of the
+ * catalog the department was read from, since versions restart whenever a catalog is loaded or
+ * replaced (see ExpectedState).
+ *
+ * @param dept               The department.
+ * @param res                The Crow response to write to.
+ */
+void writeDepartmentTag(const DepartmentView& dept, crow::response& res) {
+    res.set_header("ETag",
+                   "\"" + std::to_string(dept.getGeneration()) + "." +
+                       std::to_string(dept->getVersion()) + "\"");
+}
+
+/**
+ * Utility function to send the version and seat count of a course as the ETag of a response, as
+ * for writeDepartmentTag(). Seat changes don't advance the version, so the count is part of the
+ * tag.
+ *
+ * @param dept               The course's department.
+ * @param course             The course.
+ * @param res                The Crow response to write to.
+ */
+void writeCourseTag(const DepartmentView& dept, const Course& course, crow::response& res) {
+    CourseState state = course.getState();
+    res.set_header("ETag",
+                   "\"" + std::to_string(dept.getGeneration()) + "." +
+                       std::to_string(state.version) + "." + std::to_string(state.count) + "\"");
+}
+
+/**
+ * Utility function to parse one unsigned decimal number of an ETag.
+ *
+ * @param text               The text to parse.
+ * @return The number, or std::nullopt if the text isn't one or doesn't fit in 64 bits.
+ */
+std::optional<uint64_t> parseTagNumber(std::string_view text) {
+    if (text.empty()) {
+        return std::nullopt;
+    }
+    uint64_t value = 0;
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return std::nullopt;
+        }
+        uint64_t digit = c - '0';
+        if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+            return std::nullopt;
+        }
+        value = value * 10 + digit;
+    }
+    return value;
+}
+
+/**
+ * Utility function to read the optional If-Match header, which holds the state a change expects
+ * the department or course to be at, as sent in an ETag: the catalog generation and the version,
+ * followed for a course by its seat count, separated by dots. An absent header or "*" matches any
+ * state.
+ *
+ * @param req                The Crow request to read from.
+ * @param res                The Crow response to write a 400 error to if the value is invalid.
+ * @param expected           Set to the expected state, or std::nullopt to match any.
+ * @return true if the header is absent or valid, false otherwise.
+ */
+bool readExpectedState(const crow::request& req,
+                       crow::response& res,
+                       std::optional<ExpectedState>& expected) {
+    std::string value = req.get_header_value("If-Match");
+    expected = std::nullopt;
+    if (value.empty() || value == "*") {
+        return true;
+    }
+    std::string_view tag = value;
+    if (tag.length() >= 2 && tag.front() == '"' && tag.back() == '"') {
+        tag = tag.substr(1, tag.length() - 2);
+    }
+    std::vector<std::string_view> parts;
+    for (size_t start = 0;;) {
+        size_t dot = tag.find('.', start);
+        parts.push_back(tag.substr(start, dot - start));
+        if (dot == std::string_view::npos) {
+            break;
+        }
+        start = dot + 1;
+    }
+    std::optional<uint64_t> generation = parseTagNumber(parts[0]);
+    std::optional<uint64_t> version =
+        parts.size() > 1 ? parseTagNumber(parts[1]) : std::nullopt;
+    bool valid = generation && version && parts.size() <= 3;
+    std::optional<int> count;
+    if (valid && parts.size() == 3) {
+        bool negative = !parts[2].empty() && parts[2].front() == '-';
+        std::optional<uint64_t> magnitude = parseTagNumber(parts[2].substr(negative ? 1 : 0));
+        uint64_t limit = uint64_t{std::numeric_limits<int>::max()} + (negative ? 1 : 0);
+        valid = magnitude && *magnitude <= limit;
+        if (valid) {
+            int64_t signedMagnitude = static_cast<int64_t>(*magnitude);
+            count = static_cast<int>(negative ? -signedMagnitude : signedMagnitude);
+        }
+    }
+    if (!valid) {
+        res.code = 400;
+        res.write("If-Match must hold an ETag sent for the department or course");
+        return false;
+    }
+    expected = ExpectedState{*generation, *version, count};
+    return true;
+}
+
+/**
+ * Utility function to list courses in a response body, one "DEPT CODE" line per course.
+ *
+ * @param courses            The courses to list.
+ * @return The response body.
+ */
+std::string listCourses(const std::vector<CourseKey>& courses) {
+    std::string body;
+    for (const CourseKey& key : courses) {
+        body.append(key.deptCode).append(" ").append(key.courseCode).append("\n");
+    }
+    return body;
+}
+
+/**
+ * Utility function to list search results in a response body, one line per course naming the
+ * term it was found through, such as "COMS 4156 (instructor: Gail Kaiser)".
+ *
+ * @param results            The search results, best first.
+ * @return The response body.
+ */
+std::string listSearchResults(const std::vector<SearchResult>& results) {
+    std::string body;
+    for (const SearchResult& result : results) {
+        const char* field = result.field == SearchField::Course       ? "course"
+                            : result.field == SearchField::Instructor ? "instructor"
+                                                                      : "location";
+        body.append(result.course.deptCode).append(" ").append(result.course.courseCode);
+        body.append(" (").append(field).append(": ").append(result.text).append(")\n");
+    }
+    return body;
+}
+
 /**
  * Redirects to the homepage.
  *
@@ -50,14 +264,14 @@ void RouteController::retrieveDepartment(const crow::request& req, crow::respons
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto it = departmentMapping.find(deptCode);
-        if (it == departmentMapping.end()) {
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
+        if (!dept) {
             res.code = 404;
             res.write("Department Not Found");
         } else {
+            // No ETag: the body shows every course, which change without the department version.
             res.code = 200;
-            res.write(it->second.display());  // Use dot operator to access method
+            res.write(dept->display());
         }
         res.end();
     } catch (const std::exception& e) {
@@ -94,22 +308,21 @@ void RouteController::retrieveCourse(const crow::request& req, crow::response& r
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
+        if (!dept) {
             res.code = 404;
             res.write("Department Not Found");
         } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
+            const Course* course = dept->findCourse(courseCode);
 
-            if (courseIt == coursesMapping.end()) {
+            if (!course) {
                 res.code = 404;
                 res.write("Course Not Found");
             } else {
                 res.code = 200;
-                res.write(courseIt->second->display());  // Use dot operator to access method
+                writeCourseTag(dept, *course, res);
+                res.write(course->display());  // Use dot operator to access method
             }
         }
         res.end();
@@ -146,22 +359,20 @@ void RouteController::isCourseFull(const crow::request& req, crow::response& res
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
+        if (!dept) {
             res.code = 404;
             res.write("Department Not Found");
         } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
+            const Course* course = dept->findCourse(courseCode);
 
-            if (courseIt == coursesMapping.end()) {
+            if (!course) {
                 res.code = 404;
                 res.write("Course Not Found");
             } else {
-                auto course = courseIt->second;
                 res.code = 200;
+                writeCourseTag(dept, *course, res);
                 res.write(course->isCourseFull() ? "true"
                                                  : "false");  // Use dot operator to call method
             }
@@ -191,15 +402,15 @@ void RouteController::getMajorCountFromDept(const crow::request& req, crow::resp
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
+        if (!dept) {
             res.code = 404;
             res.write("Department Not Found");
         } else {
             res.code = 200;
-            res.write("There are: " + std::to_string(deptIt->second.getNumberOfMajors()) +
+            writeDepartmentTag(dept, res);
+            res.write("There are: " + std::to_string(dept->getNumberOfMajors()) +
                       " majors in the department");  // Use dot operator to call method
         }
         res.end();
@@ -227,15 +438,15 @@ void RouteController::identifyDeptChair(const crow::request& req, crow::response
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
+        if (!dept) {
             res.code = 404;
             res.write("Department Not Found");
         } else {
             res.code = 200;
-            res.write(deptIt->second.getDepartmentChair() +
+            writeDepartmentTag(dept, res);
+            res.write(dept->getDepartmentChair() +
                       " is the department chair.");  // Use dot operator to call method
         }
         res.end();
@@ -272,22 +483,20 @@ void RouteController::findCourseLocation(const crow::request& req, crow::respons
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
+        if (!dept) {
             res.code = 404;
             res.write("Department Not Found");
         } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
+            const Course* course = dept->findCourse(courseCode);
 
-            if (courseIt == coursesMapping.end()) {
+            if (!course) {
                 res.code = 404;
                 res.write("Course Not Found");
             } else {
-                auto course = courseIt->second;
                 res.code = 200;
+                writeCourseTag(dept, *course, res);
                 res.write(course->getCourseLocation() +
                           " is where the course is located.");  // Use dot operator to call method
             }
@@ -326,22 +535,20 @@ void RouteController::findCourseInstructor(const crow::request& req, crow::respo
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
+        if (!dept) {
             res.code = 404;
             res.write("Department Not Found");
         } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
+            const Course* course = dept->findCourse(courseCode);
 
-            if (courseIt == coursesMapping.end()) {
+            if (!course) {
                 res.code = 404;
                 res.write("Course Not Found");
             } else {
-                auto course = courseIt->second;
                 res.code = 200;
+                writeCourseTag(dept, *course, res);
                 res.write(
                     course->getInstructorName() +
                     " is the instructor for the course.");  // Use dot operator to call method
@@ -381,22 +588,20 @@ void RouteController::findCourseTime(const crow::request& req, crow::response& r
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
 
-        if (deptIt == departmentMapping.end()) {
+        if (!dept) {
             res.code = 404;
             res.write("Department Not Found");
         } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
+            const Course* course = dept->findCourse(courseCode);
 
-            if (courseIt == coursesMapping.end()) {
+            if (!course) {
                 res.code = 404;
                 res.write("Course Not Found");
             } else {
-                auto course = courseIt->second;
                 res.code = 200;
+                writeCourseTag(dept, *course, res);
                 res.write("The course meets at: " + course->getCourseTimeSlot());
             }
         }
@@ -406,6 +611,210 @@ void RouteController::findCourseTime(const crow::request& req, crow::response& r
     }
 }
 
+/**
+ * Displays every course taught by an instructor, found through a secondary index.
+ *
+ * @param instructor A {@code String} representing the instructor.
+ *
+ * @return           A crow::response object containing one line per matching course and an HTTP
+ *                   200 response or, an appropriate message indicating the proper response.
+ */
+void RouteController::retrieveCoursesByInstructor(const crow::request& req, crow::response& res) {
+    try {
+        auto instructor = req.url_params.get("instructor");
+        if (!instructor) {
+            res.code = 400;
+            res.write("URL parameters must include instructor");
+            return;
+        }
+        res.code = 200;
+        res.write(listCourses(myFileDatabase->findCoursesByInstructor(instructor)));
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Displays every course held in a location, found through a secondary index.
+ *
+ * @param location   A {@code String} representing the location.
+ *
+ * @return           A crow::response object containing one line per matching course and an HTTP
+ *                   200 response or, an appropriate message indicating the proper response.
+ */
+void RouteController::retrieveCoursesByLocation(const crow::request& req, crow::response& res) {
+    try {
+        auto location = req.url_params.get("location");
+        if (!location) {
+            res.code = 400;
+            res.write("URL parameters must include location");
+            return;
+        }
+        res.code = 200;
+        res.write(listCourses(myFileDatabase->findCoursesByLocation(location)));
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Displays every course meeting in exactly a time slot, found through a secondary index.
+ *
+ * @param timeSlot   A {@code String} representing the time slot.
+ *
+ * @return           A crow::response object containing one line per matching course and an HTTP
+ *                   200 response or, an appropriate message indicating the proper response.
+ */
+void RouteController::retrieveCoursesByTimeSlot(const crow::request& req, crow::response& res) {
+    try {
+        auto timeSlot = req.url_params.get("timeSlot");
+        if (!timeSlot) {
+            res.code = 400;
+            res.write("URL parameters must include timeSlot");
+            return;
+        }
+        res.code = 200;
+        res.write(listCourses(myFileDatabase->findCoursesByTimeSlot(timeSlot)));
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Displays every course that meets at some point during a time range.
+ *
+ * @param timeSlot   A {@code String} representing the time range, such as "10:10-11:25".
+ *
+ * @return           A crow::response object containing one line per matching course and an HTTP
+ *                   200 response or, an appropriate message indicating the proper response.
+ */
+void RouteController::retrieveCoursesMeetingDuring(const crow::request& req,
+                                                   crow::response& res) {
+    try {
+        auto timeSlot = req.url_params.get("timeSlot");
+        if (!timeSlot) {
+            res.code = 400;
+            res.write("URL parameters must include timeSlot");
+            return;
+        }
+        std::optional<TimeRange> range = TimeRange::parse(timeSlot);
+        if (!range) {
+            res.code = 400;
+            res.write("timeSlot must be a time range such as 10:10-11:25");
+        } else {
+            res.code = 200;
+            res.write(listCourses(myFileDatabase->findCoursesMeetingDuring(*range)));
+        }
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Searches course codes, instructor names and locations by prefix, falling back to fuzzy matches
+ * for misspellings, and displays the best matching courses.
+ *
+ * @param q          A {@code String} representing the search query, such as "Kais".
+ *
+ * @param k          An optional {@code int} from 1 to 100 representing the most courses to
+ *                   display; defaults to 10.
+ *
+ * @return           A crow::response object containing one line per course found, best first,
+ *                   and an HTTP 200 response or, an appropriate message indicating the proper
+ *                   response.
+ */
+void RouteController::search(const crow::request& req, crow::response& res) {
+    try {
+        auto query = req.url_params.get("q");
+        auto limit = req.url_params.get("k");
+        if (!query) {
+            res.code = 400;
+            res.write("URL parameters must include q");
+            return;
+        }
+        size_t k = 10;
+        if (limit) {
+            std::string digits = limit;
+            bool valid = !digits.empty() && digits.length() <= 3 &&
+                         std::all_of(digits.begin(), digits.end(), [](unsigned char c) {
+                             return std::isdigit(c) != 0;
+                         });
+            k = valid ? std::stoul(digits) : 0;
+            if (k < 1 || k > 100) {
+                res.code = 400;
+                res.write("k must be a number from 1 to 100");
+                return;
+            }
+        }
+        res.code = 200;
+        res.write(listSearchResults(myFileDatabase->search(query, k)));
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Displays every other course whose meeting time overlaps that of the specified course.
+ *
+ * @param deptCode   A {@code String} representing the department the user wishes
+ *                   to find the course in.
+ *
+ * @param courseCode A {@code int} representing the course the user wishes
+ *                   to find overlapping courses for.
+ *
+ * @return           A crow::response object containing one line per overlapping course and an
+ *                   HTTP 200 response or, an appropriate message indicating the proper response.
+ */
+void RouteController::retrieveOverlappingCourses(const crow::request& req, crow::response& res) {
+    try {
+        auto deptCode = req.url_params.get("deptCode");
+        auto courseCode = req.url_params.get("courseCode");
+        if (!deptCode) {
+            res.code = 400;
+            res.write("URL parameters must include deptCode");
+            return;
+        }
+        if (!courseCode) {
+            res.code = 400;
+            res.write("URL parameters must include courseCode");
+            return;
+        }
+
+        DepartmentView dept = myFileDatabase->viewDepartment(deptCode);
+
+        if (!dept) {
+            res.code = 404;
+            res.write("Department Not Found");
+        } else {
+            const Course* course = dept->findCourse(courseCode);
+            std::optional<TimeRange> range = course ? course->getTimeRange() : std::nullopt;
+
+            if (!course) {
+                res.code = 404;
+                res.write("Course Not Found");
+            } else if (!range) {
+                res.code = 400;
+                res.write("Course time slot is not a valid time range");
+            } else {
+                std::vector<CourseKey> courses =
+                    myFileDatabase->findCoursesMeetingDuring(*range);
+                CourseKey self{deptCode, courseCode};
+                courses.erase(std::remove(courses.begin(), courses.end(), self), courses.end());
+                res.code = 200;
+                res.write(listCourses(courses));
+            }
+        }
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
 /**
  * Attempts to add a student to the specified department.
  *
@@ -424,17 +833,18 @@ void RouteController::addMajorToDept(const crow::request& req, crow::response& r
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            deptIt->second.addPersonToMajor();  // Use dot operator to call method
-            res.code = 200;
-            res.write("Attribute was updated successfully");
+        Durability durability;
+        if (!readDurability(req, res, durability)) {
+            return;
+        }
+        std::optional<ExpectedState> expected;
+        if (!readExpectedState(req, res, expected)) {
+            return;
         }
+        MutationStatus status =
+            myFileDatabase->addMajorToDept(deptCode, durability, expected);
+        writeMutationStatus(
+            status, "Attribute was updated successfully", "Attribute was not updated", res);
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -463,25 +873,19 @@ void RouteController::setEnrollmentCount(const crow::request& req, crow::respons
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt != departmentMapping.end()) {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
-
-            if (courseIt != coursesMapping.end()) {
-                courseIt->second->setEnrolledStudentCount(std::stoi(count));
-                res.code = 200;
-                res.write("Attribute was updated successfully.");
-            } else {
-                res.code = 404;
-                res.write("Course Not Found");
-            }
-        } else {
-            res.code = 404;
-            res.write("Department Not Found");
+        Durability durability;
+        if (!readDurability(req, res, durability)) {
+            return;
+        }
+        std::optional<ExpectedState> expected;
+        if (!readExpectedState(req, res, expected)) {
+            return;
         }
+        int newCount = std::stoi(count);
+        MutationStatus status = myFileDatabase->setEnrollmentCount(
+            deptCode, courseCode, newCount, durability, expected);
+        writeMutationStatus(
+            status, "Attribute was updated successfully.", "Attribute was not updated.", res);
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -510,25 +914,18 @@ void RouteController::setCourseLocation(const crow::request& req, crow::response
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt != departmentMapping.end()) {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
-
-            if (courseIt != coursesMapping.end()) {
-                courseIt->second->reassignLocation(location);
-                res.code = 200;
-                res.write("Attribute was updated successfully.");
-            } else {
-                res.code = 404;
-                res.write("Course Not Found");
-            }
-        } else {
-            res.code = 404;
-            res.write("Department Not Found");
+        Durability durability;
+        if (!readDurability(req, res, durability)) {
+            return;
+        }
+        std::optional<ExpectedState> expected;
+        if (!readExpectedState(req, res, expected)) {
+            return;
         }
+        MutationStatus status = myFileDatabase->setCourseLocation(
+            deptCode, courseCode, location, durability, expected);
+        writeMutationStatus(
+            status, "Attribute was updated successfully.", "Attribute was not updated.", res);
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -556,25 +953,18 @@ void RouteController::setCourseInstructor(const crow::request& req, crow::respon
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt != departmentMapping.end()) {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
-
-            if (courseIt != coursesMapping.end()) {
-                courseIt->second->reassignInstructor(instructor);
-                res.code = 200;
-                res.write("Attribute was updated successfully.");
-            } else {
-                res.code = 404;
-                res.write("Course Not Found");
-            }
-        } else {
-            res.code = 404;
-            res.write("Department Not Found");
+        Durability durability;
+        if (!readDurability(req, res, durability)) {
+            return;
         }
+        std::optional<ExpectedState> expected;
+        if (!readExpectedState(req, res, expected)) {
+            return;
+        }
+        MutationStatus status = myFileDatabase->setCourseInstructor(
+            deptCode, courseCode, instructor, durability, expected);
+        writeMutationStatus(
+            status, "Attribute was updated successfully.", "Attribute was not updated.", res);
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -603,25 +993,60 @@ void RouteController::setCourseTime(const crow::request& req, crow::response& re
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
+        Durability durability;
+        if (!readDurability(req, res, durability)) {
+            return;
+        }
+        std::optional<ExpectedState> expected;
+        if (!readExpectedState(req, res, expected)) {
+            return;
+        }
+        MutationStatus status =
+            myFileDatabase->setCourseTime(deptCode, courseCode, time, durability, expected);
+        writeMutationStatus(
+            status, "Attribute was updated successfully.", "Attribute was not updated.", res);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
 
-        if (deptIt != departmentMapping.end()) {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
+/**
+ * Attempts to enroll a student in the specified course. Concurrent enrollments in one course are
+ * combined, so a popular course can take many requests at once without being overbooked.
+ *
+ * @param deptCode       A {@code String} representing the department.
+ *
+ * @param courseCode     A {@code int} representing the course the user wishes
+ *                       to enroll in.
+ *
+ * @return               A crow::response object containing an HTTP 200
+ *                       response if the student was enrolled, HTTP 400 if the
+ *                       course is full, or the proper status code in tune with
+ *                       what has happened.
+ */
+void RouteController::enrollStudentInCourse(const crow::request& req, crow::response& res) {
+    try {
+        auto deptCode = req.url_params.get("deptCode");
+        auto courseCode = req.url_params.get("courseCode");
+        if (!deptCode) {
+            res.code = 400;
+            res.write("URL parameters must include deptCode");
+            return;
+        }
+        if (!courseCode) {
+            res.code = 400;
+            res.write("URL parameters must include courseCode");
+            return;
+        }
 
-            if (courseIt != coursesMapping.end()) {
-                courseIt->second->reassignTime(time);
-                res.code = 200;
-                res.write("Attribute was updated successfully.");
-            } else {
-                res.code = 404;
-                res.write("Course Not Found");
-            }
-        } else {
-            res.code = 404;
-            res.write("Department Not Found");
+        Durability durability;
+        if (!readDurability(req, res, durability)) {
+            return;
         }
+        MutationStatus status =
+            myFileDatabase->enrollStudentInCourse(deptCode, courseCode, durability);
+        writeMutationStatus(status, "Student has been enrolled", "Course is full", res);
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -646,17 +1071,18 @@ void RouteController::removeMajorFromDept(const crow::request& req, crow::respon
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            deptIt->second.dropPersonFromMajor();
-            res.code = 200;
-            res.write("Attribute was updated successfully");
+        Durability durability;
+        if (!readDurability(req, res, durability)) {
+            return;
+        }
+        std::optional<ExpectedState> expected;
+        if (!readExpectedState(req, res, expected)) {
+            return;
         }
+        MutationStatus status =
+            myFileDatabase->removeMajorFromDept(deptCode, durability, expected);
+        writeMutationStatus(
+            status, "Attribute was updated successfully", "Attribute was not updated", res);
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -690,30 +1116,31 @@ void RouteController::dropStudentFromCourse(const crow::request& req, crow::resp
             return;
         }
 
-        auto departmentMapping = myFileDatabase->getDepartmentMapping();
-        auto deptIt = departmentMapping.find(deptCode);
-
-        if (deptIt == departmentMapping.end()) {
-            res.code = 404;
-            res.write("Department Not Found");
-        } else {
-            auto coursesMapping = deptIt->second.getCourseSelection();
-            auto courseIt = coursesMapping.find(courseCode);
-
-            if (courseIt == coursesMapping.end()) {
-                res.code = 404;
-                res.write("Course Not Found");
-            } else {
-                bool isStudentDropped = courseIt->second->dropStudent();
-                if (isStudentDropped) {
-                    res.code = 200;
-                    res.write("Student has been dropped");
-                } else {
-                    res.code = 400;
-                    res.write("Student has not been dropped");
-                }
-            }
+        Durability durability;
+        if (!readDurability(req, res, durability)) {
+            return;
         }
+        MutationStatus status =
+            myFileDatabase->dropStudentFromCourse(deptCode, courseCode, durability);
+        writeMutationStatus(
+            status, "Student has been dropped", "Student has not been dropped", res);
+        res.end();
+    } catch (const std::exception& e) {
+        res = handleException(e);
+    }
+}
+
+/**
+ * Displays the server's persistence statistics: the write-ahead log's group commit batch sizes
+ * and commit latencies, and the background checkpointer's durations and bytes written.
+ *
+ * @return           A crow::response object containing the statistics and an HTTP 200 response.
+ */
+void RouteController::retrieveStats(crow::response& res) {
+    try {
+        res.code = 200;
+        res.write(myFileDatabase->getWalStats().display() +
+                  myFileDatabase->getCheckpointStats().display());
         res.end();
     } catch (const std::exception& e) {
         res = handleException(e);
@@ -762,6 +1189,35 @@ void RouteController::initRoutes(crow::App<>& app) {
         .methods(crow::HTTPMethod::GET)(
             [this](const crow::request& req, crow::response& res) { findCourseTime(req, res); });
 
+    CROW_ROUTE(app, "/retrieveCoursesByInstructor")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            retrieveCoursesByInstructor(req, res);
+        });
+
+    CROW_ROUTE(app, "/retrieveCoursesByLocation")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            retrieveCoursesByLocation(req, res);
+        });
+
+    CROW_ROUTE(app, "/retrieveCoursesByTimeSlot")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            retrieveCoursesByTimeSlot(req, res);
+        });
+
+    CROW_ROUTE(app, "/retrieveCoursesMeetingDuring")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            retrieveCoursesMeetingDuring(req, res);
+        });
+
+    CROW_ROUTE(app, "/retrieveOverlappingCourses")
+        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
+            retrieveOverlappingCourses(req, res);
+        });
+
+    CROW_ROUTE(app, "/search")
+        .methods(crow::HTTPMethod::GET)(
+            [this](const crow::request& req, crow::response& res) { search(req, res); });
+
     CROW_ROUTE(app, "/addMajorToDept")
         .methods(crow::HTTPMethod::GET)(
             [this](const crow::request& req, crow::response& res) { addMajorToDept(req, res); });
@@ -790,10 +1246,21 @@ void RouteController::initRoutes(crow::App<>& app) {
             setEnrollmentCount(req, res);
         });
 
-    CROW_ROUTE(app, "/dropStudentFromCourse")
-        .methods(crow::HTTPMethod::GET)([this](const crow::request& req, crow::response& res) {
-            dropStudentFromCourse(req, res);
+    CROW_ROUTE(app, "/enrollStudentInCourse")
+        .methods(crow::HTTPMethod::PATCH)([this](const crow::request& req, crow::response& res) {
+            enrollStudentInCourse(req, res);
         });
+
+    // Drops change state, so they are PATCH like enrollments; GET is kept for existing clients.
+    CROW_ROUTE(app, "/dropStudentFromCourse")
+        .methods(crow::HTTPMethod::PATCH, crow::HTTPMethod::GET)(
+            [this](const crow::request& req, crow::response& res) {
+                dropStudentFromCourse(req, res);
+            });
+
+    CROW_ROUTE(app, "/retrieveStats")
+        .methods(crow::HTTPMethod::GET)(
+            [this](const crow::request& req, crow::response& res) { retrieveStats(res); });
 }
 
 void RouteController::setDatabase(MyFileDatabase* db) {
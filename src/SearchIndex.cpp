@@ -0,0 +1,349 @@
+// Copyright 2024 Jason Han
+#include "SearchIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <mutex>
+
+namespace {
+
+// The share of a query's trigrams a term must contain to match it fuzzily.
+constexpr double kFuzzyThreshold = 0.5;
+
+/**
+ * Returns whether a position in a normalized string starts a word.
+ *
+ * @param text               The normalized string.
+ * @param position           The position.
+ * @return true if the position starts a word.
+ */
+bool startsWord(std::string_view text, size_t position) {
+    return position == 0 || text[position - 1] == ' ';
+}
+
+/**
+ * Packs three characters into the low three bytes of an integer.
+ *
+ * @param characters         The characters.
+ * @return The packed trigram.
+ */
+uint32_t packTrigram(const char* characters) {
+    uint32_t packed = 0;
+    for (int i = 0; i < 3; ++i) {
+        packed = packed << 8 | static_cast<unsigned char>(characters[i]);
+    }
+    return packed;
+}
+
+}  // namespace
+
+/**
+ * Constructs an empty index.
+ */
+SearchIndex::SearchIndex() : nodes(1) {}
+
+/**
+ * Adds a course code, such as "COMS 4156", as a term naming one course.
+ *
+ * @param course             The course's ID in the course columns.
+ * @param code               The department and course code.
+ */
+void SearchIndex::addCourse(uint32_t course, std::string_view code) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    addTerm(Term{SearchField::Course, InternedString(), course, std::string(code), "", {}});
+}
+
+/**
+ * Adds an instructor or location as a term naming every course that has it. Adding a name that
+ * is already present does nothing, so writers can add the new value of every course they change.
+ *
+ * @param field              SearchField::Instructor or SearchField::Location.
+ * @param name               The instructor or location.
+ */
+void SearchIndex::addName(SearchField field, InternedString name) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    uint64_t key = static_cast<uint64_t>(field) << 32 | name.getId();
+    if (!names.insert(key).second) {
+        return;
+    }
+    addTerm(Term{field, name, 0, std::string(name.view()), "", {}});
+}
+
+/**
+ * Returns the terms that best match a query. Terms with a word starting with the query match by
+ * prefix, the whole term scoring 1; terms sharing most of the query's trigrams match fuzzily.
+ *
+ * @param query              The query, such as "Kais" or "coms 41".
+ * @param limit              The most matches to return.
+ * @return The matches, best first.
+ */
+std::vector<SearchMatch> SearchIndex::search(std::string_view query, size_t limit) const {
+    std::string normalized = normalize(query);
+    if (normalized.empty() || limit == 0) {
+        return {};
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<std::pair<uint32_t, double>> scored;
+    if (const Node* node = findNode(normalized)) {
+        for (uint32_t term : node->top) {
+            scored.emplace_back(term, prefixScore(normalized, terms[term]));
+        }
+    }
+
+    // Fuzzy matches rank below prefix matches, so they're only needed if there are too few of
+    // those.
+    std::vector<uint32_t> trigrams = trigramsOf(normalized);
+    if (normalized.length() >= 3 && scored.size() < limit) {
+        // A match shares at least required trigrams with the query, so it appears in at least
+        // one of any trigrams.size() - required + 1 of the query's trigram lists; probing the
+        // rarest ones keeps the candidate set small.
+        auto required = static_cast<size_t>(std::ceil(kFuzzyThreshold * trigrams.size()));
+        std::vector<const std::vector<uint32_t>*> lists;
+        for (uint32_t trigram : trigrams) {
+            auto it = trigramTerms.find(trigram);
+            if (it != trigramTerms.end()) {
+                lists.push_back(&it->second);
+            }
+        }
+        if (lists.size() >= required) {
+            std::sort(lists.begin(), lists.end(), [](const auto* lhs, const auto* rhs) {
+                return lhs->size() < rhs->size();
+            });
+            std::vector<uint32_t> candidates;
+            for (size_t i = 0; i < lists.size() - required + 1; ++i) {
+                candidates.insert(candidates.end(), lists[i]->begin(), lists[i]->end());
+            }
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+            for (uint32_t term : candidates) {
+                const std::vector<uint32_t>& termTrigrams = terms[term].trigrams;
+                size_t shared = 0;
+                auto lhs = trigrams.begin();
+                auto rhs = termTrigrams.begin();
+                while (lhs != trigrams.end() && rhs != termTrigrams.end()) {
+                    if (*lhs < *rhs) {
+                        ++lhs;
+                    } else if (*rhs < *lhs) {
+                        ++rhs;
+                    } else {
+                        shared++;
+                        ++lhs;
+                        ++rhs;
+                    }
+                }
+                if (shared >= required) {
+                    scored.emplace_back(term, 0.5 * shared / trigrams.size());
+                }
+            }
+        }
+    }
+
+    // Keep each term's best score, then rank by score and break ties as the trie does.
+    std::sort(scored.begin(), scored.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first != rhs.first ? lhs.first < rhs.first : lhs.second > rhs.second;
+    });
+    auto sameTerm = [](const auto& lhs, const auto& rhs) { return lhs.first == rhs.first; };
+    scored.erase(std::unique(scored.begin(), scored.end(), sameTerm), scored.end());
+    std::sort(scored.begin(), scored.end(), [this](const auto& lhs, const auto& rhs) {
+        return lhs.second != rhs.second ? lhs.second > rhs.second
+                                        : ranksBefore(lhs.first, rhs.first);
+    });
+    if (scored.size() > limit) {
+        scored.resize(limit);
+    }
+
+    std::vector<SearchMatch> matches;
+    matches.reserve(scored.size());
+    for (const auto& [term, score] : scored) {
+        const Term& found = terms[term];
+        matches.push_back(SearchMatch{found.field, found.name, found.course, found.text, score});
+    }
+    return matches;
+}
+
+/**
+ * Returns the number of terms in the index.
+ *
+ * @return The number of terms.
+ */
+size_t SearchIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return terms.size();
+}
+
+/**
+ * Normalizes text for indexing or searching: letters are lowercased, and every run of other
+ * characters than letters and digits becomes a single space between words.
+ *
+ * @param text               The text.
+ * @return The normalized text, such as "gail kaiser" for "Gail  Kaiser".
+ */
+std::string SearchIndex::normalize(std::string_view text) {
+    std::string normalized;
+    normalized.reserve(text.length());
+    bool pendingSpace = false;
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (!std::isalnum(byte)) {
+            pendingSpace = !normalized.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            normalized += ' ';
+            pendingSpace = false;
+        }
+        normalized += static_cast<char>(std::tolower(byte));
+    }
+    return normalized;
+}
+
+/**
+ * Adds a term to the trie, under every word-initial suffix of its normalized text, and, for an
+ * instructor or location, to the trigram lists. Course codes are only matched by prefix: every
+ * course in a department shares the department code's trigrams, which would make nearly any
+ * fuzzy query that mentions a department a scan. Called with the exclusive lock held.
+ *
+ * @param term               The term, without its normalized text and trigrams.
+ */
+void SearchIndex::addTerm(Term term) {
+    term.normalized = normalize(term.text);
+    if (term.normalized.empty()) {
+        return;
+    }
+    term.trigrams = trigramsOf(term.normalized);
+    auto id = static_cast<uint32_t>(terms.size());
+    terms.push_back(std::move(term));
+
+    std::string_view normalized = terms.back().normalized;
+    for (size_t i = 0; i < normalized.length(); ++i) {
+        if (startsWord(normalized, i)) {
+            insertSuffix(normalized.substr(i), id);
+        }
+    }
+    if (terms.back().field != SearchField::Course) {
+        for (uint32_t trigram : terms.back().trigrams) {
+            trigramTerms[trigram].push_back(id);
+        }
+    }
+}
+
+/**
+ * Adds a term to the trie nodes along a path, creating the nodes as needed.
+ *
+ * @param suffix             The path.
+ * @param term               The term's ID.
+ */
+void SearchIndex::insertSuffix(std::string_view suffix, uint32_t term) {
+    uint32_t node = 0;
+    for (char c : suffix) {
+        auto& children = nodes[node].children;
+        auto it = std::lower_bound(children.begin(),
+                                   children.end(),
+                                   c,
+                                   [](const auto& child, char key) { return child.first < key; });
+        if (it != children.end() && it->first == c) {
+            node = it->second;
+        } else {
+            auto child = static_cast<uint32_t>(nodes.size());
+            children.insert(it, {c, child});
+            // Adding a node may move the others, so the reference above isn't used past here.
+            nodes.emplace_back();
+            node = child;
+        }
+
+        std::vector<uint32_t>& top = nodes[node].top;
+        if (std::find(top.begin(), top.end(), term) != top.end()) {
+            continue;
+        }
+        auto position = std::lower_bound(
+            top.begin(), top.end(), term, [this](uint32_t lhs, uint32_t rhs) {
+                return ranksBefore(lhs, rhs);
+            });
+        if (position - top.begin() < static_cast<std::ptrdiff_t>(kTopTerms)) {
+            top.insert(position, term);
+            if (top.size() > kTopTerms) {
+                top.pop_back();
+            }
+        }
+    }
+}
+
+/**
+ * Orders terms for ranking: shorter normalized text first, then alphabetically.
+ *
+ * @param lhs                A term's ID.
+ * @param rhs                Another term's ID.
+ * @return true if lhs ranks before rhs.
+ */
+bool SearchIndex::ranksBefore(uint32_t lhs, uint32_t rhs) const {
+    const std::string& left = terms[lhs].normalized;
+    const std::string& right = terms[rhs].normalized;
+    if (left.length() != right.length()) {
+        return left.length() < right.length();
+    }
+    return left != right ? left < right : lhs < rhs;
+}
+
+/**
+ * Returns the trie node a prefix leads to.
+ *
+ * @param prefix             The normalized prefix.
+ * @return The node, or nullptr if no term has a word starting with the prefix.
+ */
+const SearchIndex::Node* SearchIndex::findNode(std::string_view prefix) const {
+    uint32_t node = 0;
+    for (char c : prefix) {
+        const auto& children = nodes[node].children;
+        auto it = std::lower_bound(children.begin(),
+                                   children.end(),
+                                   c,
+                                   [](const auto& child, char key) { return child.first < key; });
+        if (it == children.end() || it->first != c) {
+            return nullptr;
+        }
+        node = it->second;
+    }
+    return &nodes[node];
+}
+
+/**
+ * Scores a prefix match: 1 for the whole term, otherwise more than 0.5, growing with the share
+ * of the term the query covers.
+ *
+ * @param query              The normalized query.
+ * @param term               The matching term.
+ * @return The score.
+ */
+double SearchIndex::prefixScore(std::string_view query, const Term& term) const {
+    if (query == term.normalized) {
+        return 1.0;
+    }
+    return 0.5 + 0.49 * query.length() / term.normalized.length();
+}
+
+/**
+ * Returns the trigrams of the words of a normalized string. Each word is padded with two spaces
+ * in front and one behind, so short words and word starts contribute trigrams of their own.
+ *
+ * @param normalized         The normalized string.
+ * @return The trigrams, each packed into the low three bytes of an integer, sorted and unique.
+ */
+std::vector<uint32_t> SearchIndex::trigramsOf(std::string_view normalized) {
+    std::vector<uint32_t> trigrams;
+    size_t start = 0;
+    while (start < normalized.length()) {
+        size_t end = normalized.find(' ', start);
+        if (end == std::string_view::npos) {
+            end = normalized.length();
+        }
+        std::string padded = "  ";
+        padded.append(normalized.substr(start, end - start)).append(" ");
+        for (size_t i = 0; i + 3 <= padded.length(); ++i) {
+            trigrams.push_back(packTrigram(padded.data() + i));
+        }
+        start = end + 1;
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
@@ -0,0 +1,97 @@
+// Copyright 2024 Jason Han
+#include "SeatCombiner.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+/**
+ * Constructs a combiner with every slot free.
+ */
+SeatCombiner::SeatCombiner() : combining(false) {}
+
+/**
+ * Takes or gives back seats of a course. Without contention this is one compare-and-swap; when
+ * other threads are changing the same course, the change is published for a combining thread to
+ * apply along with theirs. If every slot is taken, the change falls back to retrying the
+ * compare-and-swap.
+ *
+ * @param course             The course.
+ * @param delta              The number of seats to take, or to give back if negative.
+ * @return The outcome of the change, as for Course::changeSeats().
+ */
+SeatChange SeatCombiner::apply(Course& course, int delta) {
+    if (std::optional<SeatChange> change = course.tryChangeSeats(delta)) {
+        return *change;
+    }
+    Slot* slot = claimSlot();
+    if (!slot) {
+        return course.changeSeats(delta);
+    }
+    slot->course = &course;
+    slot->delta = delta;
+    slot->state.store(kPending, std::memory_order_release);
+    while (slot->state.load(std::memory_order_acquire) != kDone) {
+        if (!combining.load(std::memory_order_relaxed) &&
+            !combining.exchange(true, std::memory_order_acquire)) {
+            combine();
+            combining.store(false, std::memory_order_release);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    SeatChange result = slot->result;
+    slot->state.store(kFree, std::memory_order_release);
+    return result;
+}
+
+/**
+ * Claims a free slot, probing from one picked by the calling thread so that threads rarely
+ * compete for the same slot.
+ *
+ * @return The slot, or nullptr if every slot is taken.
+ */
+SeatCombiner::Slot* SeatCombiner::claimSlot() {
+    static thread_local size_t home = std::hash<std::thread::id>()(std::this_thread::get_id());
+    for (size_t i = 0; i < kSlotCount; ++i) {
+        Slot& slot = slots[(home + i) % kSlotCount];
+        uint32_t expected = kFree;
+        if (slot.state.load(std::memory_order_relaxed) == kFree &&
+            slot.state.compare_exchange_strong(expected, kClaimed, std::memory_order_acquire)) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Applies every published change and marks its slot done. Changes to the same course are applied
+ * as one batch, in slot order. Called with the combiner lock held.
+ */
+void SeatCombiner::combine() {
+    Slot* batch[kSlotCount];
+    size_t size = 0;
+    for (Slot& slot : slots) {
+        if (slot.state.load(std::memory_order_acquire) == kPending) {
+            batch[size++] = &slot;
+        }
+    }
+    std::stable_sort(batch, batch + size, [](const Slot* lhs, const Slot* rhs) {
+        return std::less<Course*>()(lhs->course, rhs->course);
+    });
+
+    int deltas[kSlotCount];
+    SeatChange results[kSlotCount];
+    for (size_t start = 0; start < size;) {
+        size_t end = start;
+        while (end < size && batch[end]->course == batch[start]->course) {
+            deltas[end - start] = batch[end]->delta;
+            end++;
+        }
+        SeatChange outcome = batch[start]->course->changeSeats(deltas, results, end - start);
+        for (size_t i = start; i < end; ++i) {
+            batch[i]->result = outcome == SeatChange::Stale ? outcome : results[i - start];
+            batch[i]->state.store(kDone, std::memory_order_release);
+        }
+        start = end;
+    }
+}
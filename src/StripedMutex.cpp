@@ -0,0 +1,38 @@
+// Copyright 2024 Jason Han
+#include "StripedMutex.h"
+#include <functional>
+
+/**
+ * Constructs a set of unlocked stripes.
+ */
+StripedMutex::StripedMutex() = default;
+
+/**
+ * Returns the stripe a key hashes onto. Equal keys always share a stripe; different keys share
+ * one with a probability of 1 in kStripeCount.
+ *
+ * @param key                The key, such as a department code.
+ * @return The stripe's mutex.
+ */
+std::mutex& StripedMutex::stripeFor(std::string_view key) {
+    return stripes[std::hash<std::string_view>()(key) % kStripeCount].mutex;
+}
+
+/**
+ * Locks every stripe, in index order, so that no two callers can deadlock and no key's stripe is
+ * held by anyone else on return.
+ */
+void StripedMutex::lock() {
+    for (Stripe& stripe : stripes) {
+        stripe.mutex.lock();
+    }
+}
+
+/**
+ * Unlocks every stripe locked by lock(), in reverse order.
+ */
+void StripedMutex::unlock() {
+    for (size_t i = kStripeCount; i > 0; --i) {
+        stripes[i - 1].mutex.unlock();
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright 2024 Jason Han
+#include "TimeIndex.h"
+#include <algorithm>
+
+/**
+ * Builds the tree.
+ *
+ * @param courses            Each course's time range and ID.
+ */
+TimeIndex::TimeIndex(std::vector<std::pair<TimeRange, uint32_t>> courses)
+    : entries(std::move(courses)), maxEnd(entries.size()), idLimit(0) {
+    for (const auto& [range, id] : entries) {
+        idLimit = std::max<size_t>(idLimit, size_t{id} + 1);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first.start < rhs.first.start;
+    });
+    build(0, entries.size());
+}
+
+/**
+ * Returns the number of courses in the tree.
+ *
+ * @return The number of courses.
+ */
+size_t TimeIndex::size() const {
+    return entries.size();
+}
+
+/**
+ * Returns every course whose time range overlaps the given one. Runs in O(log n + k) time for k
+ * matches, apart from ordering them: a few matches are sorted, but sorting many costs more than
+ * finding them, so those are ordered through a bitmap over the IDs instead.
+ *
+ * @param range              The time range.
+ * @return The IDs of the matching courses, in ID order.
+ */
+std::vector<uint32_t> TimeIndex::findOverlapping(TimeRange range) const {
+    std::vector<uint32_t> matches;
+    collect(0, entries.size(), range, matches);
+    if (matches.size() < idLimit / 64) {
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+    std::vector<uint64_t> bits((idLimit + 63) / 64);
+    for (uint32_t id : matches) {
+        bits[id / 64] |= uint64_t{1} << id % 64;
+    }
+    matches.clear();
+    for (size_t word = 0; word < bits.size(); ++word) {
+        for (uint64_t set = bits[word]; set != 0; set &= set - 1) {
+            matches.push_back(static_cast<uint32_t>(word * 64 + __builtin_ctzll(set)));
+        }
+    }
+    return matches;
+}
+
+/**
+ * Records the latest end time of every subtree in [first, last) at its root.
+ *
+ * @param first              The first entry of the subtree.
+ * @param last               One past the last entry of the subtree.
+ * @return The latest end time in the subtree, or 0 if it is empty.
+ */
+uint16_t TimeIndex::build(size_t first, size_t last) {
+    if (first >= last) {
+        return 0;
+    }
+    size_t root = first + (last - first) / 2;
+    maxEnd[root] =
+        std::max({entries[root].first.end, build(first, root), build(root + 1, last)});
+    return maxEnd[root];
+}
+
+/**
+ * Adds the courses in the subtree [first, last) that overlap the range.
+ *
+ * @param first              The first entry of the subtree.
+ * @param last               One past the last entry of the subtree.
+ * @param range              The time range.
+ * @param matches            The matches found so far.
+ */
+void TimeIndex::collect(size_t first,
+                        size_t last,
+                        TimeRange range,
+                        std::vector<uint32_t>& matches) const {
+    if (first >= last) {
+        return;
+    }
+    size_t root = first + (last - first) / 2;
+    if (maxEnd[root] <= range.start) {
+        return;
+    }
+    collect(first, root, range, matches);
+    // Entries after the root start no earlier than it does.
+    if (entries[root].first.start >= range.end) {
+        return;
+    }
+    if (entries[root].first.overlaps(range)) {
+        matches.push_back(entries[root].second);
+    }
+    collect(root + 1, last, range, matches);
+}
@@ -0,0 +1,78 @@
+// Copyright 2024 Jason Han
+#include "TimeRange.h"
+#include <cstdio>
+
+namespace {
+
+constexpr int kMinutesPerDay = 24 * 60;
+
+/**
+ * Parses a clock time such as "9:55" or "12:40" into minutes after midnight. Catalog times are
+ * written on a 12-hour clock without AM or PM: hours 8 to 12 are taken as morning or noon, and
+ * hours 1 to 7 as afternoon or evening. Hours 0 and 13 to 23 are read as a 24-hour clock.
+ *
+ * @param text               The clock time.
+ * @return The minutes after midnight, or std::nullopt if the text isn't a clock time.
+ */
+std::optional<int> parseClock(std::string_view text) {
+    size_t colon = text.find(':');
+    if (colon == 0 || colon > 2 || text.length() != colon + 3) {
+        return std::nullopt;
+    }
+    int hour = 0;
+    for (size_t i = 0; i < colon; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return std::nullopt;
+        }
+        hour = hour * 10 + (text[i] - '0');
+    }
+    if (text[colon + 1] < '0' || text[colon + 1] > '5' || text[colon + 2] < '0' ||
+        text[colon + 2] > '9' || hour > 23) {
+        return std::nullopt;
+    }
+    int minute = (text[colon + 1] - '0') * 10 + (text[colon + 2] - '0');
+    if (hour >= 1 && hour <= 7) {
+        hour += 12;
+    }
+    return hour * 60 + minute;
+}
+
+}  // namespace
+
+/**
+ * Parses a time slot of the form "start-end" into minutes of the day. An end time that isn't
+ * after the start time is taken to be 12 hours later, so "6:10-9:50" runs from 18:10 to 21:50.
+ *
+ * @param timeSlot           The time slot.
+ * @return The time range, or std::nullopt if the slot isn't a valid range within one day.
+ */
+std::optional<TimeRange> TimeRange::parse(std::string_view timeSlot) {
+    size_t dash = timeSlot.find('-');
+    if (dash == std::string_view::npos) {
+        return std::nullopt;
+    }
+    std::optional<int> start = parseClock(timeSlot.substr(0, dash));
+    std::optional<int> end = parseClock(timeSlot.substr(dash + 1));
+    if (!start || !end) {
+        return std::nullopt;
+    }
+    if (*end <= *start) {
+        *end += 12 * 60;
+    }
+    if (*end <= *start || *end > kMinutesPerDay) {
+        return std::nullopt;
+    }
+    return TimeRange{static_cast<uint16_t>(*start), static_cast<uint16_t>(*end)};
+}
+
+/**
+ * Returns the range on a 24-hour clock, such as "18:10-21:50".
+ *
+ * @return The display string.
+ */
+std::string TimeRange::display() const {
+    char buffer[16];
+    std::snprintf(
+        buffer, sizeof(buffer), "%d:%02d-%d:%02d", start / 60, start % 60, end / 60, end % 60);
+    return buffer;
+}
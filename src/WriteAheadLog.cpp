@@ -0,0 +1,551 @@
+// Copyright 2024 Jason Han
+#include "WriteAheadLog.h"
+#include "Crc32c.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+// How long the group commit thread waits before retrying a batch that failed.
+constexpr std::chrono::milliseconds kRetryDelay{10};
+
+template <typename T> void appendPod(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T> bool readPod(const std::string& in, size_t& pos, size_t end, T& value) {
+    if (end - pos < sizeof(value)) {
+        return false;
+    }
+    std::memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+template <typename Len>
+bool readString(const std::string& in, size_t& pos, size_t end, std::string& value) {
+    Len len;
+    if (!readPod(in, pos, end, len) || end - pos < len) {
+        return false;
+    }
+    value.assign(in, pos, len);
+    pos += len;
+    return true;
+}
+
+/**
+ * Decodes a single record payload. Returns false if the payload is malformed.
+ */
+bool decodePayload(const std::string& in, size_t pos, size_t end, WalRecord& record) {
+    uint8_t type;
+    if (!readPod(in, pos, end, type) ||
+        type < static_cast<uint8_t>(WalRecordType::SetEnrollmentCount) ||
+        type > static_cast<uint8_t>(WalRecordType::SetNumberOfMajors)) {
+        return false;
+    }
+    record.type = static_cast<WalRecordType>(type);
+    return readString<uint16_t>(in, pos, end, record.deptCode) &&
+           readString<uint16_t>(in, pos, end, record.courseCode) &&
+           readPod(in, pos, end, record.intValue) &&
+           readString<uint32_t>(in, pos, end, record.stringValue) && pos == end;
+}
+
+}  // namespace
+
+/**
+ * Checks if this record is equal to another record.
+ *
+ * @param rhs                The right hand side WalRecord object to compare to.
+ */
+bool WalRecord::operator==(const WalRecord& rhs) const {
+    return type == rhs.type && deptCode == rhs.deptCode && courseCode == rhs.courseCode &&
+           intValue == rhs.intValue && stringValue == rhs.stringValue;
+}
+
+/**
+ * Returns the group commit statistics as a human-readable string.
+ *
+ * @return The display string.
+ */
+std::string WalStats::display() const {
+    std::ostringstream result;
+    result.setf(std::ios::fixed);
+    result.precision(2);
+    result << "walBatches: " << batches << "\n";
+    result << "walRecords: " << records << "\n";
+    result << "walAverageBatchSize: "
+           << (batches ? static_cast<double>(records) / batches : 0.0) << "\n";
+    result << "walLastBatchSize: " << lastBatchSize << "\n";
+    result << "walMaxBatchSize: " << maxBatchSize << "\n";
+    result << "walAverageCommitLatencyMicros: "
+           << (batches ? static_cast<double>(totalCommitLatencyMicros) / batches : 0.0) << "\n";
+    result << "walLastCommitLatencyMicros: " << lastCommitLatencyMicros << "\n";
+    result << "walMaxCommitLatencyMicros: " << maxCommitLatencyMicros << "\n";
+    return result.str();
+}
+
+/**
+ * Constructs a write-ahead log backed by the given file. The file and the group commit thread are
+ * started lazily on the first append, so a log that is never written to never touches the disk.
+ *
+ * @param path               The path to the log file.
+ */
+WriteAheadLog::WriteAheadLog(const std::string& path)
+    : path(path),
+      rotatedPath(path + ".old"),
+      fd(-1),
+      pendingRecords(0),
+      nextLsn(1),
+      durableLsn(0),
+      groupCommitWindow(std::chrono::microseconds(1000)),
+      failedLsn(0),
+      stopping(false) {}
+
+/**
+ * Commits any pending records, stops the group commit thread and closes the log file.
+ */
+WriteAheadLog::~WriteAheadLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    pendingCondition.notify_all();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+/**
+ * Returns the path of the log file.
+ *
+ * @return The path as a string.
+ */
+const std::string& WriteAheadLog::getPath() const {
+    return path;
+}
+
+/**
+ * Sets how long the group commit thread waits after the first record of a batch arrives before
+ * writing the batch out. A longer window gathers more records per fsync at the cost of latency
+ * for synchronous callers.
+ *
+ * @param window             The batch window.
+ */
+void WriteAheadLog::setGroupCommitWindow(std::chrono::microseconds window) {
+    std::lock_guard<std::mutex> lock(mutex);
+    groupCommitWindow = window;
+}
+
+/**
+ * Returns a copy of the group commit statistics.
+ *
+ * @return The statistics.
+ */
+WalStats WriteAheadLog::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+/**
+ * Parses a durability mode from its URL parameter form.
+ *
+ * @param name               One of "sync", "async" or "none".
+ * @return The durability mode, or std::nullopt if the name isn't recognized.
+ */
+std::optional<Durability> WriteAheadLog::parseDurability(const std::string& name) {
+    if (name == "sync") {
+        return Durability::Sync;
+    }
+    if (name == "async") {
+        return Durability::Async;
+    }
+    if (name == "none") {
+        return Durability::None;
+    }
+    return std::nullopt;
+}
+
+/**
+ * Encodes a record into its on-disk frame: a 4-byte payload length and a 4-byte CRC-32C of the
+ * payload, followed by the payload (type, department code, course code, integer value and string
+ * value).
+ *
+ * @param record             The record to encode.
+ * @return The encoded frame.
+ */
+std::string WriteAheadLog::encode(const WalRecord& record) {
+    std::string payload;
+    appendPod(payload, static_cast<uint8_t>(record.type));
+    appendPod(payload, static_cast<uint16_t>(record.deptCode.length()));
+    payload += record.deptCode;
+    appendPod(payload, static_cast<uint16_t>(record.courseCode.length()));
+    payload += record.courseCode;
+    appendPod(payload, record.intValue);
+    appendPod(payload, static_cast<uint32_t>(record.stringValue.length()));
+    payload += record.stringValue;
+
+    std::string frame;
+    appendPod(frame, static_cast<uint32_t>(payload.length()));
+    appendPod(frame, crc32c(payload.data(), payload.length()));
+    frame += payload;
+    return frame;
+}
+
+/**
+ * Queues a record for the next group commit and returns immediately. Records are written to the
+ * file in the order they are queued.
+ *
+ * @param record             The record to append.
+ * @return The log sequence number of the record, to be passed to waitForDurable().
+ */
+uint64_t WriteAheadLog::enqueue(const WalRecord& record) {
+    return enqueue([&record]() { return record; });
+}
+
+/**
+ * Queues a record built while the log's lock is held, so a record that reads a value other
+ * threads keep changing is ordered after every record built from an earlier reading of it.
+ * Writers that change a value without a lock of their own log it this way: whichever record
+ * comes last holds the latest value.
+ *
+ * @param makeRecord         Builds the record to append.
+ * @return The log sequence number of the record, to be passed to waitForDurable().
+ */
+uint64_t WriteAheadLog::enqueue(const std::function<WalRecord()>& makeRecord) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!flusher.joinable()) {
+        flusher = std::thread(&WriteAheadLog::runFlusher, this);
+    }
+    if (pending.empty()) {
+        oldestPending = std::chrono::steady_clock::now();
+    }
+    pending += encode(makeRecord());
+    pendingRecords++;
+    pendingCondition.notify_one();
+    return nextLsn++;
+}
+
+/**
+ * Blocks until the record with the given sequence number has been fsynced. Throws if a commit
+ * that held the record failed; the record stays queued and is retried with later commits.
+ *
+ * @param lsn                The log sequence number returned by enqueue().
+ */
+void WriteAheadLog::waitForDurable(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex);
+    durableCondition.wait(
+        lock, [&] { return durableLsn >= lsn || (flushError && lsn <= failedLsn); });
+    if (durableLsn < lsn) {
+        std::rethrow_exception(flushError);
+    }
+}
+
+/**
+ * Appends a record to the log and waits until it has been fsynced.
+ *
+ * @param record             The record to append.
+ */
+void WriteAheadLog::append(const WalRecord& record) {
+    waitForDurable(enqueue(record));
+}
+
+/**
+ * Waits until every record queued so far has been fsynced.
+ */
+void WriteAheadLog::flush() {
+    uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        lsn = nextLsn - 1;
+    }
+    waitForDurable(lsn);
+}
+
+/**
+ * Reads every complete record in the log, in the order they were appended, starting with a
+ * segment left behind by a checkpoint that didn't finish. A partially written record at the tail
+ * (from a crash mid-append) is discarded and cut off the file so that later appends start on a
+ * record boundary.
+ *
+ * @return The recovered records.
+ */
+std::vector<WalRecord> WriteAheadLog::recover() {
+    std::vector<WalRecord> records;
+    recoverFile(rotatedPath, records);
+    recoverFile(path, records);
+    return records;
+}
+
+/**
+ * Reads the complete records of one log file and cuts off a torn tail. A frame whose length runs
+ * past the end of the file or whose checksum doesn't match ends the log: everything from there on
+ * was never acknowledged as durable.
+ *
+ * @param file               The path to the log file.
+ * @param records            Receives the records.
+ */
+void WriteAheadLog::recoverFile(const std::string& file, std::vector<WalRecord>& records) {
+    std::ifstream inFile(file, std::ios::binary);
+    if (!inFile) {
+        return;
+    }
+    std::string contents((std::istreambuf_iterator<char>(inFile)),
+                         std::istreambuf_iterator<char>());
+    inFile.close();
+
+    size_t pos = 0;
+    while (pos < contents.length()) {
+        size_t framePos = pos;
+        uint32_t payloadLen;
+        uint32_t payloadCrc;
+        if (!readPod(contents, framePos, contents.length(), payloadLen) ||
+            !readPod(contents, framePos, contents.length(), payloadCrc) ||
+            contents.length() - framePos < payloadLen ||
+            crc32c(contents.data() + framePos, payloadLen) != payloadCrc) {
+            break;
+        }
+        WalRecord record;
+        if (!decodePayload(contents, framePos, framePos + payloadLen, record)) {
+            break;
+        }
+        records.push_back(std::move(record));
+        pos = framePos + payloadLen;
+    }
+
+    if (pos < contents.length()) {
+        std::cerr << "Discarding " << contents.length() - pos
+                  << " bytes of torn write-ahead log tail" << std::endl;
+        std::filesystem::resize_file(file, pos);
+    }
+}
+
+/**
+ * Discards every record in the log, including records still waiting for a group commit. Called
+ * once a checkpoint has made the records redundant; callers waiting on them are released.
+ */
+void WriteAheadLog::truncate() {
+    std::lock_guard<std::mutex> ioLock(ioMutex);
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.clear();
+    pendingRecords = 0;
+    durableLsn = nextLsn - 1;
+    flushError = nullptr;
+    durableCondition.notify_all();
+    committedSize = 0;
+
+    if (fd >= 0) {
+        if (ftruncate(fd, 0) != 0) {
+            throw std::runtime_error("Failed to truncate write-ahead log " + path + ": " +
+                                     std::strerror(errno));
+        }
+        fsync(fd);
+    } else if (std::filesystem::exists(path)) {
+        std::filesystem::resize_file(path, 0);
+    }
+    std::filesystem::remove(rotatedPath);
+}
+
+/**
+ * Moves the records written so far into a separate segment and starts a new log file, without
+ * waiting for pending records; they go to the new file. A checkpoint that captured the catalog
+ * right after rotating calls discardRotated() once its image is on disk, so records logged while
+ * the image is being written are kept. If a segment from an earlier, unfinished checkpoint is
+ * still there, the current file is appended to it instead so that no record is lost.
+ */
+void WriteAheadLog::rotate() {
+    std::lock_guard<std::mutex> ioLock(ioMutex);
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    committedSize.reset();
+    if (!std::filesystem::exists(path)) {
+        return;
+    }
+    if (!std::filesystem::exists(rotatedPath)) {
+        std::filesystem::rename(path, rotatedPath);
+        return;
+    }
+
+    std::ifstream inFile(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(inFile)),
+                         std::istreambuf_iterator<char>());
+    inFile.close();
+    fd = open(rotatedPath.c_str(), O_WRONLY | O_APPEND);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open write-ahead log " + rotatedPath + ": " +
+                                 std::strerror(errno));
+    }
+    try {
+        writeAll(contents);
+        if (fsync(fd) != 0) {
+            throw std::runtime_error("Failed to sync write-ahead log " + rotatedPath + ": " +
+                                     std::strerror(errno));
+        }
+    } catch (...) {
+        close(fd);
+        fd = -1;
+        throw;
+    }
+    close(fd);
+    fd = -1;
+    std::filesystem::remove(path);
+}
+
+/**
+ * Deletes the segment set aside by rotate(). Called once the checkpoint that rotated the log is
+ * durable, which makes every record in the segment redundant.
+ */
+void WriteAheadLog::discardRotated() {
+    std::lock_guard<std::mutex> ioLock(ioMutex);
+    std::filesystem::remove(rotatedPath);
+}
+
+/**
+ * Opens the log file for appending if it isn't already open. Whatever a failed batch left past
+ * the last committed batch is cut off, so the next batch starts on a record boundary.
+ */
+void WriteAheadLog::openForAppend() {
+    if (fd >= 0) {
+        return;
+    }
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open write-ahead log " + path + ": " +
+                                 std::strerror(errno));
+    }
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (size >= 0 && !committedSize) {
+        committedSize = static_cast<uint64_t>(size);
+    }
+    if (size < 0 || (static_cast<uint64_t>(size) > *committedSize &&
+                     ftruncate(fd, static_cast<off_t>(*committedSize)) != 0)) {
+        int error = errno;
+        close(fd);
+        fd = -1;
+        throw std::runtime_error("Failed to cut a failed batch off write-ahead log " + path +
+                                 ": " + std::strerror(error));
+    }
+}
+
+/**
+ * Writes the whole buffer to the log file, retrying short writes.
+ *
+ * @param data               The bytes to write.
+ */
+void WriteAheadLog::writeAll(const std::string& data) {
+    const char* cursor = data.data();
+    size_t remaining = data.length();
+    while (remaining > 0) {
+        ssize_t written = write(fd, cursor, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to append to write-ahead log " + path + ": " +
+                                     std::strerror(errno));
+        }
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+
+/**
+ * Body of the group commit thread. Once a record is pending, waits out the batch window so that
+ * records from other request threads can join, then writes the whole batch with a single write
+ * and a single fsync and wakes everyone waiting on it. A batch that fails is cut off the file and
+ * put back in front of the pending records, and is retried after kRetryDelay, or given up on if
+ * the log is being closed; callers waiting on it are told about the failure.
+ */
+void WriteAheadLog::runFlusher() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        pendingCondition.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;
+        }
+        pendingCondition.wait_until(lock,
+                                    std::max(oldestPending + groupCommitWindow, retryAt),
+                                    [this] { return stopping; });
+
+        lock.unlock();
+        std::unique_lock<std::mutex> ioLock(ioMutex);
+        lock.lock();
+        if (pending.empty()) {
+            continue;  // Truncated while we were waiting.
+        }
+        std::string batch;
+        batch.swap(pending);
+        uint64_t batchRecords = pendingRecords;
+        uint64_t batchLsn = nextLsn - 1;
+        auto batchStart = oldestPending;
+        pendingRecords = 0;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            openForAppend();
+            writeAll(batch);
+            if (fsync(fd) != 0) {
+                throw std::runtime_error("Failed to sync write-ahead log " + path + ": " +
+                                         std::strerror(errno));
+            }
+            off_t size = lseek(fd, 0, SEEK_END);
+            if (size >= 0) {
+                committedSize = static_cast<uint64_t>(size);
+            } else {
+                committedSize.reset();
+            }
+        } catch (...) {
+            error = std::current_exception();
+            // The next attempt reopens the file and cuts off whatever this one wrote.
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        auto latency =
+            std::chrono::duration_cast<std::chrono::microseconds>(now - batchStart).count();
+
+        lock.lock();
+        if (error) {
+            pending.insert(0, batch);
+            pendingRecords += batchRecords;
+            oldestPending = batchStart;
+            flushError = error;
+            failedLsn = batchLsn;
+            retryAt = now + kRetryDelay;
+            durableCondition.notify_all();
+            if (stopping) {
+                return;
+            }
+            continue;
+        }
+        durableLsn = std::max(durableLsn, batchLsn);
+        if (durableLsn >= failedLsn) {
+            flushError = nullptr;
+        }
+        stats.batches++;
+        stats.records += batchRecords;
+        stats.lastBatchSize = batchRecords;
+        stats.maxBatchSize = std::max(stats.maxBatchSize, batchRecords);
+        stats.lastCommitLatencyMicros = static_cast<uint64_t>(latency);
+        stats.maxCommitLatencyMicros =
+            std::max(stats.maxCommitLatencyMicros, static_cast<uint64_t>(latency));
+        stats.totalCommitLatencyMicros += static_cast<uint64_t>(latency);
+        durableCondition.notify_all();
+    }
+}
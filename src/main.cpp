@@ -1,37 +1,53 @@
 // Copyright 2024 Jason Han
 #include <csignal>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <pthread.h>
 #include <string>
 
 #include "MyApp.h"
 #include "RouteController.h"
 #include "crow.h"  // NOLINT
 
-/**
- *  Method to handle proper termination protocols.
- */
-void signalHandler(int signal) {
-    if (signal == SIGINT || signal == SIGTERM) {
-        MyApp::onTermination();
-        std::exit(signal);
-    }
-}
-
 /**
  *  Sets up the HTTP server and runs the program.
  */
 int main(int argc, char* argv[]) {
     std::string mode = argc > 1 ? argv[1] : "run";
     if (mode == "run") {
+        // Block the termination signals before any thread starts, so every thread inherits the
+        // mask and they are only ever taken by the sigwait below, outside any signal handler.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
         MyApp::run("run");
         crow::SimpleApp app;
         app.signal_clear();
-        std::signal(SIGINT, signalHandler);
-        std::signal(SIGTERM, signalHandler);
 
         RouteController routeController;
         routeController.initRoutes(app);
         routeController.setDatabase(MyApp::getDatabase());
-        app.port(8080).multithreaded().run();
+        std::future<void> server = app.port(8080).multithreaded().run_async();
+        app.wait_for_server_start();
+
+        int signal;
+        sigwait(&signals, &signal);
+        app.stop();
+        server.get();
+        MyApp::onTermination();
+        return signal;
+    } else if (mode == "import" && argc > 2) {
+        try {
+            MyApp::importCatalog(argv[2]);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        MyApp::onTermination();
     } else {
         MyApp::run("setup");
         MyApp::onTermination();
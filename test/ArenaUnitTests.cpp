@@ -0,0 +1,74 @@
+// Copyright 2024 Jason Han
+#include "Arena.h"
+#include "Course.h"
+#include "MappedSnapshot.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+
+TEST(ArenaUnitTests, AllocateTest) {
+    Arena arena{64};
+    EXPECT_EQ(arena.getSlabCount(), 0);
+
+    void* first = arena.allocate(3, 1);
+    void* second = arena.allocate(8, 8);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 8, 0);
+    EXPECT_GT(second, first);
+    EXPECT_EQ(arena.getSlabCount(), 1);
+    EXPECT_EQ(arena.getBytesAllocated(), 11);
+
+    // Filling the first slab starts a second, larger one.
+    arena.allocate(60, 1);
+    EXPECT_EQ(arena.getSlabCount(), 2);
+
+    // An allocation larger than any slab gets a slab of its own.
+    void* large = arena.allocate(10000, 16);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(large) % 16, 0);
+    EXPECT_EQ(arena.getSlabCount(), 3);
+}
+
+TEST(ArenaUnitTests, CourseLifetimeTest) {
+    auto arena = std::make_shared<Arena>();
+    std::shared_ptr<Course> course = arena->makeShared<Course>(250,
+                                                               "A very long instructor name",
+                                                               "A very long location name",
+                                                               "10:10-11:25");
+    EXPECT_GT(arena->getBytesAllocated(), sizeof(Course));
+    size_t bytesAllocated = arena->getBytesAllocated();
+
+    // The course keeps the arena alive.
+    std::weak_ptr<Arena> weakArena = arena;
+    arena.reset();
+    EXPECT_FALSE(weakArena.expired());
+    EXPECT_EQ(course->getInstructorName(), "A very long instructor name");
+
+    // Changing a course copies it to the heap.
+    auto copy = std::make_shared<Course>(*course);
+    copy->reassignInstructor("Another very long instructor name");
+    EXPECT_EQ(weakArena.lock()->getBytesAllocated(), bytesAllocated);
+    EXPECT_EQ(copy->getCourseLocation(), "A very long location name");
+
+    course.reset();
+    EXPECT_TRUE(weakArena.expired());
+    EXPECT_EQ(copy->getInstructorName(), "Another very long instructor name");
+}
+
+TEST(ArenaUnitTests, MaterializeTest) {
+    std::map<std::string, Department> mapping;
+    for (int i = 0; i < 20; ++i) {
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (int j = 0; j < 10; ++j) {
+            courses[std::to_string(1000 + j)] = std::make_shared<Course>(
+                i + j, "Instructor " + std::to_string(j), "Room", "1:10-2:25");
+        }
+        std::string deptCode = "D" + std::to_string(100 + i);
+        mapping[deptCode] = Department(deptCode, courses, "Chair", i);
+    }
+    MappedSnapshot::write("arena_test.bin", mapping);
+
+    MappedSnapshot snapshot{"arena_test.bin"};
+    EXPECT_EQ(snapshot.materializeAll(1, AllocationMode::Arena), mapping);
+    EXPECT_EQ(snapshot.materializeAll(4, AllocationMode::Arena), mapping);
+}
@@ -0,0 +1,50 @@
+// Copyright 2024 Jason Han
+#include "ByteReader.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+TEST(ByteReaderUnitTests, ReadTest) {
+    std::string bytes;
+    uint32_t u32 = 0xdeadbeef;
+    int32_t i32 = -42;
+    uint64_t length = 5;
+    bytes.append(reinterpret_cast<const char*>(&u32), sizeof(u32));
+    bytes.append(reinterpret_cast<const char*>(&i32), sizeof(i32));
+    bytes.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    bytes += "hello";
+    bytes += "\xac\x02";  // varint 300
+    bytes += "\x03";      // zigzag -2
+
+    ByteReader reader(bytes, "test");
+    EXPECT_EQ(reader.readU32(), 0xdeadbeef);
+    EXPECT_EQ(reader.readI32(), -42);
+    EXPECT_EQ(reader.readString(reader.readU64()), "hello");
+    EXPECT_EQ(reader.readVarint(), 300);
+    EXPECT_EQ(reader.readSignedVarint32(), -2);
+    EXPECT_EQ(reader.remaining(), 0);
+    EXPECT_NO_THROW(reader.expectEnd());
+}
+
+TEST(ByteReaderUnitTests, BoundsTest) {
+    std::string bytes(12, '\xff');
+    ByteReader reader(bytes, "test");
+    // A huge length fails before anything is allocated.
+    EXPECT_THROW(reader.readString(reader.readU64()), std::runtime_error);
+    EXPECT_EQ(reader.offset(), 8);
+    EXPECT_THROW(reader.readU64(), std::runtime_error);
+    EXPECT_THROW(reader.expectEnd(), std::runtime_error);
+    // Ten continuation bytes can't hold a 64-bit varint.
+    std::string continuations(12, '\x80');
+    ByteReader varints(continuations, "test");
+    EXPECT_THROW(varints.readVarint(), std::runtime_error);
+
+    try {
+        ByteReader(bytes, "snapshot.bin").readBytes(13);
+        FAIL();
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()),
+                  "snapshot.bin is corrupt at offset 0: needs 13 bytes but only 12 remain");
+    }
+}
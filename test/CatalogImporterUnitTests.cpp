@@ -0,0 +1,175 @@
+// Copyright 2024 Jason Han
+#include "CatalogImporter.h"
+#include "MyFileDatabase.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+namespace {
+
+const char* kCsv =
+    "department,chair,majors,course,instructor,location,time,capacity,enrolled\n"
+    "COMS,Luca Carloni,2700,1004,Adam Cannon,417 IAB,11:40-12:55,400,249\n"
+    "COMS,,,4156,Gail Kaiser,501 NWC,10:10-11:25,120,109\n"
+    "IEOR,Jay Sethuraman,67,2500,\"Menon, Uday\",\"627 \"\"MUDD\"\"\",11:40-12:55,50,52\r\n"
+    "\n"
+    "PHYS,Marcia L. Newson,200,,,,,,\n"
+    "COMS,,2701,,,,,,\n";
+
+const char* kJsonLines =
+    R"({"department": "COMS", "chair": "Luca Carloni", "majors": 2700, "course": "1004",)"
+    R"( "instructor": "Adam Cannon", "location": "417 IAB", "time": "11:40-12:55",)"
+    R"( "capacity": 400, "enrolled": 249})"
+    "\n"
+    R"({"department": "COMS", "course": "4156", "instructor": "Gail Kaiser",)"
+    R"( "location": "501 NWC", "time": "10:10-11:25", "capacity": 120, "enrolled": 109})"
+    "\n"
+    R"({"department": "IEOR", "chair": "Jay Sethuraman", "majors": 67, "course": "2500",)"
+    R"( "instructor": "Menon, Uday", "location": "627 \"MUDD\"", "time": "11:40-12:55",)"
+    R"( "capacity": 50, "enrolled": 52, "term": "2024F"})"
+    "\r\n\n"
+    R"({"department": "PHYS", "chair": "Marcia L. Newson", "majors": 200, "course": null})"
+    "\n"
+    R"({"department": "COMS", "majors": 2701})"
+    "\n";
+
+std::map<std::string, Department> ExpectedMapping() {
+    std::map<std::string, std::shared_ptr<Course>> coms;
+    coms["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    coms["1004"]->setEnrolledStudentCount(249);
+    coms["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    coms["4156"]->setEnrolledStudentCount(109);
+    std::map<std::string, std::shared_ptr<Course>> ieor;
+    ieor["2500"] =
+        std::make_shared<Course>(50, "Menon, Uday", "627 \"MUDD\"", "11:40-12:55");
+    ieor["2500"]->setEnrolledStudentCount(52);
+
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", coms, "Luca Carloni", 2701);
+    mapping["IEOR"] = Department("IEOR", ieor, "Jay Sethuraman", 67);
+    mapping["PHYS"] = Department("PHYS", {}, "Marcia L. Newson", 200);
+    return mapping;
+}
+
+std::map<std::string, Department> Parse(ImportFormat format,
+                                        const std::string& text,
+                                        size_t threadCount,
+                                        size_t chunkSize) {
+    CatalogImporter importer(format);
+    importer.setThreadCount(threadCount);
+    importer.setChunkSize(chunkSize);
+    std::istringstream in(text);
+    return importer.parse(in, "catalog");
+}
+
+std::string ParseError(ImportFormat format, const std::string& text) {
+    try {
+        Parse(format, text, 1, 1 << 20);
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+}  // namespace
+
+TEST(CatalogImporterUnitTests, CsvTest) {
+    EXPECT_EQ(Parse(ImportFormat::Csv, kCsv, 1, 1 << 20), ExpectedMapping());
+    // A UTF-8 byte order mark and reordered or unknown columns are fine.
+    std::string reordered = "\xEF\xBB\xBF"
+                            "Course,Capacity,Department,Term\n"
+                            "1004,400,COMS,2024F\n";
+    auto mapping = Parse(ImportFormat::Csv, reordered, 1, 1 << 20);
+    ASSERT_EQ(mapping.count("COMS"), 1);
+    EXPECT_EQ(mapping["COMS"].getCourseSelection().at("1004")->getEnrollmentCapacity(), 400);
+}
+
+TEST(CatalogImporterUnitTests, JsonLinesTest) {
+    EXPECT_EQ(Parse(ImportFormat::JsonLines, kJsonLines, 1, 1 << 20), ExpectedMapping());
+    auto mapping = Parse(ImportFormat::JsonLines,
+                         R"({"department": "FREN", "chair": "Émile 😀\n"})",
+                         1,
+                         1 << 20);
+    EXPECT_EQ(mapping["FREN"].getDepartmentChair(), "\xC3\x89mile \xF0\x9F\x98\x80\n");
+}
+
+TEST(CatalogImporterUnitTests, ChunkedParallelTest) {
+    // Chunks smaller than a record, and records split across chunks inside quotes, give the same
+    // catalog for any thread count.
+    for (size_t threads : {1, 2, 8}) {
+        for (size_t chunkSize : {1, 7, 64, 1 << 20}) {
+            EXPECT_EQ(Parse(ImportFormat::Csv, kCsv, threads, chunkSize), ExpectedMapping());
+            EXPECT_EQ(Parse(ImportFormat::JsonLines, kJsonLines, threads, chunkSize),
+                      ExpectedMapping());
+        }
+    }
+
+    std::string csv = "department,course,capacity,enrolled,location\n";
+    for (int i = 0; i < 5000; ++i) {
+        csv += "D" + std::to_string(i % 50) + "," + std::to_string(i % 700) + ",100," +
+               std::to_string(i) + ",\"Room\n" + std::to_string(i) + "\"\n";
+    }
+    auto serial = Parse(ImportFormat::Csv, csv, 1, 1 << 20);
+    EXPECT_EQ(Parse(ImportFormat::Csv, csv, 4, 512), serial);
+    EXPECT_EQ(serial["D7"].getCourseSelection().at("7")->getEnrolledStudentCount(), 4907);
+}
+
+TEST(CatalogImporterUnitTests, ErrorTest) {
+    EXPECT_EQ(ParseError(ImportFormat::Csv, "course,capacity\n1004,400\n"),
+              "catalog:1: header has no department column");
+    EXPECT_EQ(ParseError(ImportFormat::Csv, "department,course,capacity\nCOMS,1004,\n"),
+              "catalog:2: course 1004 has no capacity");
+    EXPECT_EQ(ParseError(ImportFormat::Csv, "department,course,capacity\n\nCOMS,1004,4x\n"),
+              "catalog:3: capacity is not an integer: '4x'");
+    EXPECT_EQ(ParseError(ImportFormat::Csv, "department,course\n\"COMS,1004\n"),
+              "catalog:2: unterminated quoted field");
+    EXPECT_EQ(ParseError(ImportFormat::Csv, "department\nCOMS,1004\n"),
+              "catalog:2: record has more fields than the header");
+    EXPECT_EQ(ParseError(ImportFormat::JsonLines, "{\"department\": \"COMS\"}\n{\"chair\": 1}"),
+              "catalog:2: record has no department");
+    EXPECT_EQ(ParseError(ImportFormat::JsonLines, "{\"department\": [\"COMS\"]}"),
+              "catalog:1: nested values are not supported");
+    EXPECT_EQ(ParseError(ImportFormat::JsonLines, "{\"department\": \"COMS\"} x"),
+              "catalog:1: unexpected characters after the object");
+
+    // The first bad record in input order is reported, however the chunks were parsed.
+    std::string csv = "department,course,capacity\n";
+    for (int i = 0; i < 1000; ++i) {
+        csv += i == 600 || i == 900 ? "COMS,x,y\n" : "COMS,1004,1\n";
+    }
+    EXPECT_THROW(Parse(ImportFormat::Csv, csv, 4, 64), std::runtime_error);
+    try {
+        Parse(ImportFormat::Csv, csv, 4, 64);
+    } catch (const std::runtime_error& e) {
+        EXPECT_STREQ(e.what(), "catalog:602: capacity is not an integer: 'y'");
+    }
+}
+
+TEST(CatalogImporterUnitTests, ImportFileTest) {
+    EXPECT_EQ(CatalogImporter::formatForPath("fall.csv"), ImportFormat::Csv);
+    EXPECT_EQ(CatalogImporter::formatForPath("fall.jsonl"), ImportFormat::JsonLines);
+    EXPECT_EQ(CatalogImporter::formatForPath("fall.ndjson"), ImportFormat::JsonLines);
+    EXPECT_EQ(CatalogImporter::formatForPath("fall.xlsx"), std::nullopt);
+
+    std::remove("import_test.bin.wal");
+    {
+        std::ofstream out("import_test.csv", std::ios::binary);
+        out << kCsv;
+    }
+    MyFileDatabase db{1, "import_test.bin"};
+    CatalogImporter importer(ImportFormat::Csv);
+    ImportStats stats = importer.importFile("import_test.csv", db);
+    EXPECT_EQ(stats.records, 5);
+    EXPECT_EQ(stats.departments, 3);
+    EXPECT_EQ(stats.courses, 3);
+    EXPECT_EQ(stats.bytes, std::string(kCsv).length());
+
+    MyFileDatabase reloaded{0, "import_test.bin"};
+    EXPECT_EQ(reloaded.getDepartmentMapping(), ExpectedMapping());
+    EXPECT_THROW(importer.importFile("missing.csv", db), std::runtime_error);
+    std::remove("import_test.csv");
+    std::remove("import_test.bin");
+    std::remove("import_test.bin.wal");
+}
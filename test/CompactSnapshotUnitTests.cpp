@@ -0,0 +1,39 @@
+// Copyright 2024 Jason Han
+#include "CompactSnapshot.h"
+#include "MyFileDatabase.h"
+#include "TestCatalog.h"
+#include <gtest/gtest.h>
+
+TEST(CompactSnapshotUnitTests, EncodeDecodeTest) {
+    auto mapping = MakeMapping();
+    mapping["IEOR"].getCourseSelection().at("2500")->setEnrolledStudentCount(-1);
+    std::string plain = CompactSnapshot::encode(mapping, CompactCompression::None);
+    std::string compressed = CompactSnapshot::encode(mapping, CompactCompression::Zlib);
+    EXPECT_EQ(CompactSnapshot::decode(plain), mapping);
+    EXPECT_EQ(CompactSnapshot::decode(compressed), mapping);
+
+    // Repeated strings are stored once.
+    EXPECT_EQ(plain.find("417 IAB"), plain.rfind("417 IAB"));
+    EXPECT_EQ(plain.find("11:40-12:55"), plain.rfind("11:40-12:55"));
+}
+
+TEST(CompactSnapshotUnitTests, CorruptTest) {
+    std::string bytes = CompactSnapshot::encode(MakeMapping(), CompactCompression::None);
+    for (size_t length = 0; length < bytes.length(); ++length) {
+        EXPECT_THROW(CompactSnapshot::decode(bytes.substr(0, length)), std::runtime_error);
+    }
+    std::string compressed = CompactSnapshot::encode(MakeMapping(), CompactCompression::Zlib);
+    compressed[compressed.length() / 2] ^= 0x5a;
+    EXPECT_THROW(CompactSnapshot::decode(compressed), std::runtime_error);
+}
+
+TEST(CompactSnapshotUnitTests, DatabaseRoundTripTest) {
+    MyFileDatabase db{1, "compact_test.bin"};
+    db.setSnapshotFormat(SnapshotFormat::Compact);
+    db.setMapping(MakeMapping());
+    db.saveContentsToFile();
+    EXPECT_TRUE(CompactSnapshot::isCompactSnapshot("compact_test.bin"));
+
+    MyFileDatabase reloaded{0, "compact_test.bin"};
+    EXPECT_EQ(reloaded.getDepartmentMapping(), MakeMapping());
+}
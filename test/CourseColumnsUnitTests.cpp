@@ -0,0 +1,83 @@
+// Copyright 2024 Jason Han
+#include "CourseColumns.h"
+#include "TestCatalog.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<std::pair<std::string_view, const Department*>> Departments(
+    const std::map<std::string, Department>& mapping) {
+    std::vector<std::pair<std::string_view, const Department*>> departments;
+    for (const auto& [deptCode, dept] : mapping) {
+        departments.emplace_back(deptCode, &dept);
+    }
+    return departments;
+}
+
+}  // namespace
+
+TEST(CourseColumnsUnitTests, FindTest) {
+    auto mapping = MakeMapping();
+    CourseColumns columns{Departments(mapping)};
+    ASSERT_EQ(columns.size(), 4);
+
+    EXPECT_EQ(columns.find("COMS", "1004"), 0);
+    EXPECT_EQ(columns.find("COMS", "4156"), 2);
+    EXPECT_EQ(columns.find("IEOR", "2500"), 3);
+    EXPECT_EQ(columns.find("COMS", "2500"), std::nullopt);
+    EXPECT_EQ(columns.find("PHYS", "1001"), std::nullopt);
+    EXPECT_EQ(columns.find("ECON", "1004"), std::nullopt);
+    EXPECT_EQ(columns.getKey(3), (CourseKey{"IEOR", "2500"}));
+}
+
+TEST(CourseColumnsUnitTests, ScanTest) {
+    auto mapping = MakeMapping();
+    CourseColumns columns{Departments(mapping)};
+
+    EXPECT_EQ(columns.findFull(), (std::vector<uint32_t>{1, 3}));
+    EXPECT_EQ(columns.findByLocation(InternedString::intern("417 IAB")),
+              (std::vector<uint32_t>{0, 1, 3}));
+    EXPECT_EQ(columns.findByInstructor(InternedString::intern("Gail Kaiser")),
+              (std::vector<uint32_t>{2}));
+    EXPECT_EQ(columns.findByTimeSlot(InternedString::intern("11:40-12:55")),
+              (std::vector<uint32_t>{0, 3}));
+    EXPECT_TRUE(columns.findByLocation(InternedString::intern("Nowhere")).empty());
+
+    Course moved{120, "Gail Kaiser", "417 IAB", "10:10-11:25"};
+    moved.setEnrolledStudentCount(120);
+    columns.update(2, moved);
+    EXPECT_EQ(columns.findFull(), (std::vector<uint32_t>{1, 2, 3}));
+    EXPECT_EQ(columns.findByLocation(InternedString::intern("417 IAB")),
+              (std::vector<uint32_t>{0, 1, 2, 3}));
+    EXPECT_TRUE(columns.findByLocation(InternedString::intern("501 NWC")).empty());
+
+    Course retaught{400, "Gail Kaiser", "417 IAB", "11:40-12:55"};
+    columns.update(0, retaught);
+    EXPECT_EQ(columns.findByInstructor(InternedString::intern("Gail Kaiser")),
+              (std::vector<uint32_t>{0, 2}));
+    EXPECT_TRUE(columns.findByInstructor(InternedString::intern("Adam Cannon")).empty());
+    EXPECT_EQ(columns.findByTimeSlot(InternedString::intern("11:40-12:55")),
+              (std::vector<uint32_t>{0, 3}));
+}
+
+TEST(CourseColumnsUnitTests, RefreshFullnessTest) {
+    auto mapping = MakeMapping();
+    CourseColumns columns{Departments(mapping)};
+
+    // Seat changes that keep a course on the same side of full leave the column alone.
+    Course coms4156{120, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    coms4156.setEnrolledStudentCount(119);
+    columns.refreshFullness(2, coms4156);
+    EXPECT_EQ(columns.findFull(), (std::vector<uint32_t>{1, 3}));
+    EXPECT_TRUE(coms4156.enrollStudent());
+    columns.refreshFullness(2, coms4156);
+    EXPECT_EQ(columns.findFull(), (std::vector<uint32_t>{1, 2, 3}));
+    EXPECT_TRUE(coms4156.dropStudent());
+    columns.refreshFullness(2, coms4156);
+    EXPECT_EQ(columns.findFull(), (std::vector<uint32_t>{1, 3}));
+}
@@ -1,6 +1,9 @@
 // Copyright 2024 Jason Han
 #include "Course.h"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 TEST(CourseUnitTests, DefaultConstructorTest) {
     Course coms4156{};
@@ -54,6 +57,130 @@ TEST(CourseUnitTests, DropTest) {
     EXPECT_FALSE(coms4156.dropStudent());
 }
 
+TEST(CourseUnitTests, SeatTest) {
+    Course coms4156{2, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    EXPECT_EQ(coms4156.reserveSeat(), SeatChange::Applied);
+    EXPECT_EQ(coms4156.reserveSeat(), SeatChange::Applied);
+    EXPECT_EQ(coms4156.reserveSeat(), SeatChange::Rejected);
+    EXPECT_EQ(coms4156.releaseSeat(), SeatChange::Applied);
+    EXPECT_EQ(coms4156.storeSeats(0), SeatChange::Applied);
+    EXPECT_EQ(coms4156.releaseSeat(), SeatChange::Rejected);
+    EXPECT_EQ(coms4156.storeSeats(1), SeatChange::Applied);
+
+    // A retired course keeps its count but takes no more changes; copies start out live.
+    EXPECT_EQ(coms4156.retireSeats(), 1);
+    EXPECT_TRUE(coms4156.isRetired());
+    EXPECT_EQ(coms4156.getEnrolledStudentCount(), 1);
+    EXPECT_EQ(coms4156.reserveSeat(), SeatChange::Stale);
+    EXPECT_EQ(coms4156.releaseSeat(), SeatChange::Stale);
+    EXPECT_EQ(coms4156.storeSeats(0), SeatChange::Stale);
+    EXPECT_FALSE(coms4156.enrollStudent());
+    Course copy = coms4156;
+    EXPECT_FALSE(copy.isRetired());
+    EXPECT_EQ(copy, coms4156);
+    EXPECT_TRUE(copy.enrollStudent());
+
+    // Negative counts survive the packing.
+    copy.setEnrolledStudentCount(-3);
+    EXPECT_EQ(copy.getEnrolledStudentCount(), -3);
+
+    // Seat counts of neighbouring courses never share a cache line.
+    EXPECT_EQ(alignof(Course), 64);
+}
+
+TEST(CourseUnitTests, BatchSeatTest) {
+    // Each change in a batch is checked against the count the changes before it leave.
+    Course coms4156{2, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    int deltas[] = {1, 1, 1, -1, 1, -1, -1, -1, -1};
+    SeatChange results[9];
+    EXPECT_EQ(coms4156.changeSeats(deltas, results, 9), SeatChange::Applied);
+    EXPECT_EQ(std::vector<SeatChange>(results, results + 9),
+              (std::vector<SeatChange>{SeatChange::Applied,
+                                       SeatChange::Applied,
+                                       SeatChange::Rejected,
+                                       SeatChange::Applied,
+                                       SeatChange::Applied,
+                                       SeatChange::Applied,
+                                       SeatChange::Applied,
+                                       SeatChange::Rejected,
+                                       SeatChange::Rejected}));
+    EXPECT_EQ(coms4156.getEnrolledStudentCount(), 0);
+    EXPECT_EQ(coms4156.changeSeats(deltas, results, 2), SeatChange::Applied);
+    EXPECT_EQ(coms4156.getEnrolledStudentCount(), 2);
+    EXPECT_EQ(coms4156.tryChangeSeats(-2), SeatChange::Applied);
+
+    coms4156.retireSeats();
+    EXPECT_EQ(coms4156.changeSeats(deltas, results, 9), SeatChange::Stale);
+    EXPECT_EQ(coms4156.tryChangeSeats(1), SeatChange::Stale);
+    EXPECT_EQ(coms4156.getEnrolledStudentCount(), 0);
+}
+
+TEST(CourseUnitTests, VersionTest) {
+    // Seat changes leave the version alone, so a change expects the count too, and conflicts if
+    // either has moved on.
+    Course coms4156{2, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    EXPECT_EQ(coms4156.getVersion(), 0);
+    EXPECT_EQ(coms4156.reserveSeat(), SeatChange::Applied);
+    int deltas[] = {1, -1, 1};
+    SeatChange results[3];
+    EXPECT_EQ(coms4156.changeSeats(deltas, results, 3), SeatChange::Applied);
+    EXPECT_EQ(coms4156.getVersion(), 0);
+    EXPECT_EQ(coms4156.getState().count, 2);
+    EXPECT_EQ(coms4156.storeSeats(1, CourseState{0, 1}), SeatChange::Conflict);
+    EXPECT_EQ(coms4156.storeSeats(1, CourseState{1, 2}), SeatChange::Conflict);
+    EXPECT_EQ(coms4156.getEnrolledStudentCount(), 2);
+    EXPECT_EQ(coms4156.storeSeats(1, CourseState{0, 2}), SeatChange::Applied);
+    EXPECT_EQ(coms4156.getEnrolledStudentCount(), 1);
+
+    // A copy keeps the version, and superseding the original carries it one further.
+    Course next = coms4156;
+    EXPECT_EQ(next.getVersion(), 0);
+    EXPECT_FALSE(next.supersede(coms4156, CourseState{0, 2}));
+    EXPECT_FALSE(coms4156.isRetired());
+    EXPECT_TRUE(next.supersede(coms4156, CourseState{0, 1}));
+    EXPECT_TRUE(coms4156.isRetired());
+    EXPECT_EQ(next.getVersion(), 1);
+    EXPECT_EQ(next.getEnrolledStudentCount(), 1);
+    EXPECT_EQ(next.storeSeats(0, CourseState{0, 1}), SeatChange::Conflict);
+}
+
+TEST(CourseUnitTests, ConcurrentSeatTest) {
+    // Threads race to enroll in a course with fewer seats than attempts: exactly the capacity gets
+    // in. Then they race to drop everyone.
+    constexpr int kCapacity = 1000;
+    constexpr int kThreads = 8;
+    Course coms4156{kCapacity, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    std::atomic<int> enrolled{0};
+    std::atomic<int> dropped{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < kCapacity / 4; ++i) {
+                enrolled += coms4156.enrollStudent() ? 1 : 0;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(enrolled, kCapacity);
+    EXPECT_EQ(coms4156.getEnrolledStudentCount(), kCapacity);
+
+    threads.clear();
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < kCapacity / 4; ++i) {
+                dropped += coms4156.dropStudent() ? 1 : 0;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(dropped, kCapacity);
+    EXPECT_EQ(coms4156.getEnrolledStudentCount(), 0);
+}
+
 TEST(CourseUnitTests, ReassignTest) {
     Course coms1004{10, "Gail Kaiser", "501 NWC", "10:10-11:25"};
 
@@ -64,6 +191,10 @@ TEST(CourseUnitTests, ReassignTest) {
     EXPECT_EQ(coms1004.getCourseLocation(), "417 IAB");
     EXPECT_EQ(coms1004.getInstructorName(), "Adam Cannon");
     EXPECT_EQ(coms1004.getCourseTimeSlot(), "11:40-12:55");
+    EXPECT_EQ(coms1004.getTimeRange(), TimeRange::parse("11:40-12:55"));
+
+    coms1004.reassignTime("TBA");
+    EXPECT_EQ(coms1004.getTimeRange(), std::nullopt);
 }
 
 TEST(CourseUnitTests, EqualityTest) {
@@ -0,0 +1,27 @@
+// Copyright 2024 Jason Han
+#include "Crc32c.h"
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(Crc32cUnitTests, KnownValueTest) {
+    std::string check = "123456789";
+    EXPECT_EQ(crc32c(check.data(), check.length()), 0xe3069283);
+    EXPECT_EQ(crc32cPortable(check.data(), check.length()), 0xe3069283);
+    EXPECT_EQ(crc32c("", 0), 0);
+}
+
+TEST(Crc32cUnitTests, MatchesPortableTest) {
+    std::string bytes(1021, '\0');
+    for (size_t i = 0; i < bytes.length(); ++i) {
+        bytes[i] = static_cast<char>(i * 131 + 7);
+    }
+    // Unaligned starts and odd lengths exercise the byte-at-a-time tails.
+    for (size_t start = 0; start < 16; ++start) {
+        size_t length = bytes.length() - 2 * start;
+        EXPECT_EQ(crc32c(bytes.data() + start, length),
+                  crc32cPortable(bytes.data() + start, length));
+    }
+    uint32_t pieces = crc32c(bytes.data(), 300);
+    pieces = crc32c(bytes.data() + 300, bytes.length() - 300, pieces);
+    EXPECT_EQ(pieces, crc32c(bytes.data(), bytes.length()));
+}
@@ -24,6 +24,8 @@ TEST(DepartmentUnitTests, GetterTest) {
     EXPECT_EQ(ieor.getNumberOfMajors(), 67);
     EXPECT_EQ(ieor.getDepartmentChair(), "Jay Sethuraman");
     EXPECT_EQ(ieor.getCourseSelection(), courses);
+    EXPECT_EQ(ieor.findCourse("3404"), ieor3404.get());
+    EXPECT_EQ(ieor.findCourse("9999"), nullptr);
 }
 
 TEST(DepartmentUnitTests, DisplayTest) {
@@ -128,3 +130,27 @@ TEST(DepartmentUnitTests, InequalityByCourseValuesTest) {
     Department d2("IEOR", courses2, "Jay Sethuraman", 67);
     EXPECT_NE(d1, d2);
 }
+
+TEST(DepartmentUnitTests, CopyTest) {
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    auto ieor2500 = std::make_shared<Course>(50, "Uday Menon", "627 MUDD", "11:40-12:55");
+    courses["2500"] = ieor2500;
+
+    // A copy shares the courses but keeps working once the original, whose keys it was copied
+    // from, is gone.
+    auto original = std::make_unique<Department>("IEOR", courses, "Jay Sethuraman", 67);
+    Department copy(*original);
+    Department assigned;
+    assigned = *original;
+    original.reset();
+    EXPECT_EQ(copy.findCourse("2500"), ieor2500.get());
+    EXPECT_EQ(assigned.findCourse("2500"), ieor2500.get());
+
+    copy.addCourse("3106", std::make_shared<Course>(120, "Ali Hirsa", "301 URIS", "1:10-2:25"));
+    EXPECT_NE(copy.findCourse("3106"), nullptr);
+    EXPECT_EQ(assigned.findCourse("3106"), nullptr);
+
+    Department moved(std::move(copy));
+    EXPECT_EQ(moved.findCourse("2500"), ieor2500.get());
+    EXPECT_NE(moved.findCourse("3106"), nullptr);
+}
@@ -0,0 +1,107 @@
+// Copyright 2024 Jason Han
+#include "DepartmentWriters.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(DepartmentWritersUnitTests, OwnerOfTest) {
+    DepartmentWriters writers{4, {{"COMS", 1}, {"IEOR", 6}}};
+    EXPECT_EQ(writers.getThreadCount(), 4);
+    EXPECT_EQ(writers.ownerOf("COMS"), 1);
+    EXPECT_EQ(writers.ownerOf("IEOR"), 2);
+    EXPECT_EQ(writers.ownerOf("MATH"), writers.ownerOf(std::string("MATH")));
+    EXPECT_LT(writers.ownerOf("MATH"), 4);
+
+    EXPECT_EQ(DepartmentWriters(0).getThreadCount(), 0);
+    EXPECT_EQ(DepartmentWriters(0).ownerOf("COMS"), 0);
+}
+
+TEST(DepartmentWritersUnitTests, RunTest) {
+    DepartmentWriters writers{2, {{"COMS", 0}, {"IEOR", 1}}};
+    std::thread::id coms;
+    std::thread::id ieor;
+    writers.run("COMS", [&]() { coms = std::this_thread::get_id(); });
+    writers.run("IEOR", [&]() { ieor = std::this_thread::get_id(); });
+    EXPECT_NE(coms, std::this_thread::get_id());
+    EXPECT_NE(coms, ieor);
+    writers.run("COMS", [&]() { EXPECT_EQ(std::this_thread::get_id(), coms); });
+
+    // Exceptions reach the caller, and the owner keeps going.
+    EXPECT_THROW(writers.run("COMS", []() { throw std::runtime_error("rejected"); }),
+                 std::runtime_error);
+    int runs = 0;
+    writers.run("COMS", [&]() { runs++; });
+    EXPECT_EQ(runs, 1);
+}
+
+TEST(DepartmentWritersUnitTests, StripedRunTest) {
+    // Without owner threads, changes run on the caller's thread.
+    DepartmentWriters writers{0};
+    std::thread::id coms;
+    writers.run("COMS", [&]() { coms = std::this_thread::get_id(); });
+    EXPECT_EQ(coms, std::this_thread::get_id());
+    EXPECT_THROW(writers.run("COMS", []() { throw std::runtime_error("rejected"); }),
+                 std::runtime_error);
+
+    // A pause keeps every change waiting until it ends.
+    int runs = 0;
+    {
+        std::lock_guard<DepartmentWriters> pause(writers);
+        std::thread writer([&]() { writers.run("IEOR", [&]() { runs++; }); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_EQ(runs, 0);
+        writers.unlock();
+        writer.join();
+        writers.lock();
+    }
+    EXPECT_EQ(runs, 1);
+}
+
+TEST(DepartmentWritersUnitTests, ConcurrentRunTest) {
+    // Many threads submit changes to a few departments without any lock of their own: each
+    // department's changes run one at a time, in the order each thread submitted them, both on
+    // owner threads and under stripes.
+    constexpr int kThreads = 16;
+    constexpr int kRounds = 2000;
+    for (size_t threadCount : {0, 3}) {
+        DepartmentWriters writers{threadCount};
+        std::vector<std::string> deptCodes = {"COMS", "IEOR", "MATH", "PHYS", "CHEM"};
+        std::vector<int> counts(deptCodes.size());
+        std::vector<std::vector<int>> lastSeen(deptCodes.size(), std::vector<int>(kThreads, -1));
+        std::atomic<bool> failed{false};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < kRounds; ++i) {
+                    size_t d = (t + i) % deptCodes.size();
+                    writers.run(deptCodes[d], [&, d, t, i]() {
+                        counts[d]++;
+                        failed = failed || lastSeen[d][t] >= i;
+                        lastSeen[d][t] = i;
+                    });
+                }
+            });
+        }
+        // Pauses come between changes.
+        for (int i = 0; i < 20; ++i) {
+            std::lock_guard<DepartmentWriters> pause(writers);
+            std::vector<int> before = counts;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            EXPECT_EQ(counts, before);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        EXPECT_FALSE(failed);
+        int total = 0;
+        for (int count : counts) {
+            total += count;
+        }
+        EXPECT_EQ(total, kThreads * kRounds);
+    }
+}
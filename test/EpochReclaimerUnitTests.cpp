@@ -0,0 +1,72 @@
+// Copyright 2024 Jason Han
+#include "EpochReclaimer.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+namespace {
+
+struct Tracked {
+    explicit Tracked(std::atomic<int>& deleted) : deleted(deleted) {}
+    ~Tracked() {
+        deleted++;
+    }
+
+    std::atomic<int>& deleted;
+};
+
+}  // namespace
+
+TEST(EpochReclaimerUnitTests, RetireWithoutReadersTest) {
+    std::atomic<int> deleted{0};
+    EpochReclaimer::retire(new Tracked(deleted));
+    EXPECT_EQ(deleted, 1);
+    EpochReclaimer::retire(static_cast<const Tracked*>(nullptr));
+    EXPECT_EQ(EpochReclaimer::getPendingCount(), 0);
+}
+
+TEST(EpochReclaimerUnitTests, GuardDefersDeletionTest) {
+    std::atomic<int> deleted{0};
+    {
+        EpochGuard outer;
+        {
+            EpochGuard inner;
+            EpochReclaimer::retire(new Tracked(deleted));
+        }
+        // Releasing a nested guard keeps the thread pinned.
+        EXPECT_EQ(EpochReclaimer::reclaim(), 0);
+        EXPECT_EQ(deleted, 0);
+        EXPECT_EQ(EpochReclaimer::getPendingCount(), 1);
+
+        EpochGuard moved(std::move(outer));
+        EXPECT_EQ(EpochReclaimer::reclaim(), 0);
+    }
+    EXPECT_EQ(EpochReclaimer::reclaim(), 1);
+    EXPECT_EQ(deleted, 1);
+}
+
+TEST(EpochReclaimerUnitTests, OtherThreadTest) {
+    std::atomic<int> deleted{0};
+    std::atomic<int> stage{0};
+    std::thread reader([&stage]() {
+        EpochGuard guard;
+        stage = 1;
+        while (stage != 2) {
+            std::this_thread::yield();
+        }
+    });
+    while (stage != 1) {
+        std::this_thread::yield();
+    }
+    EpochReclaimer::retire(new Tracked(deleted));
+    {
+        // A guard taken after the retirement can't have seen the object and doesn't hold it up.
+        EpochGuard later;
+        EXPECT_EQ(deleted, 0);
+        stage = 2;
+        reader.join();
+        EXPECT_EQ(EpochReclaimer::reclaim(), 1);
+    }
+    EXPECT_EQ(deleted, 1);
+}
@@ -0,0 +1,54 @@
+// Copyright 2024 Jason Han
+#include "HashIndex.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(HashIndexUnitTests, EmptyTest) {
+    HashIndex<int> index;
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_EQ(index.find("COMS"), nullptr);
+    EXPECT_EQ(index.find(""), nullptr);
+}
+
+TEST(HashIndexUnitTests, InsertFindTest) {
+    std::vector<std::string> keys = {"COMS", "MATH", "IEOR", "", "COMS1004"};
+    HashIndex<size_t> index;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        index.insert(keys[i], i);
+    }
+    EXPECT_EQ(index.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        // The lookup key lives in a different buffer than the indexed one.
+        std::string lookup = keys[i];
+        ASSERT_NE(index.find(lookup), nullptr);
+        EXPECT_EQ(*index.find(lookup), i);
+    }
+    EXPECT_EQ(index.find("COM"), nullptr);
+    EXPECT_EQ(index.find("coms"), nullptr);
+
+    // Inserting an existing key updates its value.
+    index.insert("MATH", 42);
+    EXPECT_EQ(index.size(), keys.size());
+    EXPECT_EQ(*index.find("MATH"), 42);
+
+    index.clear();
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_EQ(index.find("MATH"), nullptr);
+}
+
+TEST(HashIndexUnitTests, GrowthTest) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 5000; ++i) {
+        keys.push_back(std::to_string(i));
+    }
+    HashIndex<int> index;
+    for (int i = 0; i < 5000; ++i) {
+        index.insert(keys[i], i);
+    }
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_NE(index.find(keys[i]), nullptr);
+        EXPECT_EQ(*index.find(keys[i]), i);
+    }
+    EXPECT_EQ(index.find("5000"), nullptr);
+}
@@ -0,0 +1,69 @@
+// Copyright 2024 Jason Han
+#include "Course.h"
+#include "InternTable.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(InternTableUnitTests, InternResolveTest) {
+    InternTable table;
+    EXPECT_EQ(table.size(), 1);
+    EXPECT_EQ(table.intern(""), 0);
+    EXPECT_EQ(table.resolve(0), "");
+
+    uint32_t room = table.intern("417 IAB");
+    uint32_t time = table.intern("11:40-12:55");
+    EXPECT_NE(room, 0);
+    EXPECT_NE(room, time);
+    // The lookup key lives in a different buffer than the interned one.
+    std::string copy = "417 IAB";
+    EXPECT_EQ(table.intern(copy), room);
+    EXPECT_EQ(table.resolve(room), "417 IAB");
+    EXPECT_EQ(table.resolve(time), "11:40-12:55");
+    EXPECT_EQ(table.size(), 3);
+}
+
+TEST(InternTableUnitTests, ConcurrentInternTest) {
+    InternTable table;
+    // Enough strings to span several ID chunks, interned by every thread in a different order.
+    std::vector<std::string> values;
+    for (int i = 0; i < 10000; ++i) {
+        values.push_back("Room " + std::to_string(i));
+    }
+    std::vector<std::vector<uint32_t>> ids(8, std::vector<uint32_t>(values.size()));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ids.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < values.size(); ++i) {
+                size_t index = (i * 7919 + t * 1000) % values.size();
+                ids[t][index] = table.intern(values[index]);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(table.size(), values.size() + 1);
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t t = 1; t < ids.size(); ++t) {
+            ASSERT_EQ(ids[t][i], ids[0][i]);
+        }
+        EXPECT_EQ(table.resolve(ids[0][i]), values[i]);
+    }
+}
+
+TEST(InternTableUnitTests, CourseTest) {
+    Course first{120, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    Course second{50, "Uday Menon", "501 NWC", "10:10-11:25"};
+    EXPECT_EQ(first.getInternedLocation(), second.getInternedLocation());
+    EXPECT_EQ(first.getInternedTimeSlot(), second.getInternedTimeSlot());
+    EXPECT_NE(first.getInternedInstructor(), second.getInternedInstructor());
+
+    second.reassignInstructor("Gail Kaiser");
+    EXPECT_EQ(first.getInternedInstructor(), second.getInternedInstructor());
+    EXPECT_EQ(second.getInternedInstructor(), InternedString::intern("Gail Kaiser"));
+    EXPECT_EQ(second.getInternedInstructor().view(), "Gail Kaiser");
+    EXPECT_EQ(Course().getInternedLocation(), InternedString());
+}
@@ -0,0 +1,150 @@
+// Copyright 2024 Jason Han
+#include "MappedSnapshot.h"
+#include "MyFileDatabase.h"
+#include "TestCatalog.h"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+TEST(MappedSnapshotUnitTests, WriteReadTest) {
+    auto mapping = MakeMapping();
+    MappedSnapshot::write("mapped_test.bin", mapping);
+    EXPECT_TRUE(MappedSnapshot::isMappedSnapshot("mapped_test.bin"));
+
+    MappedSnapshot snapshot{"mapped_test.bin"};
+    ASSERT_EQ(snapshot.getDepartmentCount(), 3);
+    EXPECT_EQ(snapshot.getDepartmentCode(0), "COMS");
+    EXPECT_EQ(snapshot.getDepartmentCode(1), "IEOR");
+    EXPECT_EQ(snapshot.getDepartmentCode(2), "PHYS");
+    EXPECT_EQ(snapshot.getDepartmentChair(0), "Luca Carloni");
+    EXPECT_EQ(snapshot.getNumberOfMajors(0), 2700);
+    ASSERT_EQ(snapshot.getCourseCount(0), 3);
+    EXPECT_EQ(snapshot.getCourseCount(2), 0);
+
+    MappedCourseView course = snapshot.getCourse(0, 2);
+    EXPECT_EQ(course.courseId, "4156");
+    EXPECT_EQ(course.instructorName, "Gail Kaiser");
+    EXPECT_EQ(course.courseLocation, "501 NWC");
+    EXPECT_EQ(course.courseTimeSlot, "10:10-11:25");
+    EXPECT_EQ(course.enrollmentCapacity, 120);
+    EXPECT_EQ(course.enrolledStudentCount, 109);
+
+    EXPECT_EQ(snapshot.materializeAll(), mapping);
+}
+
+TEST(MappedSnapshotUnitTests, ParallelMaterializeTest) {
+    std::map<std::string, Department> mapping = MakeMapping();
+    for (int i = 0; i < 50; ++i) {
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        courses["1001"] = std::make_shared<Course>(i, "Instructor", "Room", "1:10-2:25");
+        std::string deptCode = "D" + std::to_string(100 + i);
+        mapping[deptCode] = Department(deptCode, courses, "Chair", i);
+    }
+    MappedSnapshot::write("mapped_test.bin", mapping);
+
+    MappedSnapshot snapshot{"mapped_test.bin"};
+    EXPECT_EQ(snapshot.materializeAll(4), mapping);
+    EXPECT_EQ(snapshot.materializeAll(64), mapping);
+
+    std::vector<Department> departments = snapshot.materialize({2, 0}, 2);
+    ASSERT_EQ(departments.size(), 2);
+    EXPECT_EQ(departments[0], mapping.at(std::string(snapshot.getDepartmentCode(2))));
+    EXPECT_EQ(departments[1], mapping.at(std::string(snapshot.getDepartmentCode(0))));
+}
+
+TEST(MappedSnapshotUnitTests, IncrementalWriteTest) {
+    auto mapping = MakeMapping();
+    MappedSnapshot::write("mapped_test.bin", mapping);
+    MappedSnapshot before{"mapped_test.bin"};
+
+    mapping["COMS"].setNumberOfMajors(2800);
+    std::map<std::string, std::shared_ptr<Course>> econ;
+    econ["1105"] = std::make_shared<Course>(210, "Waseem Noor", "309 HAV", "2:40-3:55");
+    mapping["ECON"] = Department("ECON", econ, "Michael Woodford", 2345);
+    std::map<std::string, std::optional<std::string>> segments;
+    segments["COMS"] = MappedSnapshot::encodeSegment(mapping["COMS"]);
+    segments["ECON"] = MappedSnapshot::encodeSegment(mapping["ECON"]);
+    segments["IEOR"] = std::nullopt;
+    segments["PHYS"] = std::nullopt;
+
+    MappedWriteStats stats = MappedSnapshot::writeIncremental("mapped_test.bin", segments, 0.9);
+    EXPECT_FALSE(stats.compacted);
+    EXPECT_EQ(stats.segmentsWritten, 2);
+    EXPECT_EQ(stats.segmentsReused, 2);
+    EXPECT_EQ(MappedSnapshot("mapped_test.bin").materializeAll(), mapping);
+    // A snapshot opened before the write keeps reading the previous directory.
+    EXPECT_EQ(before.getDepartmentCount(), 3);
+    EXPECT_EQ(before.getNumberOfMajors(0), 2700);
+
+    segments["COMS"] = std::nullopt;
+    segments["ECON"] = std::nullopt;
+    stats = MappedSnapshot::writeIncremental("mapped_test.bin", segments, 0.0);
+    EXPECT_TRUE(stats.compacted);
+    EXPECT_EQ(stats.segmentsReused, 4);
+    EXPECT_EQ(stats.bytesWritten, std::filesystem::file_size("mapped_test.bin"));
+    EXPECT_EQ(MappedSnapshot("mapped_test.bin").materializeAll(), mapping);
+
+    segments["MATH"] = std::nullopt;
+    EXPECT_THROW(MappedSnapshot::writeIncremental("mapped_test.bin", segments, 0.9),
+                 std::runtime_error);
+}
+
+TEST(MappedSnapshotUnitTests, LegacyMigrationTest) {
+    auto mapping = MakeMapping();
+
+    MyFileDatabase legacy{1, "mapped_test.bin"};
+    legacy.setSnapshotFormat(SnapshotFormat::Legacy);
+    legacy.setMapping(mapping);
+    legacy.checkpoint();
+    EXPECT_FALSE(MappedSnapshot::isMappedSnapshot("mapped_test.bin"));
+
+    // A legacy file still loads, and the next checkpoint migrates it to the mapped format.
+    MyFileDatabase migrated{0, "mapped_test.bin"};
+    EXPECT_EQ(migrated.getDepartmentMapping(), mapping);
+    migrated.checkpoint();
+    EXPECT_TRUE(MappedSnapshot::isMappedSnapshot("mapped_test.bin"));
+
+    MyFileDatabase reloaded{0, "mapped_test.bin"};
+    EXPECT_EQ(reloaded.getDepartmentMapping(), mapping);
+}
+
+TEST(MappedSnapshotUnitTests, TruncatedFileTest) {
+    MappedSnapshot::write("mapped_test.bin", MakeMapping());
+    std::ifstream inFile("mapped_test.bin", std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(inFile)),
+                         std::istreambuf_iterator<char>());
+    inFile.close();
+
+    std::ofstream outFile("mapped_test.bin", std::ios::binary | std::ios::trunc);
+    outFile.write(contents.data(), contents.length() / 2);
+    outFile.close();
+
+    EXPECT_THROW(MappedSnapshot{"mapped_test.bin"}, std::runtime_error);
+}
+
+TEST(MappedSnapshotUnitTests, ChecksumTest) {
+    std::string bytes = MappedSnapshot::encode(MakeMapping());
+    std::string corrupt = bytes;
+    // Flip the number of majors of the first department, which bounds checks can't catch.
+    corrupt[sizeof(MappedSnapshotHeader) + offsetof(MappedSegmentHeader, numberOfMajors)] ^= 1;
+    MappedSnapshot::writeAtomically("mapped_test.bin", corrupt);
+    {
+        MappedSnapshot snapshot("mapped_test.bin");
+        EXPECT_THROW(snapshot.materialize(0), std::runtime_error);
+        EXPECT_EQ(snapshot.materialize(1), MakeMapping()["IEOR"]);
+    }
+
+    corrupt = bytes;
+    corrupt[offsetof(MappedSnapshotHeader, departmentCount)] ^= 1;
+    MappedSnapshot::writeAtomically("mapped_test.bin", corrupt);
+    EXPECT_THROW(MappedSnapshot{"mapped_test.bin"}, std::runtime_error);
+
+    MappedSnapshotHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    corrupt = bytes;
+    corrupt[header.directoryOffset + offsetof(MappedDirectoryEntry, segmentLength)] ^= 8;
+    MappedSnapshot::writeAtomically("mapped_test.bin", corrupt);
+    EXPECT_THROW(MappedSnapshot{"mapped_test.bin"}, std::runtime_error);
+}
@@ -1,6 +1,67 @@
 // Copyright 2024 Jason Han
 #include "MyFileDatabase.h"
+#include "EpochReclaimer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <cstdlib>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// While above zero, counts allocations down and fails the one that takes it to zero, so a test
+// can make an operation fail at each of its allocations in turn. The replacements below allocate
+// as the standard library does, so its operator delete frees their memory.
+std::atomic<int> allocationsUntilFailure{0};
+
+// Arms allocationsUntilFailure for as long as it lives.
+class FailAllocation {
+public:
+    explicit FailAllocation(int allocation) {
+        allocationsUntilFailure = allocation;
+    }
+    ~FailAllocation() {
+        allocationsUntilFailure = 0;
+    }
+
+    // Disarms the countdown, returning whether it ran out.
+    bool disarm() {
+        return allocationsUntilFailure.exchange(0) <= 0;
+    }
+};
+
+void countAllocation() {
+    if (allocationsUntilFailure.load(std::memory_order_relaxed) > 0 &&
+        allocationsUntilFailure.fetch_sub(1) == 1) {
+        throw std::bad_alloc();
+    }
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    countAllocation();
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    countAllocation();
+    auto align = static_cast<std::size_t>(alignment);
+    if (void* memory = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
 
 TEST(MyFileDatabaseUnitTests, SerializeDeserializeTest) {
     // Serialize.
@@ -24,6 +85,37 @@ TEST(MyFileDatabaseUnitTests, SerializeDeserializeTest) {
     EXPECT_EQ(deserialized_mapping, mapping);
 }
 
+TEST(MyFileDatabaseUnitTests, AllocationModeTest) {
+    std::map<std::string, Department> mapping;
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    courses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    for (SnapshotFormat format :
+         {SnapshotFormat::Legacy, SnapshotFormat::Mapped, SnapshotFormat::Compact}) {
+        std::remove("database_test.bin.wal");
+        MyFileDatabase writer{1, "database_test.bin"};
+        writer.setSnapshotFormat(format);
+        writer.setMapping(mapping);
+        writer.saveContentsToFile();
+
+        std::map<std::string, Department> loaded;
+        for (AllocationMode mode : {AllocationMode::Heap, AllocationMode::Arena}) {
+            MyFileDatabase db{1, "database_test.bin"};
+            db.setAllocationMode(mode);
+            db.deSerializeObjectFromFile();
+            EXPECT_EQ(db.setCourseInstructor("COMS", "4156", "Brian Borowski"),
+                      MutationStatus::Applied);
+            loaded = db.getDepartmentMapping();
+        }
+        // The arena outlives the database for as long as any of its courses is still referenced.
+        EXPECT_EQ(loaded.at("COMS").getCourseSelection().at("1004")->getInstructorName(),
+                  "Adam Cannon");
+        EXPECT_EQ(loaded.at("COMS").getCourseSelection().at("4156")->getInstructorName(),
+                  "Brian Borowski");
+    }
+}
+
 TEST(MyFileDatabaseUnitTests, DisplayTest) {
     MyFileDatabase db{1, "database_test.bin"};
 
@@ -40,3 +132,753 @@ TEST(MyFileDatabaseUnitTests, DisplayTest) {
     EXPECT_EQ(db.display(), "For the COMS department:\nCOMS 1004: \nInstructor: Adam Cannon; "
                             "Location: 417 IAB; Time: 11:40-12:55\n\n");
 }
+
+TEST(MyFileDatabaseUnitTests, WriteAheadLogReplayTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+
+    std::map<std::string, Department> mapping;
+    auto coms1004 = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    coms1004->setEnrolledStudentCount(249);
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = coms1004;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+    db.checkpoint();
+
+    EXPECT_EQ(db.setEnrollmentCount("COMS", "1004", 300), MutationStatus::Applied);
+    EXPECT_EQ(db.setCourseLocation("COMS", "1004", "501 NWC"), MutationStatus::Applied);
+    EXPECT_EQ(db.setCourseInstructor("COMS", "1004", "Gail Kaiser"), MutationStatus::Applied);
+    EXPECT_EQ(db.setCourseTime("COMS", "1004", "10:10-11:25"), MutationStatus::Applied);
+    EXPECT_EQ(db.dropStudentFromCourse("COMS", "1004"), MutationStatus::Applied);
+    EXPECT_EQ(db.addMajorToDept("COMS"), MutationStatus::Applied);
+    EXPECT_EQ(db.addMajorToDept("COMS"), MutationStatus::Applied);
+    EXPECT_EQ(db.removeMajorFromDept("COMS"), MutationStatus::Applied);
+    EXPECT_EQ(db.addMajorToDept("ECON"), MutationStatus::DepartmentNotFound);
+    EXPECT_EQ(db.setCourseTime("COMS", "9999", "1:10-2:25"), MutationStatus::CourseNotFound);
+
+    // Simulate a crash: the file was never rewritten, so the changes must come from the log.
+    MyFileDatabase recovered{0, "database_test.bin"};
+    auto recoveredMapping = recovered.getDepartmentMapping();
+    EXPECT_EQ(recoveredMapping, db.getDepartmentMapping());
+    const Department& coms = recoveredMapping.at("COMS");
+    EXPECT_EQ(coms.getNumberOfMajors(), 2701);
+    auto course = coms.getCourseSelection().at("1004");
+    EXPECT_EQ(course->getEnrolledStudentCount(), 299);
+    EXPECT_EQ(course->getCourseLocation(), "501 NWC");
+    EXPECT_EQ(course->getInstructorName(), "Gail Kaiser");
+    EXPECT_EQ(course->getCourseTimeSlot(), "10:10-11:25");
+}
+
+TEST(MyFileDatabaseUnitTests, CheckpointTruncatesLogTest) {
+    MyFileDatabase db{1, "database_test.bin"};
+
+    std::map<std::string, Department> mapping;
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+
+    EXPECT_EQ(db.setEnrollmentCount("COMS", "1004", 0), MutationStatus::Applied);
+    EXPECT_EQ(db.dropStudentFromCourse("COMS", "1004"), MutationStatus::Rejected);
+    db.checkpoint();
+
+    WriteAheadLog wal{"database_test.bin.wal"};
+    EXPECT_TRUE(wal.recover().empty());
+
+    MyFileDatabase reloaded{0, "database_test.bin"};
+    EXPECT_EQ(reloaded.getDepartmentMapping(), db.getDepartmentMapping());
+}
+
+TEST(MyFileDatabaseUnitTests, LazyLoadTest) {
+    MyFileDatabase db{1, "database_test.bin"};
+
+    std::map<std::string, Department> mapping;
+    std::map<std::string, std::shared_ptr<Course>> comsCourses;
+    comsCourses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    mapping["COMS"] = Department("COMS", comsCourses, "Luca Carloni", 2700);
+    std::map<std::string, std::shared_ptr<Course>> econCourses;
+    econCourses["1105"] = std::make_shared<Course>(210, "Waseem Noor", "309 HAV", "2:40-3:55");
+    mapping["ECON"] = Department("ECON", econCourses, "Michael Woodford", 2345);
+    std::map<std::string, std::shared_ptr<Course>> ieorCourses;
+    ieorCourses["2500"] = std::make_shared<Course>(50, "Uday Menon", "627 MUDD", "11:40-12:55");
+    mapping["IEOR"] = Department("IEOR", ieorCourses, "Jay Sethuraman", 67);
+    db.setMapping(mapping);
+    db.checkpoint();
+    EXPECT_EQ(db.setEnrollmentCount("IEOR", "2500", 42), MutationStatus::Applied);
+
+    // Only the department referenced by the log is loaded at startup.
+    MyFileDatabase lazy{0, "database_test.bin"};
+    EXPECT_EQ(lazy.getLoadedDepartmentCount(), 1);
+    EXPECT_FALSE(lazy.viewDepartment("MATH"));
+    EXPECT_EQ(lazy.getLoadedDepartmentCount(), 1);
+
+    std::vector<const Department*> found(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < found.size(); ++i) {
+        threads.emplace_back([&lazy, &found, i]() { found[i] = &*lazy.viewDepartment("COMS"); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_NE(found[0], nullptr);
+    for (const Department* dept : found) {
+        EXPECT_EQ(dept, found[0]);
+    }
+    EXPECT_EQ(found[0]->getDepartmentChair(), "Luca Carloni");
+    EXPECT_EQ(lazy.getLoadedDepartmentCount(), 2);
+
+    EXPECT_EQ(lazy.getDepartmentMapping(), db.getDepartmentMapping());
+    EXPECT_EQ(lazy.getLoadedDepartmentCount(), 3);
+    EXPECT_EQ(&*lazy.viewDepartment("COMS"), found[0]);
+}
+
+TEST(MyFileDatabaseUnitTests, CourseScanTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+
+    std::map<std::string, Department> mapping;
+    std::map<std::string, std::shared_ptr<Course>> comsCourses;
+    comsCourses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    comsCourses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    comsCourses["4156"]->setEnrolledStudentCount(120);
+    mapping["COMS"] = Department("COMS", comsCourses, "Luca Carloni", 2700);
+    std::map<std::string, std::shared_ptr<Course>> ieorCourses;
+    ieorCourses["2500"] = std::make_shared<Course>(50, "Uday Menon", "417 IAB", "11:40-12:55");
+    mapping["IEOR"] = Department("IEOR", ieorCourses, "Jay Sethuraman", 67);
+    db.setMapping(mapping);
+    db.checkpoint();
+
+    // A mapped snapshot is loaded lazily; the first scan loads every department.
+    MyFileDatabase lazy{0, "database_test.bin"};
+    EXPECT_EQ(lazy.getLoadedDepartmentCount(), 0);
+    EXPECT_EQ(lazy.findFullCourses(), (std::vector<CourseKey>{{"COMS", "4156"}}));
+    EXPECT_EQ(lazy.getLoadedDepartmentCount(), 2);
+    EXPECT_EQ(lazy.findCoursesByLocation("417 IAB"),
+              (std::vector<CourseKey>{{"COMS", "1004"}, {"IEOR", "2500"}}));
+    EXPECT_TRUE(lazy.findCoursesByLocation("No such room").empty());
+
+    // Writers keep the columns up to date.
+    EXPECT_EQ(lazy.setEnrollmentCount("IEOR", "2500", 50), MutationStatus::Applied);
+    EXPECT_EQ(lazy.dropStudentFromCourse("COMS", "4156"), MutationStatus::Applied);
+    EXPECT_EQ(lazy.setCourseLocation("COMS", "1004", "501 NWC"), MutationStatus::Applied);
+    EXPECT_EQ(lazy.findFullCourses(), (std::vector<CourseKey>{{"IEOR", "2500"}}));
+    EXPECT_EQ(lazy.findCoursesByLocation("501 NWC"),
+              (std::vector<CourseKey>{{"COMS", "1004"}, {"COMS", "4156"}}));
+
+    // So do the secondary indexes.
+    EXPECT_EQ(lazy.findCoursesByInstructor("Gail Kaiser"),
+              (std::vector<CourseKey>{{"COMS", "4156"}}));
+    EXPECT_EQ(lazy.setCourseInstructor("COMS", "4156", "Adam Cannon"), MutationStatus::Applied);
+    EXPECT_TRUE(lazy.findCoursesByInstructor("Gail Kaiser").empty());
+    EXPECT_EQ(lazy.findCoursesByInstructor("Adam Cannon"),
+              (std::vector<CourseKey>{{"COMS", "1004"}, {"COMS", "4156"}}));
+    EXPECT_EQ(lazy.setCourseTime("IEOR", "2500", "10:10-11:25"), MutationStatus::Applied);
+    EXPECT_EQ(lazy.findCoursesByTimeSlot("10:10-11:25"),
+              (std::vector<CourseKey>{{"COMS", "4156"}, {"IEOR", "2500"}}));
+    EXPECT_EQ(lazy.findCoursesByTimeSlot("11:40-12:55"),
+              (std::vector<CourseKey>{{"COMS", "1004"}}));
+
+    // Replacing the catalog replaces its columns.
+    lazy.setMapping(mapping);
+    EXPECT_EQ(lazy.findFullCourses(), (std::vector<CourseKey>{{"COMS", "4156"}}));
+}
+
+TEST(MyFileDatabaseUnitTests, TimeQueryTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+
+    std::map<std::string, Department> mapping;
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    courses["3157"] = std::make_shared<Course>(150, "Jae Lee", "417 IAB", "4:10-5:25");
+    courses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    courses["9999"] = std::make_shared<Course>(10, "Nobody", "Nowhere", "TBA");
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+
+    EXPECT_EQ(db.findCoursesMeetingDuring(*TimeRange::parse("11:00-12:00")),
+              (std::vector<CourseKey>{{"COMS", "1004"}, {"COMS", "4156"}}));
+    EXPECT_EQ(db.findCoursesMeetingDuring(*TimeRange::parse("11:25-11:40")),
+              std::vector<CourseKey>{});
+    EXPECT_EQ(db.findCoursesMeetingDuring(*TimeRange::parse("5:00-6:00")),
+              (std::vector<CourseKey>{{"COMS", "3157"}}));
+
+    // Changing a course's time is reflected in the next query.
+    EXPECT_EQ(db.setCourseTime("COMS", "4156", "5:00-6:15"), MutationStatus::Applied);
+    EXPECT_EQ(db.findCoursesMeetingDuring(*TimeRange::parse("11:00-12:00")),
+              (std::vector<CourseKey>{{"COMS", "1004"}}));
+    EXPECT_EQ(db.findCoursesMeetingDuring(*TimeRange::parse("5:00-6:00")),
+              (std::vector<CourseKey>{{"COMS", "3157"}, {"COMS", "4156"}}));
+}
+
+TEST(MyFileDatabaseUnitTests, SearchTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+
+    std::map<std::string, Department> mapping;
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    courses["3157"] = std::make_shared<Course>(150, "Jae Lee", "417 IAB", "4:10-5:25");
+    courses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+
+    std::vector<SearchResult> results = db.search("Kais", 10);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].course, (CourseKey{"COMS", "4156"}));
+    EXPECT_EQ(results[0].field, SearchField::Instructor);
+    EXPECT_EQ(results[0].text, "Gail Kaiser");
+
+    // A location match lists every course held there, and each course appears once.
+    results = db.search("417", 10);
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_EQ(results[0].course, (CourseKey{"COMS", "1004"}));
+    EXPECT_EQ(results[1].course, (CourseKey{"COMS", "3157"}));
+    EXPECT_EQ(db.search("417", 1).size(), 1);
+    EXPECT_EQ(db.search("coms 3157", 10)[0].course, (CourseKey{"COMS", "3157"}));
+
+    // New instructors are searchable as soon as they're assigned; old ones stop matching.
+    EXPECT_EQ(db.setCourseInstructor("COMS", "4156", "Brian Borowski"), MutationStatus::Applied);
+    results = db.search("borow", 10);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].course, (CourseKey{"COMS", "4156"}));
+    EXPECT_TRUE(db.search("Kaiser", 10).empty());
+}
+
+TEST(MyFileDatabaseUnitTests, BackgroundCheckpointTest) {
+    MyFileDatabase db{1, "database_test.bin"};
+
+    std::map<std::string, Department> mapping;
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+    db.checkpoint();
+    EXPECT_EQ(db.getCheckpointStats().checkpoints, 1);
+
+    db.startCheckpointer(std::chrono::milliseconds(0), 3);
+    EXPECT_EQ(db.setEnrollmentCount("COMS", "1004", 10), MutationStatus::Applied);
+    EXPECT_EQ(db.setEnrollmentCount("COMS", "1004", 11, Durability::None),
+              MutationStatus::Applied);
+    EXPECT_EQ(db.setEnrollmentCount("COMS", "1004", 12), MutationStatus::Applied);
+    for (int i = 0; i < 500 && db.getCheckpointStats().checkpoints < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    db.stopCheckpointer();
+
+    CheckpointStats stats = db.getCheckpointStats();
+    EXPECT_EQ(stats.checkpoints, 2);
+    EXPECT_EQ(stats.failures, 0);
+    EXPECT_GT(stats.lastBytes, 0);
+    EXPECT_EQ(stats.totalBytes, 2 * stats.lastBytes);
+
+    // The checkpoint covered every record, including the one that was never logged.
+    EXPECT_FALSE(std::filesystem::exists("database_test.bin.wal.old"));
+    {
+        MyFileDatabase reloaded{0, "database_test.bin"};
+        EXPECT_EQ(reloaded.getDepartmentMapping(), db.getDepartmentMapping());
+    }
+    std::remove("database_test.bin.wal");
+}
+
+TEST(MyFileDatabaseUnitTests, IncrementalCheckpointTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+
+    std::map<std::string, Department> mapping;
+    std::map<std::string, std::shared_ptr<Course>> comsCourses;
+    comsCourses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    mapping["COMS"] = Department("COMS", comsCourses, "Luca Carloni", 2700);
+    std::map<std::string, std::shared_ptr<Course>> econCourses;
+    econCourses["1105"] = std::make_shared<Course>(210, "Waseem Noor", "309 HAV", "2:40-3:55");
+    mapping["ECON"] = Department("ECON", econCourses, "Michael Woodford", 2345);
+    std::map<std::string, std::shared_ptr<Course>> ieorCourses;
+    ieorCourses["2500"] = std::make_shared<Course>(50, "Uday Menon", "627 MUDD", "11:40-12:55");
+    mapping["IEOR"] = Department("IEOR", ieorCourses, "Jay Sethuraman", 67);
+    db.setMapping(mapping);
+    db.checkpoint();
+    CheckpointStats full = db.getCheckpointStats();
+    EXPECT_EQ(full.lastSegmentsWritten, 3);
+
+    EXPECT_EQ(db.setCourseLocation("COMS", "1004", "501 NWC"), MutationStatus::Applied);
+    db.checkpoint();
+    CheckpointStats incremental = db.getCheckpointStats();
+    EXPECT_EQ(incremental.lastSegmentsWritten, 1);
+    EXPECT_EQ(incremental.lastSegmentsReused, 2);
+    EXPECT_LT(incremental.lastBytes, full.lastBytes);
+
+    {
+        // A lazily loaded database only loads and rewrites the department that changed.
+        MyFileDatabase lazy{0, "database_test.bin"};
+        EXPECT_EQ(lazy.addMajorToDept("IEOR"), MutationStatus::Applied);
+        lazy.checkpoint();
+        EXPECT_EQ(lazy.getCheckpointStats().lastSegmentsWritten, 1);
+        EXPECT_EQ(lazy.getCheckpointStats().lastSegmentsReused, 2);
+        EXPECT_EQ(lazy.getLoadedDepartmentCount(), 1);
+
+        lazy.setCompactionGarbageRatio(0.0);
+        EXPECT_EQ(lazy.addMajorToDept("IEOR"), MutationStatus::Applied);
+        lazy.checkpoint();
+        EXPECT_EQ(lazy.getCheckpointStats().compactions, 1);
+        EXPECT_EQ(lazy.getCheckpointStats().lastBytes,
+                  std::filesystem::file_size("database_test.bin"));
+    }
+
+    EXPECT_EQ(db.addMajorToDept("IEOR"), MutationStatus::Applied);
+    EXPECT_EQ(db.addMajorToDept("IEOR"), MutationStatus::Applied);
+    MyFileDatabase reloaded{0, "database_test.bin"};
+    EXPECT_EQ(reloaded.getDepartmentMapping(), db.getDepartmentMapping());
+    std::remove("database_test.bin.wal");
+}
+
+TEST(MyFileDatabaseUnitTests, CorruptLegacySnapshotTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+    db.setSnapshotFormat(SnapshotFormat::Legacy);
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+    db.saveContentsToFile();
+
+    std::ifstream inFile("database_test.bin", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    inFile.close();
+    auto writeFile = [](const std::string& contents) {
+        std::ofstream outFile("database_test.bin", std::ios::binary | std::ios::trunc);
+        outFile.write(contents.data(), contents.length());
+    };
+
+    // Every truncation is detected, however the lengths before it line up.
+    for (size_t length = 0; length < bytes.length(); ++length) {
+        writeFile(bytes.substr(0, length));
+        EXPECT_THROW((MyFileDatabase{0, "database_test.bin"}), std::runtime_error);
+    }
+    // A corrupt length fails before anything is allocated.
+    std::string corrupt = bytes;
+    std::memset(&corrupt[sizeof(uint64_t)], 0xff, sizeof(uint64_t));
+    writeFile(corrupt);
+    EXPECT_THROW((MyFileDatabase{0, "database_test.bin"}), std::runtime_error);
+    writeFile(bytes + "x");
+    EXPECT_THROW((MyFileDatabase{0, "database_test.bin"}), std::runtime_error);
+
+    writeFile(bytes);
+    MyFileDatabase reloaded{0, "database_test.bin"};
+    EXPECT_EQ(reloaded.getDepartmentMapping(), mapping);
+
+    std::remove("database_test.bin");
+    EXPECT_THROW((MyFileDatabase{0, "database_test.bin"}), std::runtime_error);
+}
+
+TEST(MyFileDatabaseUnitTests, ViewTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+
+    EXPECT_FALSE(db.viewCourse("COMS", "9999"));
+    EXPECT_FALSE(db.viewCourse("MATH", "1004"));
+    {
+        CourseView before = db.viewCourse("COMS", "1004");
+        ASSERT_TRUE(before);
+
+        // A mutation doesn't wait for views; it publishes a new version, and views taken before
+        // it keep seeing the old one.
+        EXPECT_EQ(db.setCourseInstructor("COMS", "1004", "Jae Lee", Durability::None),
+                  MutationStatus::Applied);
+        EXPECT_EQ(before->getInstructorName(), "Adam Cannon");
+        EXPECT_EQ(db.viewCourse("COMS", "1004")->getInstructorName(), "Jae Lee");
+        EXPECT_GT(EpochReclaimer::getPendingCount(), 0);
+    }
+    EpochReclaimer::reclaim();
+    EXPECT_EQ(EpochReclaimer::getPendingCount(), 0);
+    EXPECT_EQ(db.viewDepartment("COMS")->findCourse("1004")->getInstructorName(), "Jae Lee");
+}
+
+TEST(MyFileDatabaseUnitTests, ConcurrentReadTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    courses["3134"] = std::make_shared<Course>(250, "Brian Borowski", "301 URIS", "4:10-5:25");
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+
+    // Readers see every course's count only ever grow while writers update both courses and
+    // swap in a fresh copy of the catalog.
+    constexpr int kWrites = 2000;
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&db, &done, &consistent]() {
+            int last1004 = 0;
+            int last3134 = 0;
+            while (!done) {
+                DepartmentView dept = db.viewDepartment("COMS");
+                if (!dept) {
+                    consistent = false;
+                    break;
+                }
+                // Seat counts change in place, so read them in the reverse order of the writes.
+                int count3134 = dept->findCourse("3134")->getEnrolledStudentCount();
+                int count1004 = dept->findCourse("1004")->getEnrolledStudentCount();
+                if (count1004 < last1004 || count3134 < last3134 || count3134 > count1004) {
+                    consistent = false;
+                }
+                last1004 = count1004;
+                last3134 = count3134;
+            }
+        });
+    }
+    for (int i = 1; i <= kWrites; ++i) {
+        db.setEnrollmentCount("COMS", "1004", i, Durability::None);
+        db.setEnrollmentCount("COMS", "3134", i, Durability::None);
+        if (i % 500 == 0) {
+            db.setMapping(db.getDepartmentMapping());
+        }
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(db.viewCourse("COMS", "3134")->getEnrolledStudentCount(), kWrites);
+}
+
+TEST(MyFileDatabaseUnitTests, ConcurrentWriteTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+    constexpr int kDepartments = 16;
+    constexpr int kCourses = 4;
+    constexpr int kThreads = 32;
+    constexpr int kRounds = 400;
+    std::map<std::string, Department> mapping;
+    for (int d = 0; d < kDepartments; ++d) {
+        std::string deptCode = "D" + std::to_string(d);
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        for (int c = 0; c < kCourses; ++c) {
+            courses[std::to_string(1000 + c)] =
+                std::make_shared<Course>(100000, "Adam Cannon", "417 IAB", "11:40-12:55");
+            courses[std::to_string(1000 + c)]->setEnrolledStudentCount(100000);
+        }
+        mapping[deptCode] = Department(deptCode, courses, "Chair", 0);
+    }
+    db.setMapping(mapping);
+    // Build the course columns and their location index, so writers update them too.
+    EXPECT_EQ(db.findCoursesByLocation("417 IAB").size(), kDepartments * kCourses);
+
+    // Every thread adds majors and drops students across all departments, so threads keep
+    // meeting on the same departments and courses, while a few move courses between rooms and a
+    // checkpoint locks out every writer. No update may be lost.
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&db, t]() {
+            for (int i = 0; i < kRounds; ++i) {
+                std::string deptCode = "D" + std::to_string((t + i) % kDepartments);
+                std::string courseCode = std::to_string(1000 + i % kCourses);
+                db.addMajorToDept(deptCode, Durability::None);
+                db.dropStudentFromCourse(deptCode, courseCode, Durability::None);
+                if (t % 8 == 0) {
+                    db.setCourseLocation(
+                        deptCode, courseCode, i % 2 ? "501 NWC" : "417 IAB", Durability::None);
+                }
+            }
+        });
+    }
+    db.checkpoint();
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+
+    // Each department and course got the same share of the updates.
+    for (int d = 0; d < kDepartments; ++d) {
+        DepartmentView dept = db.viewDepartment("D" + std::to_string(d));
+        EXPECT_EQ(dept->getNumberOfMajors(), kThreads * kRounds / kDepartments);
+        for (const auto& [courseCode, course] : dept->getCourseSelection()) {
+            EXPECT_EQ(course->getEnrolledStudentCount(),
+                      100000 - kThreads * kRounds / kDepartments / kCourses);
+        }
+    }
+    EXPECT_EQ(db.findCoursesByLocation("417 IAB").size() +
+                  db.findCoursesByLocation("501 NWC").size(),
+              kDepartments * kCourses);
+}
+
+TEST(MyFileDatabaseUnitTests, WriterThreadsTest) {
+    std::remove("database_test.bin.wal");
+    {
+        MyFileDatabase db{1, "database_test.bin"};
+        // COMS gets an owner thread of its own.
+        db.setWriterThreads(3, {{"COMS", 0}, {"IEOR", 1}, {"MATH", 2}});
+        std::map<std::string, Department> mapping;
+        for (const char* deptCode : {"COMS", "IEOR", "MATH"}) {
+            std::map<std::string, std::shared_ptr<Course>> courses;
+            courses["1004"] =
+                std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+            mapping[deptCode] = Department(deptCode, courses, "Chair", 0);
+        }
+        db.setMapping(mapping);
+        db.checkpoint();
+
+        // Each thread moves its department's course through rooms in a known order; the owner
+        // threads apply and log each department's changes in the order they were made.
+        std::vector<std::thread> writers;
+        for (const char* deptCode : {"COMS", "IEOR", "MATH"}) {
+            writers.emplace_back([&db, deptCode]() {
+                for (int i = 0; i < 50; ++i) {
+                    db.addMajorToDept(deptCode, Durability::Async);
+                    db.setCourseLocation(
+                        deptCode, "1004", std::to_string(i) + " IAB", Durability::Async);
+                }
+                db.removeMajorFromDept(deptCode);
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        EXPECT_EQ(db.setCourseTime("EAEE", "1004", "TBA"), MutationStatus::DepartmentNotFound);
+        EXPECT_EQ(db.setCourseTime("COMS", "9999", "TBA"), MutationStatus::CourseNotFound);
+    }
+
+    MyFileDatabase recovered{0, "database_test.bin"};
+    for (const char* deptCode : {"COMS", "IEOR", "MATH"}) {
+        EXPECT_EQ(recovered.viewDepartment(deptCode)->getNumberOfMajors(), 49);
+        EXPECT_EQ(recovered.viewCourse(deptCode, "1004")->getCourseLocation(), "49 IAB");
+    }
+}
+
+TEST(MyFileDatabaseUnitTests, HotCourseTest) {
+    std::remove("database_test.bin.wal");
+    constexpr int kCapacity = 500;
+    {
+        MyFileDatabase db{1, "database_test.bin"};
+        std::map<std::string, std::shared_ptr<Course>> courses;
+        courses["4156"] =
+            std::make_shared<Course>(kCapacity, "Gail Kaiser", "501 NWC", "10:10-11:25");
+        courses["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+        std::map<std::string, Department> mapping;
+        mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+        db.setMapping(mapping);
+        db.checkpoint();
+        EXPECT_TRUE(db.findFullCourses().empty());
+        EXPECT_EQ(db.enrollStudentInCourse("COMS", "9999"), MutationStatus::CourseNotFound);
+        EXPECT_EQ(db.enrollStudentInCourse("MATH", "4156"), MutationStatus::DepartmentNotFound);
+
+        // Threads race for more seats than there are while another keeps replacing the course
+        // with a new version, moving it between rooms. Every seat is taken exactly once.
+        std::atomic<int> enrolled{0};
+        std::atomic<bool> done{false};
+        std::thread mover([&]() {
+            for (int i = 0; !done; ++i) {
+                db.setCourseLocation("COMS", "4156", i % 2 ? "417 IAB" : "501 NWC");
+            }
+        });
+        std::vector<std::thread> students;
+        for (int t = 0; t < 16; ++t) {
+            students.emplace_back([&]() {
+                for (int i = 0; i < kCapacity / 5; ++i) {
+                    MutationStatus status =
+                        db.enrollStudentInCourse("COMS", "4156", Durability::Async);
+                    enrolled += status == MutationStatus::Applied ? 1 : 0;
+                }
+            });
+        }
+        for (std::thread& student : students) {
+            student.join();
+        }
+        done = true;
+        mover.join();
+        EXPECT_EQ(enrolled, kCapacity);
+        EXPECT_EQ(db.viewCourse("COMS", "4156")->getEnrolledStudentCount(), kCapacity);
+        EXPECT_EQ(db.findFullCourses(), (std::vector<CourseKey>{{"COMS", "4156"}}));
+        EXPECT_EQ(db.dropStudentFromCourse("COMS", "4156"), MutationStatus::Applied);
+        EXPECT_TRUE(db.findFullCourses().empty());
+    }
+
+    // The last record logged for the course holds its final count.
+    MyFileDatabase recovered{0, "database_test.bin"};
+    EXPECT_EQ(recovered.viewCourse("COMS", "4156")->getEnrolledStudentCount(), kCapacity - 1);
+}
+
+TEST(MyFileDatabaseUnitTests, VersionTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["4156"] = std::make_shared<Course>(1000, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+
+    // A change expecting a state the course or department has moved on from conflicts.
+    uint64_t generation = db.viewCourse("COMS", "4156").getGeneration();
+    uint64_t version = db.viewCourse("COMS", "4156")->getVersion();
+    ExpectedState expected{generation, version, 0};
+    EXPECT_EQ(db.setCourseLocation("COMS", "4156", "417 IAB", Durability::None, expected),
+              MutationStatus::Applied);
+    EXPECT_EQ(db.setCourseInstructor("COMS", "4156", "Adam Cannon", Durability::None, expected),
+              MutationStatus::Conflict);
+    EXPECT_EQ(db.viewCourse("COMS", "4156")->getInstructorName(), "Gail Kaiser");
+    EXPECT_EQ(db.setEnrollmentCount("COMS", "4156", 5, Durability::None, expected),
+              MutationStatus::Conflict);
+    expected.version = version + 1;
+    EXPECT_EQ(db.setEnrollmentCount("COMS", "4156", 5, Durability::None, expected),
+              MutationStatus::Applied);
+
+    // Seat changes leave the version alone, but move the count the next change expects on.
+    EXPECT_EQ(db.viewCourse("COMS", "4156")->getVersion(), version + 1);
+    EXPECT_EQ(db.setCourseTime("COMS", "4156", "11:40-12:55", Durability::None, expected),
+              MutationStatus::Conflict);
+    EXPECT_EQ(db.setEnrollmentCount(
+                  "COMS", "4156", 6, Durability::None, ExpectedState{generation, version + 1, 5}),
+              MutationStatus::Applied);
+    // A department's state, which has no count, matches no course.
+    expected.count = std::nullopt;
+    EXPECT_EQ(db.setEnrollmentCount("COMS", "4156", 6, Durability::None, expected),
+              MutationStatus::Conflict);
+
+    version = db.viewDepartment("COMS")->getVersion();
+    ExpectedState stale{generation, version + 1, std::nullopt};
+    ExpectedState current{generation, version, std::nullopt};
+    EXPECT_EQ(db.addMajorToDept("COMS", Durability::None, stale), MutationStatus::Conflict);
+    EXPECT_EQ(db.addMajorToDept("COMS", Durability::None, current), MutationStatus::Applied);
+    EXPECT_EQ(db.removeMajorFromDept("COMS", Durability::None, current),
+              MutationStatus::Conflict);
+    // A course's state matches no department.
+    ExpectedState courseState{generation, version + 1, 6};
+    EXPECT_EQ(db.removeMajorFromDept("COMS", Durability::None, courseState),
+              MutationStatus::Conflict);
+    EXPECT_EQ(db.viewDepartment("COMS")->getNumberOfMajors(), 2701);
+    EXPECT_EQ(db.viewDepartment("COMS")->getVersion(), version + 1);
+
+    // Threads read the count and write it back one higher, retrying on a conflict, while others
+    // enroll students: no increment is lost.
+    constexpr int kThreads = 8;
+    constexpr int kRounds = 50;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&db, t]() {
+            for (int i = 0; i < kRounds; ++i) {
+                if (t % 2) {
+                    db.enrollStudentInCourse("COMS", "4156", Durability::None);
+                    continue;
+                }
+                MutationStatus status;
+                do {
+                    CourseView course = db.viewCourse("COMS", "4156");
+                    CourseState state = course->getState();
+                    ExpectedState expected{course.getGeneration(), state.version, state.count};
+                    status = db.setEnrollmentCount(
+                        "COMS", "4156", state.count + 1, Durability::None, expected);
+                } while (status == MutationStatus::Conflict);
+                EXPECT_EQ(status, MutationStatus::Applied);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(db.viewCourse("COMS", "4156")->getEnrolledStudentCount(), 6 + kThreads * kRounds);
+}
+
+TEST(MyFileDatabaseUnitTests, StaleStateAfterReloadTest) {
+    // Versions restart when a snapshot is loaded, so a state read before a restart or a reload
+    // must not match the same versions after it.
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    for (SnapshotFormat format :
+         {SnapshotFormat::Legacy, SnapshotFormat::Mapped, SnapshotFormat::Compact}) {
+        std::remove("database_test.bin.wal");
+        ExpectedState course;
+        ExpectedState dept;
+        {
+            MyFileDatabase db{1, "database_test.bin"};
+            db.setSnapshotFormat(format);
+            db.setMapping(mapping);
+            CourseView courseView = db.viewCourse("COMS", "4156");
+            course = {courseView.getGeneration(),
+                      courseView->getVersion(),
+                      courseView->getEnrolledStudentCount()};
+            DepartmentView deptView = db.viewDepartment("COMS");
+            dept = {deptView.getGeneration(), deptView->getVersion(), std::nullopt};
+            db.saveContentsToFile();
+        }
+
+        MyFileDatabase db{0, "database_test.bin"};
+        EXPECT_EQ(db.viewCourse("COMS", "4156")->getVersion(), course.version);
+        EXPECT_EQ(db.viewDepartment("COMS")->getVersion(), dept.version);
+        EXPECT_EQ(db.setCourseLocation("COMS", "4156", "417 IAB", Durability::None, course),
+                  MutationStatus::Conflict);
+        EXPECT_EQ(db.setEnrollmentCount("COMS", "4156", 5, Durability::None, course),
+                  MutationStatus::Conflict);
+        EXPECT_EQ(db.addMajorToDept("COMS", Durability::None, dept), MutationStatus::Conflict);
+        EXPECT_EQ(db.viewCourse("COMS", "4156")->getCourseLocation(), "501 NWC");
+        EXPECT_EQ(db.viewDepartment("COMS")->getNumberOfMajors(), 2700);
+
+        // A state read after the restart matches until the snapshot is loaded again.
+        course.generation = db.viewCourse("COMS", "4156").getGeneration();
+        EXPECT_EQ(db.setEnrollmentCount("COMS", "4156", 0, Durability::None, course),
+                  MutationStatus::Applied);
+        db.deSerializeObjectFromFile();
+        EXPECT_EQ(db.setEnrollmentCount("COMS", "4156", 0, Durability::None, course),
+                  MutationStatus::Conflict);
+    }
+}
+
+TEST(MyFileDatabaseUnitTests, FailedCourseChangeTest) {
+    std::remove("database_test.bin.wal");
+    MyFileDatabase db{1, "database_test.bin"};
+    std::map<std::string, std::shared_ptr<Course>> courses;
+    courses["4156"] = std::make_shared<Course>(1000, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", courses, "Luca Carloni", 2700);
+    db.setMapping(mapping);
+    // Build the indexes, so a change has them to keep up to date too.
+    db.findCoursesByLocation("501 NWC");
+    db.findCoursesMeetingDuring(*TimeRange::parse("10:00-11:00"));
+    db.search("kaiser", 10);
+
+    // Fail each allocation of a course change in turn, until one runs without failing. Whatever
+    // fails, the course must be left live: seat changes go on and its version is consistent.
+    const char* locations[] = {"417 IAB", "501 NWC"};
+    const char* times[] = {"11:40-12:55", "10:10-11:25"};
+    bool changed = false;
+    for (int allocation = 1; !changed; ++allocation) {
+        uint64_t generation = db.viewCourse("COMS", "4156").getGeneration();
+        uint64_t version = db.viewCourse("COMS", "4156")->getVersion();
+        {
+            FailAllocation failure(allocation);
+            try {
+                db.setCourseLocation("COMS", "4156", locations[allocation % 2], Durability::None);
+                db.setCourseTime("COMS",
+                                 "4156",
+                                 times[allocation % 2],
+                                 Durability::None,
+                                 ExpectedState{generation, version + 1, 0});
+            } catch (const std::bad_alloc&) {
+                // Depending on the allocation, the change was made or not.
+            }
+            changed = !failure.disarm();
+        }
+
+        ASSERT_EQ(db.enrollStudentInCourse("COMS", "4156", Durability::None),
+                  MutationStatus::Applied);
+        ASSERT_EQ(db.dropStudentFromCourse("COMS", "4156", Durability::None),
+                  MutationStatus::Applied);
+        CourseView course = db.viewCourse("COMS", "4156");
+        EXPECT_FALSE(course->isRetired());
+        EXPECT_EQ(course->getEnrolledStudentCount(), 0);
+        ExpectedState expected{generation, course->getVersion(), 0};
+        EXPECT_EQ(db.setEnrollmentCount("COMS", "4156", 0, Durability::None, expected),
+                  MutationStatus::Applied);
+        ASSERT_LT(allocation, 1000);
+    }
+}
@@ -0,0 +1,65 @@
+// Copyright 2024 Jason Han
+#include "PackedIndex.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(PackedIndexUnitTests, PackCodeTest) {
+    EXPECT_EQ(packCode("COMS"), 0x434f4d5300000000);
+    EXPECT_EQ(packCode("12345678"), 0x3132333435363738);
+    EXPECT_EQ(packCode(""), std::nullopt);
+    EXPECT_EQ(packCode("123456789"), std::nullopt);
+    EXPECT_EQ(packCode(std::string("CO\0S", 4)), std::nullopt);
+    EXPECT_EQ(packCode("COMSE", 4), std::nullopt);
+
+    // Packed codes compare like the strings.
+    std::vector<std::string> codes = {"1004", "1004X", "101", "4156", "A", "COMS", "COMSW"};
+    for (size_t i = 1; i < codes.size(); ++i) {
+        EXPECT_LT(*packCode(codes[i - 1]), *packCode(codes[i])) << codes[i];
+    }
+
+    EXPECT_EQ(packCourseKey("COMS", "4156"), 0x434f4d5334313536);
+    EXPECT_EQ(packCourseKey("ECON", "1105"), packCourseKey("ECON", "1105"));
+    EXPECT_NE(packCourseKey("ECON", "1105"), packCourseKey("ECO", "N1105"));
+    EXPECT_EQ(packCourseKey("D100000", "1004"), std::nullopt);
+    EXPECT_EQ(packCourseKey("COMS", "10045"), std::nullopt);
+}
+
+TEST(PackedIndexUnitTests, PackedIndexTest) {
+    PackedIndex<size_t> index;
+    EXPECT_EQ(index.find(1), nullptr);
+    for (size_t i = 0; i < 10000; ++i) {
+        index.insert(*packCode("D" + std::to_string(i)), i);
+    }
+    EXPECT_EQ(index.size(), 10000);
+    for (size_t i = 0; i < 10000; ++i) {
+        ASSERT_NE(index.find(*packCode("D" + std::to_string(i))), nullptr);
+        EXPECT_EQ(*index.find(*packCode("D" + std::to_string(i))), i);
+    }
+    EXPECT_EQ(index.find(*packCode("D10000")), nullptr);
+
+    index.insert(*packCode("D42"), 7);
+    EXPECT_EQ(index.size(), 10000);
+    EXPECT_EQ(*index.find(*packCode("D42")), 7);
+}
+
+TEST(PackedIndexUnitTests, CodeIndexTest) {
+    // Codes that don't pack live in the fallback index.
+    std::vector<std::string> codes = {"COMS", "4156", "", "COMPUTER SCIENCE", "D100000"};
+    CodeIndex<size_t> index;
+    for (size_t i = 0; i < codes.size(); ++i) {
+        index.insert(codes[i], i);
+    }
+    EXPECT_EQ(index.size(), codes.size());
+    for (size_t i = 0; i < codes.size(); ++i) {
+        std::string lookup = codes[i];
+        ASSERT_NE(index.find(lookup), nullptr);
+        EXPECT_EQ(*index.find(lookup), i);
+    }
+    EXPECT_EQ(index.find("MATH"), nullptr);
+    EXPECT_EQ(index.find("COMPUTER"), nullptr);
+
+    index.clear();
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_EQ(index.find("COMS"), nullptr);
+}
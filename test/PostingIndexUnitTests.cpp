@@ -0,0 +1,86 @@
+// Copyright 2024 Jason Han
+#include "PostingIndex.h"
+#include "EpochReclaimer.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+TEST(PostingIndexUnitTests, BuildFindTest) {
+    std::atomic<uint32_t> column[] = {{7}, {3}, {7}, {0}, {5000}, {7}};
+    PostingIndex index;
+    index.build(column, 6);
+
+    EXPECT_EQ(index.find(7), (std::vector<uint32_t>{0, 2, 5}));
+    EXPECT_EQ(index.find(3), (std::vector<uint32_t>{1}));
+    EXPECT_EQ(index.find(0), (std::vector<uint32_t>{3}));
+    EXPECT_EQ(index.find(5000), (std::vector<uint32_t>{4}));
+    EXPECT_TRUE(index.find(4).empty());
+    EXPECT_TRUE(index.find(100000).empty());
+    EXPECT_TRUE(index.find(UINT32_MAX).empty());
+}
+
+TEST(PostingIndexUnitTests, MoveTest) {
+    std::atomic<uint32_t> column[] = {{7}, {3}, {7}};
+    PostingIndex index;
+    index.build(column, 3);
+
+    index.move(0, 7, 3);
+    EXPECT_EQ(index.find(7), (std::vector<uint32_t>{2}));
+    EXPECT_EQ(index.find(3), (std::vector<uint32_t>{0, 1}));
+
+    index.move(2, 7, 9000);
+    EXPECT_TRUE(index.find(7).empty());
+    EXPECT_EQ(index.find(9000), (std::vector<uint32_t>{2}));
+
+    // Moving to the same value changes nothing.
+    index.move(1, 3, 3);
+    EXPECT_EQ(index.find(3), (std::vector<uint32_t>{0, 1}));
+}
+
+TEST(PostingIndexUnitTests, ConcurrentFindTest) {
+    constexpr uint32_t kCourses = 64;
+    std::vector<std::atomic<uint32_t>> column(kCourses);
+    for (uint32_t i = 0; i < kCourses; ++i) {
+        column[i] = i % 2;
+    }
+    PostingIndex index;
+    index.build(column.data(), kCourses);
+
+    // One writer moves courses between two values while readers check that every list they see
+    // is sorted, without duplicates.
+    std::atomic<bool> done{false};
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                EpochGuard guard;
+                std::vector<uint32_t> even = index.find(0);
+                std::vector<uint32_t> odd = index.find(1);
+                for (const std::vector<uint32_t>* list : {&even, &odd}) {
+                    if (std::adjacent_find(list->begin(), list->end(), std::greater_equal<>()) !=
+                        list->end()) {
+                        failed = true;
+                    }
+                }
+            }
+        });
+    }
+    for (int round = 0; round < 2000; ++round) {
+        uint32_t course = static_cast<uint32_t>(round % kCourses);
+        uint32_t from = column[course];
+        column[course] = 1 - from;
+        index.move(course, from, 1 - from);
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EpochReclaimer::reclaim();
+    EXPECT_FALSE(failed);
+    EXPECT_EQ(index.find(0).size() + index.find(1).size(), kCourses);
+}
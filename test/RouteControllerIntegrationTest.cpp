@@ -175,9 +175,20 @@ TEST(RouteControllerUnitTests, SetCourseTimeTest) {
     EXPECT_EQ(body, expected);
 }
 
+TEST(RouteControllerUnitTests, EnrollStudentInCourseTest) {
+    const auto endpoint = "/enrollStudentInCourse?deptCode=COMS&courseCode=1004";
+    auto body = Patch(endpoint);
+    auto expected = "Student has been enrolled";
+    EXPECT_EQ(body, expected);
+}
+
 TEST(RouteControllerUnitTests, DropStudentFromCourseTest) {
     const auto endpoint = "/dropStudentFromCourse?deptCode=CHEM&courseCode=1500";
-    auto body = Fetch(endpoint);
+    auto body = Patch(endpoint);
     auto expected = "Student has been dropped";
     EXPECT_EQ(body, expected);
+
+    // GET is still accepted.
+    body = Fetch(endpoint);
+    EXPECT_EQ(body, expected);
 }
@@ -45,6 +45,7 @@ Instructor: Gail Kaiser; Location: 501 NWC; Time: 10:10-11:25
     routeController.retrieveDepartment(req200, res200);
     EXPECT_EQ(res200.code, 200);
     EXPECT_EQ(res200.body, expected);
+    EXPECT_EQ(res200.headers.count("ETag"), 0);
 
     crow::request req404{};
     crow::response res404{};
@@ -297,6 +298,157 @@ TEST(RouteControllerUnitTests, FindCourseTimeMockTest) {
     EXPECT_EQ(res400.body, "URL parameters must include courseCode");
 }
 
+TEST(RouteControllerUnitTests, RetrieveCoursesByIndexMockTest) {
+    RouteController routeController;
+    SetUpDatabase(&routeController);
+
+    crow::request req200{};
+    crow::response res200{};
+    req200.url_params = crow::query_string{"?instructor=Gail%20Kaiser"};
+    routeController.retrieveCoursesByInstructor(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "COMS 4156\n");
+
+    res200.body = "";
+    req200.url_params = crow::query_string{"?location=501%20NWC"};
+    routeController.retrieveCoursesByLocation(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "COMS 4156\nIEOR 4106\n");
+
+    res200.body = "";
+    req200.url_params = crow::query_string{"?timeSlot=8:40-9:55"};
+    routeController.retrieveCoursesByTimeSlot(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "CHEM 4071\nECON 4710\n");
+
+    res200.body = "";
+    req200.url_params = crow::query_string{"?location=Nowhere"};
+    routeController.retrieveCoursesByLocation(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "");
+
+    crow::request req400{};
+    crow::response res400{};
+    req400.url_params = crow::query_string{"?x=10"};
+    routeController.retrieveCoursesByInstructor(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "URL parameters must include instructor");
+
+    res400.body = "";
+    routeController.retrieveCoursesByLocation(req400, res400);
+    EXPECT_EQ(res400.body, "URL parameters must include location");
+
+    res400.body = "";
+    routeController.retrieveCoursesByTimeSlot(req400, res400);
+    EXPECT_EQ(res400.body, "URL parameters must include timeSlot");
+}
+
+TEST(RouteControllerUnitTests, SearchMockTest) {
+    RouteController routeController;
+    SetUpDatabase(&routeController);
+
+    crow::request req200{};
+    crow::response res200{};
+    req200.url_params = crow::query_string{"?q=Kais"};
+    routeController.search(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body,
+              "COMS 4156 (instructor: Gail Kaiser)\nIEOR 4106 (instructor: Kaizheng Wang)\n");
+
+    res200.body = "";
+    req200.url_params = crow::query_string{"?q=Dolen"};
+    routeController.search(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "IEOR 3404 (instructor: Christopher J Dolan)\n");
+
+    res200.body = "";
+    req200.url_params = crow::query_string{"?q=coms%204156&k=1"};
+    routeController.search(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "COMS 4156 (course: COMS 4156)\n");
+
+    crow::request req400{};
+    crow::response res400{};
+    req400.url_params = crow::query_string{"?x=10"};
+    routeController.search(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "URL parameters must include q");
+
+    res400.body = "";
+    req400.url_params = crow::query_string{"?q=Kais&k=0"};
+    routeController.search(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "k must be a number from 1 to 100");
+
+    res400.body = "";
+    req400.url_params = crow::query_string{"?q=Kais&k=ten"};
+    routeController.search(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+}
+
+TEST(RouteControllerUnitTests, RetrieveCoursesMeetingDuringMockTest) {
+    RouteController routeController;
+    SetUpDatabase(&routeController);
+
+    crow::request req200{};
+    crow::response res200{};
+    req200.url_params = crow::query_string{"?timeSlot=8:00-9:00"};
+    routeController.retrieveCoursesMeetingDuring(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "CHEM 4071\nECON 4710\n");
+
+    res200.body = "";
+    req200.url_params = crow::query_string{"?timeSlot=6:00-6:10"};
+    routeController.retrieveCoursesMeetingDuring(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "");
+
+    crow::request req400{};
+    crow::response res400{};
+    req400.url_params = crow::query_string{"?x=10"};
+    routeController.retrieveCoursesMeetingDuring(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "URL parameters must include timeSlot");
+
+    res400.body = "";
+    req400.url_params = crow::query_string{"?timeSlot=noon"};
+    routeController.retrieveCoursesMeetingDuring(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "timeSlot must be a time range such as 10:10-11:25");
+}
+
+TEST(RouteControllerUnitTests, RetrieveOverlappingCoursesMockTest) {
+    RouteController routeController;
+    SetUpDatabase(&routeController);
+
+    crow::request req200{};
+    crow::response res200{};
+    req200.url_params = crow::query_string{"?deptCode=ECON&courseCode=4710"};
+    routeController.retrieveOverlappingCourses(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "CHEM 4071\nIEOR 4511\n");
+
+    crow::request req404{};
+    crow::response res404{};
+    req404.url_params = crow::query_string{"?deptCode=NONEXISTENT&courseCode=4710"};
+    routeController.retrieveOverlappingCourses(req404, res404);
+    EXPECT_EQ(res404.code, 404);
+    EXPECT_EQ(res404.body, "Department Not Found");
+
+    res404.body = "";
+    req404.url_params = crow::query_string{"?deptCode=ECON&courseCode=9999"};
+    routeController.retrieveOverlappingCourses(req404, res404);
+    EXPECT_EQ(res404.code, 404);
+    EXPECT_EQ(res404.body, "Course Not Found");
+
+    crow::request req400{};
+    crow::response res400{};
+    req400.url_params = crow::query_string{"?deptCode=ECON"};
+    routeController.retrieveOverlappingCourses(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "URL parameters must include courseCode");
+}
+
 TEST(RouteControllerUnitTests, AddMajorToDeptMockTest) {
     RouteController routeController;
     SetUpDatabase(&routeController);
@@ -530,6 +682,61 @@ TEST(RouteControllerUnitTests, SetCourseTimeMockTest) {
     EXPECT_EQ(res400.body, "URL parameters must include deptCode");
 }
 
+TEST(RouteControllerUnitTests, EnrollStudentInCourseMockTest) {
+    RouteController routeController;
+    SetUpDatabase(&routeController);
+
+    // CHEM 1500 starts with more students than seats.
+    crow::request req400{};
+    crow::response res400{};
+    req400.url_params = crow::query_string{"?deptCode=CHEM&courseCode=1500"};
+    routeController.enrollStudentInCourse(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "Course is full");
+
+    crow::request req{};
+    crow::response res{};
+    req.url_params = crow::query_string{"?deptCode=CHEM&courseCode=1500&count=45"};
+    routeController.setEnrollmentCount(req, res);
+
+    crow::request req200{};
+    crow::response res200{};
+    req200.url_params = crow::query_string{"?deptCode=CHEM&courseCode=1500"};
+    routeController.enrollStudentInCourse(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+    EXPECT_EQ(res200.body, "Student has been enrolled");
+
+    res400.body = "";
+    routeController.enrollStudentInCourse(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "Course is full");
+
+    crow::request req404{};
+    crow::response res404{};
+    req404.url_params = crow::query_string{"?deptCode=NONEXISTENT&courseCode=3203"};
+    routeController.enrollStudentInCourse(req404, res404);
+    EXPECT_EQ(res404.code, 404);
+    EXPECT_EQ(res404.body, "Department Not Found");
+
+    res404.body = "";
+    req404.url_params = crow::query_string{"?deptCode=COMS&courseCode=9999"};
+    routeController.enrollStudentInCourse(req404, res404);
+    EXPECT_EQ(res404.code, 404);
+    EXPECT_EQ(res404.body, "Course Not Found");
+
+    res400.body = "";
+    req400.url_params = crow::query_string{"?deptCode=COMS"};
+    routeController.enrollStudentInCourse(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "URL parameters must include courseCode");
+
+    res400.body = "";
+    req400.url_params = crow::query_string{"?x=10"};
+    routeController.enrollStudentInCourse(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "URL parameters must include deptCode");
+}
+
 TEST(RouteControllerUnitTests, DropStudentFromCourseMockTest) {
     RouteController routeController;
     SetUpDatabase(&routeController);
@@ -579,3 +786,145 @@ TEST(RouteControllerUnitTests, DropStudentFromCourseMockTest) {
     EXPECT_EQ(res400.code, 400);
     EXPECT_EQ(res400.body, "URL parameters must include deptCode");
 }
+
+TEST(RouteControllerUnitTests, DurabilityMockTest) {
+    RouteController routeController;
+    SetUpDatabase(&routeController);
+
+    crow::request reqAsync{};
+    crow::response resAsync{};
+    reqAsync.url_params =
+        crow::query_string{"?deptCode=COMS&courseCode=3203&count=42&durability=async"};
+    routeController.setEnrollmentCount(reqAsync, resAsync);
+    EXPECT_EQ(resAsync.code, 200);
+    EXPECT_EQ(resAsync.body, "Attribute was updated successfully.");
+
+    crow::request reqNone{};
+    crow::response resNone{};
+    reqNone.url_params = crow::query_string{"?deptCode=COMS&durability=none"};
+    routeController.addMajorToDept(reqNone, resNone);
+    EXPECT_EQ(resNone.code, 200);
+    EXPECT_EQ(resNone.body, "Attribute was updated successfully");
+
+    crow::request req400{};
+    crow::response res400{};
+    req400.url_params = crow::query_string{"?deptCode=COMS&durability=fast"};
+    routeController.removeMajorFromDept(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+    EXPECT_EQ(res400.body, "durability must be one of sync, async or none");
+
+    crow::response resStats{};
+    routeController.retrieveStats(resStats);
+    EXPECT_EQ(resStats.code, 200);
+    EXPECT_NE(resStats.body.find("walBatches: "), std::string::npos);
+    EXPECT_NE(resStats.body.find("walAverageCommitLatencyMicros: "), std::string::npos);
+    EXPECT_NE(resStats.body.find("checkpointLastBytes: "), std::string::npos);
+}
+
+TEST(RouteControllerUnitTests, VersionMockTest) {
+    RouteController routeController;
+    SetUpDatabase(&routeController);
+
+    crow::request reqGet{};
+    crow::response resGet{};
+    reqGet.url_params = crow::query_string{"?deptCode=COMS&courseCode=3203"};
+    routeController.retrieveCourse(reqGet, resGet);
+    EXPECT_EQ(resGet.code, 200);
+    ASSERT_EQ(resGet.headers.count("ETag"), 1);
+    std::string etag = resGet.headers.find("ETag")->second;
+    EXPECT_EQ(etag.front(), '"');
+
+    crow::request req200{};
+    crow::response res200{};
+    req200.url_params = crow::query_string{"?deptCode=COMS&courseCode=3203&location=417%20IAB"};
+    req200.headers.emplace("If-Match", etag);
+    routeController.setCourseLocation(req200, res200);
+    EXPECT_EQ(res200.code, 200);
+
+    // The course has moved on from the version in the ETag.
+    crow::request req409{};
+    crow::response res409{};
+    req409.url_params = crow::query_string{"?deptCode=COMS&courseCode=3203&count=42"};
+    req409.headers.emplace("If-Match", etag);
+    routeController.setEnrollmentCount(req409, res409);
+    EXPECT_EQ(res409.code, 409);
+    EXPECT_EQ(res409.body, "Version Mismatch");
+
+    crow::request reqAny{};
+    crow::response resAny{};
+    reqAny.url_params = crow::query_string{"?deptCode=COMS&courseCode=3203&count=42"};
+    reqAny.headers.emplace("If-Match", "*");
+    routeController.setEnrollmentCount(reqAny, resAny);
+    EXPECT_EQ(resAny.code, 200);
+
+    // A seat change moves the count in the ETag on, though not the version.
+    crow::response resSeats{};
+    routeController.retrieveCourse(reqGet, resSeats);
+    crow::request reqDrop{};
+    crow::response resDrop{};
+    reqDrop.url_params = crow::query_string{"?deptCode=COMS&courseCode=3203"};
+    routeController.dropStudentFromCourse(reqDrop, resDrop);
+    EXPECT_EQ(resDrop.code, 200);
+    crow::request reqSeats{};
+    crow::response resSeatsStale{};
+    reqSeats.url_params = crow::query_string{"?deptCode=COMS&courseCode=3203&count=42"};
+    reqSeats.headers.emplace("If-Match", resSeats.headers.find("ETag")->second);
+    routeController.setEnrollmentCount(reqSeats, resSeatsStale);
+    EXPECT_EQ(resSeatsStale.code, 409);
+
+    crow::request req400{};
+    crow::response res400{};
+    req400.url_params = crow::query_string{"?deptCode=COMS"};
+    req400.headers.emplace("If-Match", "\"abc\"");
+    routeController.addMajorToDept(req400, res400);
+    EXPECT_EQ(res400.code, 400);
+
+    crow::request reqDept{};
+    crow::response resDept{};
+    reqDept.url_params = crow::query_string{"?deptCode=COMS"};
+    routeController.getMajorCountFromDept(reqDept, resDept);
+    ASSERT_EQ(resDept.headers.count("ETag"), 1);
+    crow::request reqMajor{};
+    crow::response resMajor{};
+    reqMajor.url_params = crow::query_string{"?deptCode=COMS"};
+    reqMajor.headers.emplace("If-Match", resDept.headers.find("ETag")->second);
+    routeController.removeMajorFromDept(reqMajor, resMajor);
+    EXPECT_EQ(resMajor.code, 200);
+    crow::response resStale{};
+    routeController.removeMajorFromDept(reqMajor, resStale);
+    EXPECT_EQ(resStale.code, 409);
+
+    // A department's ETag matches none of its courses.
+    crow::response resDeptNow{};
+    routeController.getMajorCountFromDept(reqDept, resDeptNow);
+    crow::request reqCourse{};
+    crow::response resCourse{};
+    reqCourse.url_params = crow::query_string{"?deptCode=COMS&courseCode=3203&count=42"};
+    reqCourse.headers.emplace("If-Match", resDeptNow.headers.find("ETag")->second);
+    routeController.setEnrollmentCount(reqCourse, resCourse);
+    EXPECT_EQ(resCourse.code, 409);
+
+    // An ETag read before the database is saved and loaded again, as on a restart, is stale, even
+    // for a course that is back at the same version and count.
+    crow::request reqUnchanged{};
+    reqUnchanged.url_params = crow::query_string{"?deptCode=COMS&courseCode=1004"};
+    crow::response resBefore{};
+    routeController.retrieveCourse(reqUnchanged, resBefore);
+    MyApp::getDatabase()->saveContentsToFile();
+    MyApp::getDatabase()->deSerializeObjectFromFile();
+    crow::request reqReload{};
+    crow::response resReload{};
+    reqReload.url_params = crow::query_string{"?deptCode=COMS&courseCode=1004&location=417%20IAB"};
+    reqReload.headers.emplace("If-Match", resBefore.headers.find("ETag")->second);
+    routeController.setCourseLocation(reqReload, resReload);
+    EXPECT_EQ(resReload.code, 409);
+    crow::response resAfter{};
+    routeController.retrieveCourse(reqUnchanged, resAfter);
+    EXPECT_NE(resAfter.headers.find("ETag")->second, resBefore.headers.find("ETag")->second);
+    crow::request reqFresh{};
+    crow::response resFresh{};
+    reqFresh.url_params = reqReload.url_params;
+    reqFresh.headers.emplace("If-Match", resAfter.headers.find("ETag")->second);
+    routeController.setCourseLocation(reqFresh, resFresh);
+    EXPECT_EQ(resFresh.code, 200);
+}
@@ -0,0 +1,107 @@
+// Copyright 2024 Jason Han
+#include "SearchIndex.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> Texts(const std::vector<SearchMatch>& matches) {
+    std::vector<std::string> texts;
+    for (const SearchMatch& match : matches) {
+        texts.push_back(match.text);
+    }
+    return texts;
+}
+
+SearchIndex& MakeIndex(SearchIndex& index) {
+    index.addCourse(0, "COMS 4156");
+    index.addCourse(1, "COMS 4115");
+    index.addCourse(2, "IEOR 3404");
+    index.addName(SearchField::Instructor, InternedString::intern("Gail Kaiser"));
+    index.addName(SearchField::Instructor, InternedString::intern("Kaizheng Wang"));
+    index.addName(SearchField::Instructor, InternedString::intern("Christopher J Dolan"));
+    index.addName(SearchField::Location, InternedString::intern("501 NWC"));
+    index.addName(SearchField::Location, InternedString::intern("417 IAB"));
+    return index;
+}
+
+}  // namespace
+
+TEST(SearchIndexUnitTests, NormalizeTest) {
+    EXPECT_EQ(SearchIndex::normalize("Gail  Kaiser"), "gail kaiser");
+    EXPECT_EQ(SearchIndex::normalize("  Frank E. L. Banta "), "frank e l banta");
+    EXPECT_EQ(SearchIndex::normalize("COMS-4156"), "coms 4156");
+    EXPECT_EQ(SearchIndex::normalize("..."), "");
+}
+
+TEST(SearchIndexUnitTests, PrefixTest) {
+    SearchIndex index;
+    MakeIndex(index);
+    EXPECT_EQ(index.size(), 8);
+
+    // Any word of a term can start the match.
+    std::vector<SearchMatch> matches = index.search("Kais", 10);
+    ASSERT_FALSE(matches.empty());
+    EXPECT_EQ(matches[0].text, "Gail Kaiser");
+    EXPECT_EQ(matches[0].field, SearchField::Instructor);
+    EXPECT_EQ(matches[0].name, InternedString::intern("Gail Kaiser"));
+    EXPECT_GT(matches[0].score, 0.5);
+
+    EXPECT_EQ(Texts(index.search("coms 41", 10)),
+              (std::vector<std::string>{"COMS 4115", "COMS 4156"}));
+    EXPECT_EQ(index.search("4156", 10)[0].course, 0);
+    EXPECT_EQ(Texts(index.search("nwc", 10)), std::vector<std::string>{"501 NWC"});
+
+    // The whole term ranks first.
+    matches = index.search("gail kaiser", 10);
+    EXPECT_EQ(matches[0].text, "Gail Kaiser");
+    EXPECT_EQ(matches[0].score, 1.0);
+
+    EXPECT_TRUE(index.search("zz", 10).empty());
+    EXPECT_TRUE(index.search("", 10).empty());
+    EXPECT_EQ(index.search("coms", 1).size(), 1);
+}
+
+TEST(SearchIndexUnitTests, FuzzyTest) {
+    SearchIndex index;
+    MakeIndex(index);
+
+    std::vector<SearchMatch> matches = index.search("Dolen", 10);
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches[0].text, "Christopher J Dolan");
+    EXPECT_LE(matches[0].score, 0.5);
+
+    // Prefix matches rank above fuzzy ones.
+    EXPECT_EQ(Texts(index.search("kais", 10)),
+              (std::vector<std::string>{"Gail Kaiser", "Kaizheng Wang"}));
+    EXPECT_TRUE(index.search("xyzzy", 10).empty());
+}
+
+TEST(SearchIndexUnitTests, AddTest) {
+    SearchIndex index;
+    MakeIndex(index);
+
+    // Names are added once.
+    index.addName(SearchField::Instructor, InternedString::intern("Gail Kaiser"));
+    EXPECT_EQ(index.size(), 8);
+    // The same string can name both an instructor and a location.
+    index.addName(SearchField::Location, InternedString::intern("Gail Kaiser"));
+    EXPECT_EQ(index.size(), 9);
+
+    index.addName(SearchField::Instructor, InternedString::intern("Adam Cannon"));
+    EXPECT_EQ(Texts(index.search("cann", 10)), std::vector<std::string>{"Adam Cannon"});
+}
+
+TEST(SearchIndexUnitTests, TopTermsTest) {
+    // Each trie node keeps only the shortest terms below it, which are the best prefix matches.
+    SearchIndex index;
+    for (int i = 0; i < 100; ++i) {
+        index.addCourse(i, "COMS " + std::to_string(1000 + i * 37));
+    }
+    index.addCourse(100, "COMS 1");
+    std::vector<SearchMatch> matches = index.search("coms", 5);
+    ASSERT_EQ(matches.size(), 5);
+    EXPECT_EQ(matches[0].text, "COMS 1");
+    EXPECT_EQ(index.search("coms 4478", 5)[0].score, 1.0);
+}
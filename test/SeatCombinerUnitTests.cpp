@@ -0,0 +1,65 @@
+// Copyright 2024 Jason Han
+#include "SeatCombiner.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(SeatCombinerUnitTests, ApplyTest) {
+    SeatCombiner combiner;
+    Course coms4156{1, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    EXPECT_EQ(combiner.apply(coms4156, 1), SeatChange::Applied);
+    EXPECT_EQ(combiner.apply(coms4156, 1), SeatChange::Rejected);
+    EXPECT_EQ(combiner.apply(coms4156, -1), SeatChange::Applied);
+    EXPECT_EQ(combiner.apply(coms4156, -1), SeatChange::Rejected);
+    coms4156.retireSeats();
+    EXPECT_EQ(combiner.apply(coms4156, 1), SeatChange::Stale);
+}
+
+TEST(SeatCombinerUnitTests, ConcurrentApplyTest) {
+    // More threads than slots race on one hot course and a few cold ones: every course takes
+    // exactly its capacity, and every seat given back is one that was taken.
+    constexpr int kThreads = SeatCombiner::kSlotCount + 16;
+    constexpr int kAttempts = 200;
+    SeatCombiner combiner;
+    Course hot{kThreads * kAttempts / 4, "Gail Kaiser", "501 NWC", "10:10-11:25"};
+    std::vector<Course> cold(4, Course{kThreads * kAttempts / 16, "Adam Cannon", "417 IAB", ""});
+    std::atomic<int> hotEnrolled{0};
+    std::atomic<int> coldEnrolled{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < kAttempts; ++i) {
+                if (combiner.apply(hot, 1) == SeatChange::Applied) {
+                    hotEnrolled++;
+                }
+                if (combiner.apply(cold[(t + i) % 4], 1) == SeatChange::Applied) {
+                    coldEnrolled++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(hotEnrolled, hot.getEnrollmentCapacity());
+    EXPECT_EQ(hot.getEnrolledStudentCount(), hot.getEnrollmentCapacity());
+    EXPECT_EQ(coldEnrolled, 4 * cold[0].getEnrollmentCapacity());
+
+    std::atomic<int> dropped{0};
+    threads.clear();
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < kAttempts / 2; ++i) {
+                if (combiner.apply(hot, -1) == SeatChange::Applied) {
+                    dropped++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(dropped, hot.getEnrollmentCapacity());
+    EXPECT_EQ(hot.getEnrolledStudentCount(), 0);
+}
@@ -0,0 +1,45 @@
+// Copyright 2024 Jason Han
+#include "StripedMutex.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(StripedMutexUnitTests, StripeForTest) {
+    StripedMutex stripes;
+    EXPECT_EQ(&stripes.stripeFor("COMS"), &stripes.stripeFor(std::string("COMS")));
+
+    // Keys spread over the stripes.
+    std::vector<std::mutex*> used;
+    for (int i = 0; i < 1000; ++i) {
+        std::mutex* stripe = &stripes.stripeFor("D" + std::to_string(i));
+        if (std::find(used.begin(), used.end(), stripe) == used.end()) {
+            used.push_back(stripe);
+        }
+    }
+    EXPECT_EQ(used.size(), StripedMutex::kStripeCount);
+}
+
+TEST(StripedMutexUnitTests, LockAllTest) {
+    StripedMutex stripes;
+    int counter = 0;
+    {
+        std::lock_guard<StripedMutex> all(stripes);
+        // A holder of one key waits until every stripe is released.
+        std::thread writer([&]() {
+            std::lock_guard<std::mutex> lock(stripes.stripeFor("COMS"));
+            counter++;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_EQ(counter, 0);
+        stripes.unlock();
+        writer.join();
+        stripes.lock();
+    }
+    EXPECT_EQ(counter, 1);
+    EXPECT_TRUE(stripes.stripeFor("COMS").try_lock());
+    stripes.stripeFor("COMS").unlock();
+}
@@ -0,0 +1,33 @@
+// Copyright 2024 Jason Han
+#ifndef TESTCATALOG_H
+#define TESTCATALOG_H
+
+#include "Department.h"
+#include <map>
+#include <memory>
+#include <string>
+
+// A small catalog shared by the snapshot and column tests: a department with a full course and
+// courses sharing a location and a time slot, one with an over-enrolled course and one with no
+// courses at all.
+inline std::map<std::string, Department> MakeMapping() {
+    std::map<std::string, std::shared_ptr<Course>> coms;
+    coms["1004"] = std::make_shared<Course>(400, "Adam Cannon", "417 IAB", "11:40-12:55");
+    coms["1004"]->setEnrolledStudentCount(249);
+    coms["3157"] = std::make_shared<Course>(400, "Jae Lee", "417 IAB", "4:10-5:25");
+    coms["3157"]->setEnrolledStudentCount(400);
+    coms["4156"] = std::make_shared<Course>(120, "Gail Kaiser", "501 NWC", "10:10-11:25");
+    coms["4156"]->setEnrolledStudentCount(109);
+
+    std::map<std::string, std::shared_ptr<Course>> ieor;
+    ieor["2500"] = std::make_shared<Course>(50, "Uday Menon", "417 IAB", "11:40-12:55");
+    ieor["2500"]->setEnrolledStudentCount(52);
+
+    std::map<std::string, Department> mapping;
+    mapping["COMS"] = Department("COMS", coms, "Luca Carloni", 2700);
+    mapping["IEOR"] = Department("IEOR", ieor, "Jay Sethuraman", 67);
+    mapping["PHYS"] = Department("PHYS", {}, "Marcia L. Newson", 200);
+    return mapping;
+}
+
+#endif
@@ -0,0 +1,79 @@
+// Copyright 2024 Jason Han
+#include "TimeIndex.h"
+#include "TimeRange.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <utility>
+#include <vector>
+
+TEST(TimeIndexUnitTests, ParseTest) {
+    EXPECT_EQ(TimeRange::parse("11:40-12:55"), (TimeRange{11 * 60 + 40, 12 * 60 + 55}));
+    EXPECT_EQ(TimeRange::parse("8:40-9:55"), (TimeRange{8 * 60 + 40, 9 * 60 + 55}));
+    EXPECT_EQ(TimeRange::parse("9:00-11:30"), (TimeRange{9 * 60, 11 * 60 + 30}));
+    EXPECT_EQ(TimeRange::parse("1:10-5:00"), (TimeRange{13 * 60 + 10, 17 * 60}));
+    EXPECT_EQ(TimeRange::parse("6:10-9:50"), (TimeRange{18 * 60 + 10, 21 * 60 + 50}));
+    EXPECT_EQ(TimeRange::parse("7:10-9:40"), (TimeRange{19 * 60 + 10, 21 * 60 + 40}));
+    EXPECT_EQ(TimeRange::parse("11:00-1:00"), (TimeRange{11 * 60, 13 * 60}));
+    EXPECT_EQ(TimeRange::parse("18:00-20:30"), (TimeRange{18 * 60, 20 * 60 + 30}));
+    EXPECT_EQ(TimeRange::parse("6:10-9:50")->display(), "18:10-21:50");
+
+    EXPECT_EQ(TimeRange::parse(""), std::nullopt);
+    EXPECT_EQ(TimeRange::parse("TBA"), std::nullopt);
+    EXPECT_EQ(TimeRange::parse("10:10"), std::nullopt);
+    EXPECT_EQ(TimeRange::parse("10:10-"), std::nullopt);
+    EXPECT_EQ(TimeRange::parse("10:1-11:25"), std::nullopt);
+    EXPECT_EQ(TimeRange::parse("10:60-11:25"), std::nullopt);
+    EXPECT_EQ(TimeRange::parse("24:00-1:00"), std::nullopt);
+    EXPECT_EQ(TimeRange::parse("10:10 - 11:25"), std::nullopt);
+    EXPECT_EQ(TimeRange::parse("20:00-19:00"), std::nullopt);
+}
+
+TEST(TimeIndexUnitTests, OverlapTest) {
+    TimeRange morning = *TimeRange::parse("10:10-11:25");
+    EXPECT_TRUE(morning.overlaps(*TimeRange::parse("11:00-12:00")));
+    EXPECT_TRUE(morning.overlaps(*TimeRange::parse("10:30-10:40")));
+    // Ranges are half-open, so back-to-back courses don't overlap.
+    EXPECT_FALSE(morning.overlaps(*TimeRange::parse("11:25-12:40")));
+    EXPECT_FALSE(morning.overlaps(*TimeRange::parse("8:40-10:10")));
+}
+
+TEST(TimeIndexUnitTests, FindOverlappingTest) {
+    EXPECT_TRUE(TimeIndex({}).findOverlapping({0, 24 * 60}).empty());
+
+    TimeIndex index({{*TimeRange::parse("11:40-12:55"), 0},
+                     {*TimeRange::parse("4:10-5:25"), 1},
+                     {*TimeRange::parse("10:10-11:25"), 2},
+                     {*TimeRange::parse("9:00-11:30"), 3}});
+    EXPECT_EQ(index.size(), 4);
+    EXPECT_EQ(index.findOverlapping(*TimeRange::parse("11:00-12:00")),
+              (std::vector<uint32_t>{0, 2, 3}));
+    EXPECT_EQ(index.findOverlapping(*TimeRange::parse("8:00-9:00")), std::vector<uint32_t>{});
+    EXPECT_EQ(index.findOverlapping(*TimeRange::parse("5:00-6:00")), std::vector<uint32_t>{1});
+}
+
+TEST(TimeIndexUnitTests, MatchesScanTest) {
+    std::mt19937 random(4156);
+    std::uniform_int_distribution<int> minute(0, 24 * 60 - 1);
+    auto randomRange = [&]() {
+        int start = minute(random);
+        int end = start + 1 + minute(random) % 180;
+        end = end > 24 * 60 ? 24 * 60 : end;
+        return TimeRange{static_cast<uint16_t>(start), static_cast<uint16_t>(end)};
+    };
+
+    std::vector<std::pair<TimeRange, uint32_t>> courses;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        courses.emplace_back(randomRange(), i);
+    }
+    TimeIndex index(courses);
+    for (int query = 0; query < 200; ++query) {
+        TimeRange range = randomRange();
+        std::vector<uint32_t> expected;
+        for (const auto& course : courses) {
+            if (course.first.overlaps(range)) {
+                expected.push_back(course.second);
+            }
+        }
+        EXPECT_EQ(index.findOverlapping(range), expected);
+    }
+}
@@ -0,0 +1,208 @@
+// Copyright 2024 Jason Han
+#include "WriteAheadLog.h"
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+TEST(WriteAheadLogUnitTests, AppendRecoverTest) {
+    std::remove("wal_test.wal");
+    WalRecord location{WalRecordType::SetCourseLocation, "COMS", "4156", 0, "417 IAB"};
+    WalRecord majors{WalRecordType::SetNumberOfMajors, "COMS", "", 2701, ""};
+    {
+        WriteAheadLog wal{"wal_test.wal"};
+        wal.append(location);
+        wal.append(majors);
+    }
+
+    WriteAheadLog wal{"wal_test.wal"};
+    auto records = wal.recover();
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0], location);
+    EXPECT_EQ(records[1], majors);
+}
+
+TEST(WriteAheadLogUnitTests, TornTailTest) {
+    std::remove("wal_test.wal");
+    WalRecord count{WalRecordType::SetEnrollmentCount, "IEOR", "2500", 42, ""};
+    {
+        WriteAheadLog wal{"wal_test.wal"};
+        wal.append(count);
+    }
+    auto validSize = std::filesystem::file_size("wal_test.wal");
+
+    // Simulate a crash halfway through appending a second record.
+    std::string frame = WriteAheadLog::encode(count);
+    std::ofstream out("wal_test.wal", std::ios::binary | std::ios::app);
+    out.write(frame.data(), frame.length() / 2);
+    out.close();
+
+    WriteAheadLog wal{"wal_test.wal"};
+    auto records = wal.recover();
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0], count);
+    EXPECT_EQ(std::filesystem::file_size("wal_test.wal"), validSize);
+}
+
+TEST(WriteAheadLogUnitTests, CorruptRecordTest) {
+    std::remove("wal_test.wal");
+    WalRecord first{WalRecordType::SetCourseLocation, "COMS", "4156", 0, "417 IAB"};
+    WalRecord second{WalRecordType::SetCourseLocation, "COMS", "4156", 0, "501 NWC"};
+    {
+        WriteAheadLog wal{"wal_test.wal"};
+        wal.append(first);
+        wal.append(second);
+    }
+    auto validSize =
+        std::filesystem::file_size("wal_test.wal") - WriteAheadLog::encode(second).length();
+
+    // Damage the last byte of the second record's string value; its length still lines up.
+    std::fstream file("wal_test.wal", std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(-1, std::ios::end);
+    file.put('X');
+    file.close();
+
+    WriteAheadLog wal{"wal_test.wal"};
+    EXPECT_EQ(wal.recover(), std::vector<WalRecord>{first});
+    EXPECT_EQ(std::filesystem::file_size("wal_test.wal"), validSize);
+}
+
+TEST(WriteAheadLogUnitTests, TruncateTest) {
+    std::remove("wal_test.wal");
+    WriteAheadLog wal{"wal_test.wal"};
+    wal.append({WalRecordType::SetCourseTime, "CHEM", "1500", 0, "10:10-11:25"});
+    wal.truncate();
+    EXPECT_TRUE(wal.recover().empty());
+}
+
+TEST(WriteAheadLogUnitTests, RotateTest) {
+    std::remove("wal_test.wal");
+    std::remove("wal_test.wal.old");
+    WalRecord first{WalRecordType::SetEnrollmentCount, "COMS", "1004", 1, ""};
+    WalRecord second{WalRecordType::SetEnrollmentCount, "COMS", "1004", 2, ""};
+    WalRecord third{WalRecordType::SetEnrollmentCount, "COMS", "1004", 3, ""};
+    {
+        WriteAheadLog wal{"wal_test.wal"};
+        wal.append(first);
+        wal.rotate();
+        wal.append(second);
+        // A second rotation before the first segment is discarded keeps both segments' records.
+        wal.rotate();
+        wal.append(third);
+    }
+
+    WriteAheadLog wal{"wal_test.wal"};
+    EXPECT_EQ(wal.recover(), (std::vector<WalRecord>{first, second, third}));
+    wal.discardRotated();
+    EXPECT_EQ(wal.recover(), std::vector<WalRecord>{third});
+}
+
+TEST(WriteAheadLogUnitTests, GroupCommitTest) {
+    std::remove("wal_test.wal");
+    std::vector<WalRecord> records;
+    {
+        WriteAheadLog wal{"wal_test.wal"};
+        wal.setGroupCommitWindow(std::chrono::milliseconds(20));
+
+        // Everything queued within one window is committed with a single fsync.
+        std::vector<uint64_t> lsns;
+        for (int i = 0; i < 10; i++) {
+            records.push_back({WalRecordType::SetEnrollmentCount, "COMS", "4156", i, ""});
+            lsns.push_back(wal.enqueue(records.back()));
+        }
+        wal.waitForDurable(lsns.back());
+
+        WalStats stats = wal.getStats();
+        EXPECT_EQ(stats.batches, 1);
+        EXPECT_EQ(stats.records, 10);
+        EXPECT_EQ(stats.maxBatchSize, 10);
+        EXPECT_GE(stats.lastCommitLatencyMicros, 20000);
+    }
+
+    WriteAheadLog wal{"wal_test.wal"};
+    EXPECT_EQ(wal.recover(), records);
+}
+
+TEST(WriteAheadLogUnitTests, FailedCommitTest) {
+    std::remove("wal_test.wal");
+    WalRecord first{WalRecordType::SetEnrollmentCount, "COMS", "4156", 1, ""};
+    WalRecord second{WalRecordType::SetEnrollmentCount, "COMS", "4156", 2, ""};
+    WalRecord third{WalRecordType::SetEnrollmentCount, "COMS", "4156", 3, ""};
+    WalRecord fourth{WalRecordType::SetEnrollmentCount, "COMS", "4156", 4, ""};
+    {
+        WriteAheadLog wal{"wal_test.wal"};
+        wal.append(first);
+        auto committedSize = std::filesystem::file_size("wal_test.wal");
+
+        // Cap the file size a few bytes past the first record, so the next batch is written
+        // partway before its write fails.
+        rlimit original;
+        ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &original), 0);
+        rlimit capped = original;
+        capped.rlim_cur = committedSize + 5;
+        auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+        ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &capped), 0);
+
+        uint64_t secondLsn = wal.enqueue(second);
+        EXPECT_THROW(wal.waitForDurable(secondLsn), std::runtime_error);
+        EXPECT_THROW(wal.waitForDurable(secondLsn), std::runtime_error);
+        uint64_t thirdLsn = wal.enqueue(third);
+
+        ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &original), 0);
+        std::signal(SIGXFSZ, previousHandler);
+
+        // Both records are retried; a retry that was already failing when the cap was lifted
+        // may report its failure before the next one commits.
+        bool durable = false;
+        for (int attempt = 0; attempt < 100 && !durable; attempt++) {
+            try {
+                wal.waitForDurable(thirdLsn);
+                durable = true;
+            } catch (const std::runtime_error&) {
+            }
+        }
+        ASSERT_TRUE(durable);
+        wal.waitForDurable(secondLsn);
+
+        // The failure doesn't stick to later records.
+        wal.append(fourth);
+    }
+
+    WriteAheadLog wal{"wal_test.wal"};
+    EXPECT_EQ(wal.recover(), (std::vector<WalRecord>{first, second, third, fourth}));
+}
+
+TEST(WriteAheadLogUnitTests, ConcurrentAppendTest) {
+    std::remove("wal_test.wal");
+    {
+        WriteAheadLog wal{"wal_test.wal"};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; t++) {
+            threads.emplace_back([&wal, t] {
+                for (int i = 0; i < 25; i++) {
+                    wal.append({WalRecordType::SetNumberOfMajors, "COMS", "", t * 100 + i, ""});
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(wal.getStats().records, 200);
+        EXPECT_LT(wal.getStats().batches, 200);
+    }
+
+    WriteAheadLog wal{"wal_test.wal"};
+    EXPECT_EQ(wal.recover().size(), 200);
+}
+
+TEST(WriteAheadLogUnitTests, ParseDurabilityTest) {
+    EXPECT_EQ(WriteAheadLog::parseDurability("sync"), Durability::Sync);
+    EXPECT_EQ(WriteAheadLog::parseDurability("async"), Durability::Async);
+    EXPECT_EQ(WriteAheadLog::parseDurability("none"), Durability::None);
+    EXPECT_EQ(WriteAheadLog::parseDurability("fast"), std::nullopt);
+}